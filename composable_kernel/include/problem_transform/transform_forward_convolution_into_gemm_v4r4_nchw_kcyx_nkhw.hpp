@@ -82,12 +82,15 @@ __host__ __device__ constexpr auto transform_forward_convolution_into_gemm_v4r4_
         make_tuple(Sequence<0>{}, Sequence<1>{}, Sequence<2>{}, Sequence<3>{}),
         make_tuple(Sequence<0>{}, Sequence<1>{}, Sequence<2, 3>{}, Sequence<4, 5>{}));
 
-    const auto in_gemmk_gemmn_global_desc =
-        transform_tensor_descriptor(in_n_c_y_ho_x_wo_global_desc,
-                                    make_tuple(make_merge_transform(make_tuple(C, Y, X)),
-                                               make_merge_transform(make_tuple(N, Ho, Wo))),
-                                    make_tuple(Sequence<1, 2, 4>{}, Sequence<0, 3, 5>{}),
-                                    make_tuple(Sequence<0>{}, Sequence<1>{}));
+    // GemmK is moved by the slice windows, by steps known at compile time, and the GemmN index is
+    // calculated from the block and thread id
+    const auto in_gemmk_gemmn_global_desc = transform_tensor_descriptor(
+        in_n_c_y_ho_x_wo_global_desc,
+        make_tuple(
+            make_merge_transform_auto(make_tuple(C, Y, X), integral_constant<bool, true>{}),
+            make_merge_transform_auto(make_tuple(N, Ho, Wo), integral_constant<bool, false>{})),
+        make_tuple(Sequence<1, 2, 4>{}, Sequence<0, 3, 5>{}),
+        make_tuple(Sequence<0>{}, Sequence<1>{}));
 
     // output tensor
     const auto out_gemmm_gemmn_global_desc = transform_tensor_descriptor(
@@ -163,12 +166,15 @@ transform_forward_convolution_into_gemm_v4r4_nchw_kcyx_nkhw_no_pad(
         make_tuple(Sequence<0>{}, Sequence<1>{}, Sequence<2>{}, Sequence<3>{}),
         make_tuple(Sequence<0>{}, Sequence<1>{}, Sequence<2, 3>{}, Sequence<4, 5>{}));
 
-    const auto in_gemmk_gemmn_global_desc =
-        transform_tensor_descriptor(in_n_c_y_ho_x_wo_global_desc,
-                                    make_tuple(make_merge_transform(make_tuple(C, Y, X)),
-                                               make_merge_transform(make_tuple(N, Ho, Wo))),
-                                    make_tuple(Sequence<1, 2, 4>{}, Sequence<0, 3, 5>{}),
-                                    make_tuple(Sequence<0>{}, Sequence<1>{}));
+    // GemmK is moved by the slice windows, by steps known at compile time, and the GemmN index is
+    // calculated from the block and thread id
+    const auto in_gemmk_gemmn_global_desc = transform_tensor_descriptor(
+        in_n_c_y_ho_x_wo_global_desc,
+        make_tuple(
+            make_merge_transform_auto(make_tuple(C, Y, X), integral_constant<bool, true>{}),
+            make_merge_transform_auto(make_tuple(N, Ho, Wo), integral_constant<bool, false>{})),
+        make_tuple(Sequence<1, 2, 4>{}, Sequence<0, 3, 5>{}),
+        make_tuple(Sequence<0>{}, Sequence<1>{}));
 
     // output tensor
     const auto out_gemmm_gemmn_global_desc = transform_tensor_descriptor(
@@ -238,7 +244,9 @@ __host__ __device__ constexpr auto transform_forward_convolution_into_gemm_v4r4_
     // input tensor
     const auto in_gemmk_gemmn_global_desc = transform_tensor_descriptor(
         in_n_c_hi_wi_global_desc,
-        make_tuple(make_pass_through_transform(C), make_merge_transform(make_tuple(N, Ho, Wo))),
+        make_tuple(
+            make_pass_through_transform(C),
+            make_merge_transform_auto(make_tuple(N, Ho, Wo), integral_constant<bool, false>{})),
         make_tuple(Sequence<1>{}, Sequence<0, 2, 3>{}),
         make_tuple(Sequence<0>{}, Sequence<1>{}));
 
@@ -82,12 +82,15 @@ __host__ __device__ constexpr auto transform_forward_convolution_into_gemm_v4r4_
         make_tuple(Sequence<0>{}, Sequence<1>{}, Sequence<2>{}, Sequence<3>{}),
         make_tuple(Sequence<0>{}, Sequence<1, 2>{}, Sequence<3, 4>{}, Sequence<5>{}));
 
-    const auto in_gemmk_gemmn_grid_desc =
-        transform_tensor_descriptor(in_n_y_ho_x_wo_c_grid_desc,
-                                    make_tuple(make_merge_transform(make_tuple(Y, X, C)),
-                                               make_merge_transform(make_tuple(N, Ho, Wo))),
-                                    make_tuple(Sequence<1, 3, 5>{}, Sequence<0, 2, 4>{}),
-                                    make_tuple(Sequence<0>{}, Sequence<1>{}));
+    // GemmK is moved by the slice windows, by steps known at compile time, and the GemmN index is
+    // calculated from the block and thread id
+    const auto in_gemmk_gemmn_grid_desc = transform_tensor_descriptor(
+        in_n_y_ho_x_wo_c_grid_desc,
+        make_tuple(
+            make_merge_transform_auto(make_tuple(Y, X, C), integral_constant<bool, true>{}),
+            make_merge_transform_auto(make_tuple(N, Ho, Wo), integral_constant<bool, false>{})),
+        make_tuple(Sequence<1, 3, 5>{}, Sequence<0, 2, 4>{}),
+        make_tuple(Sequence<0>{}, Sequence<1>{}));
 
     // output tensor
     const auto out_gemmm_gemmn_grid_desc = transform_tensor_descriptor(
@@ -30,7 +30,8 @@ struct PassThrough
     __host__ __device__ constexpr const auto& GetUpperLengths() const { return up_lengths_; }
 
     template <typename LowIdx, typename UpIdx>
-    __host__ __device__ static void CalculateLowerIndex(LowIdx& idx_low, const UpIdx& idx_up)
+    __host__ __device__ static constexpr void CalculateLowerIndex(LowIdx& idx_low,
+                                                                  const UpIdx& idx_up)
     {
         static_assert(LowIdx::Size() == 1 && UpIdx::Size() == 1,
                       "wrong! inconsistent # of dimension");
@@ -1018,16 +1019,9 @@ struct lambda_merge_generate_MagicDivision_calculate_magic_shift
 
 // Implementation of "Merge" transformation primitive that uses magic-number-division to do lowering
 // of both multi-index and delta of multi-index
-// Caution:
-//   1. The magic number division implementation being used would produce correct result if the
-//   dividended is uint32_t and its value is with in 31-bit value range of uint32_t.
-//   2. The magic number division for int32_t dividened has not been implemented, the int32_t
-//   dividend would be bit-wise interpreted as uint32_t and magic number division implementation for
-//   uint32_t is then used.
-//   3. For Merge primitive, upper-index is the dividend.
-//   4. When upper-index is uint32_t, its value need to be within 31-bit range.
-//   5. When upper-index is int32_t type (when index_t is int32_t), its value need to be
-//   non-negative.
+// Caution: upper-index is the dividend, and it is divided by
+// MagicDivision::DoMagicDivisionNonNegative, so it need to be non-negative. The lengths need to be
+// within [1, 2^31 - 1], as for any index_t length
 template <typename LowLengths>
 struct Merge_v2_magic_division
 {
@@ -1083,10 +1077,10 @@ struct Merge_v2_magic_division
         index_t tmp = idx_up[Number<0>{}];
 
         static_for<NDimLow - 1, 0, -1>{}([&, this](auto i) {
-            index_t tmp2 =
-                MagicDivision::DoMagicDivision(tmp,
-                                               this->low_lengths_magic_divisor_multiplier_[i],
-                                               this->low_lengths_magic_divisor_shift_[i]);
+            index_t tmp2 = MagicDivision::DoMagicDivisionNonNegative(
+                tmp,
+                this->low_lengths_magic_divisor_multiplier_[i],
+                this->low_lengths_magic_divisor_shift_[i]);
             idx_low(i) = tmp - tmp2 * this->low_lengths_[i];
             tmp        = tmp2;
         });
@@ -1112,10 +1106,10 @@ struct Merge_v2_magic_division
         index_t tmp = idx_up_new[Number<0>{}];
 
         static_for<NDimLow - 1, 0, -1>{}([&, this](auto i) {
-            index_t tmp2 =
-                MagicDivision::DoMagicDivision(tmp,
-                                               this->low_lengths_magic_divisor_multiplier_[i],
-                                               this->low_lengths_magic_divisor_shift_[i]);
+            index_t tmp2 = MagicDivision::DoMagicDivisionNonNegative(
+                tmp,
+                this->low_lengths_magic_divisor_multiplier_[i],
+                this->low_lengths_magic_divisor_shift_[i]);
 
             index_t idx_low_old = idx_low[i];
 
@@ -1170,16 +1164,9 @@ struct Merge_v2_magic_division
 
 // Implementation of "Merge" transformation primitive that uses magic-number-division to do lowering
 // of both multi-index and delta of multi-index
-// Caution:
-//   1. The magic number division implementation being used would produce correct result if the
-//   dividended is uint32_t and its value is with in 31-bit value range of uint32_t.
-//   2. The magic number division for int32_t dividened has not been implemented, the int32_t
-//   dividend would be bit-wise interpreted as uint32_t and magic number division implementation for
-//   uint32_t is then used.
-//   3. For Merge primitive, upper-index is the dividend.
-//   4. When upper-index is uint32_t, its value need to be within 31-bit range.
-//   5. When upper-index is int32_t type (when index_t is int32_t), its value need to be
-//   non-negative.
+// Caution: upper-index is the dividend, and it is divided by
+// MagicDivision::DoMagicDivisionNonNegative, so it need to be non-negative. The lengths need to be
+// within [1, 2^31 - 1], as for any index_t length
 template <typename LowLengths>
 struct Merge_v2r2_magic_division
 {
@@ -1241,10 +1228,10 @@ struct Merge_v2r2_magic_division
         index_t tmp = idx_up[Number<0>{}];
 
         static_for<0, NDimLow - 1, 1>{}([&, this](auto i) {
-            idx_low(i) =
-                MagicDivision::DoMagicDivision(tmp,
-                                               this->low_lengths_scan_magic_divisor_multiplier_[i],
-                                               this->low_lengths_scan_magic_divisor_shift_[i]);
+            idx_low(i) = MagicDivision::DoMagicDivisionNonNegative(
+                tmp,
+                this->low_lengths_scan_magic_divisor_multiplier_[i],
+                this->low_lengths_scan_magic_divisor_shift_[i]);
 
             tmp -= idx_low[i] * this->low_lengths_scan_[i];
         });
@@ -1272,10 +1259,10 @@ struct Merge_v2r2_magic_division
         static_for<0, NDimLow - 1, 1>{}([&, this](auto i) {
             index_t idx_low_old = idx_low[i];
 
-            idx_low(i) =
-                MagicDivision::DoMagicDivision(tmp,
-                                               this->low_lengths_scan_magic_divisor_multiplier_[i],
-                                               this->low_lengths_scan_magic_divisor_shift_[i]);
+            idx_low(i) = MagicDivision::DoMagicDivisionNonNegative(
+                tmp,
+                this->low_lengths_scan_magic_divisor_multiplier_[i],
+                this->low_lengths_scan_magic_divisor_shift_[i]);
 
             idx_diff_low(i) = idx_low[i] - idx_low_old;
 
@@ -1708,7 +1695,8 @@ struct Vectorize
     __host__ __device__ constexpr const auto& GetUpperLengths() const { return up_lengths_; }
 
     template <typename LowIdx, typename UpIdx>
-    __host__ __device__ void CalculateLowerIndex(LowIdx& idx_low, const UpIdx& idx_up) const
+    __host__ __device__ constexpr void CalculateLowerIndex(LowIdx& idx_low,
+                                                           const UpIdx& idx_up) const
     {
         static_assert(LowIdx::Size() == 1 && UpIdx::Size() == 1,
                       "wrong! inconsistent # of dimension");
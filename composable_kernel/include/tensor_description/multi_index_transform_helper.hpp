@@ -84,6 +84,89 @@ make_merge_transform_v3_division_mod(const LowLengths& low_lengths)
     return Merge_v3_division_mod<LowLengths>{low_lengths};
 }
 
+enum struct MergeTransformVariant_t
+{
+    CarryCheck,      // Merge_v1_carry_check
+    MagicDivision,   // Merge_v2_magic_division
+    MagicDivisionR2, // Merge_v2r2_magic_division
+    DivisionMod      // Merge_v3_division_mod
+};
+
+// ns per lowered index of each MergeTransformVariant_t, measured on the host by
+// "magic_division_driver_offline 0 1000", the fastest of 6 runs. With a known step, the index is
+// moved by UpdateLowerIndex by a step known at compile time, as the slice windows of the kernels.
+// Otherwise it is calculated by CalculateLowerIndex from an index known only at run time, as the
+// ones from the block and thread id
+__host__ __device__ constexpr float get_merge_transform_cost(bool is_step_known,
+                                                             bool is_lengths_known,
+                                                             index_t ndim_low,
+                                                             MergeTransformVariant_t variant)
+{
+    // [is_step_known][is_lengths_known][NDimLow - 2][variant], for NDimLow 2, 3 and 4
+    constexpr float cost[2][2][3][4] = {
+        {{{2.1, 1.3, 1.3, 2.1}, {4.2, 2.3, 2.2, 4.2}, {6.3, 3.1, 3.4, 6.3}},
+         {{1.3, 1.1, 1.1, 1.3}, {2.3, 1.9, 1.8, 2.4}, {3.5, 2.3, 2.7, 3.4}}},
+        {{{0.9, 1.5, 1.4, 2.1}, {1.4, 2.2, 2.2, 4.2}, {8.7, 3.6, 3.6, 6.2}},
+         {{0.8, 1.5, 1.5, 1.1}, {1.4, 1.8, 2.2, 2.3}, {5.4, 2.2, 3.0, 3.9}}}};
+
+    // more than 4 dimensions are taken as 4, and 1 as 2
+    const index_t i = math::min(math::max(ndim_low, 2), 4) - 2;
+
+    return cost[is_step_known][is_lengths_known][i][static_cast<index_t>(variant)];
+}
+
+// The cheapest variant. A later variant only replaces an earlier one if it costs less than 4/5 of
+// it, as the costs vary by about a fifth from run to run: carry-check, the default Merge, stays
+// unless another variant is clearly cheaper
+__host__ __device__ constexpr MergeTransformVariant_t
+get_merge_transform_variant(bool is_step_known, bool is_lengths_known, index_t ndim_low)
+{
+    MergeTransformVariant_t variants[4] = {MergeTransformVariant_t::CarryCheck,
+                                           MergeTransformVariant_t::MagicDivision,
+                                           MergeTransformVariant_t::MagicDivisionR2,
+                                           MergeTransformVariant_t::DivisionMod};
+
+    MergeTransformVariant_t best = variants[0];
+
+    for(index_t i = 1; i < 4; ++i)
+    {
+        if(get_merge_transform_cost(is_step_known, is_lengths_known, ndim_low, variants[i]) <
+           0.8f * get_merge_transform_cost(is_step_known, is_lengths_known, ndim_low, best))
+        {
+            best = variants[i];
+        }
+    }
+
+    return best;
+}
+
+// Merge of the variant that is the cheapest for these lengths, by whether they are all known at
+// compile time and how many they are, and for how the merged index is moved: IsStepKnown if it is
+// moved by steps known at compile time, as the GemmK dimension, so that carry-check only adds and
+// compares. Otherwise, as for an index calculated from the block and thread id, a variant that
+// divides is usually cheaper
+template <typename LowLengths, bool IsStepKnown = true>
+__host__ __device__ constexpr auto
+make_merge_transform_auto(const LowLengths& low_lengths,
+                          integral_constant<bool, IsStepKnown> = integral_constant<bool, true>{})
+{
+#if CK_EXPERIMENTAL_MERGE_TRANSFORM_AUTO
+    constexpr auto variant = get_merge_transform_variant(
+        IsStepKnown, is_known_at_compile_time<LowLengths>::value, LowLengths::Size());
+
+    if constexpr(variant == MergeTransformVariant_t::CarryCheck)
+        return make_merge_transform_v1_carry_check(low_lengths);
+    else if constexpr(variant == MergeTransformVariant_t::MagicDivision)
+        return Merge_v2_magic_division<LowLengths>{low_lengths};
+    else if constexpr(variant == MergeTransformVariant_t::MagicDivisionR2)
+        return Merge_v2r2_magic_division<LowLengths>{low_lengths};
+    else
+        return make_merge_transform_v3_division_mod(low_lengths);
+#else
+    return make_merge_transform(low_lengths);
+#endif
+}
+
 template <typename UpLengths, bool Use24BitIntegerCalculation = false>
 __host__ __device__ constexpr auto make_unmerge_transform(
     const UpLengths& up_lengths,
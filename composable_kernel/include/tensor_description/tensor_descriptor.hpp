@@ -12,6 +12,21 @@ struct TensorCoordinate;
 template <index_t NTransform, index_t NDimVisible, typename UpdateLowerIndexHack>
 struct TensorCoordinateStep;
 
+// Affine map from some hidden dimensions to NDimOut others, keeping only the strides that are not
+// always 0: idx_out[o] = bases_[o] + sum_j strides_[o][j] * idx_in[ids_in[o][j]]
+// Strides: Tuple<MultiIndex<...>, ...>, the strides of each output
+template <typename Strides, index_t NDimOut>
+struct TensorDescriptorAffineMap
+{
+    Strides strides_;
+    MultiIndex<NDimOut> bases_;
+};
+
+// stored instead of the affine map by descriptors without one, takes no space as an empty member
+struct TensorDescriptorNoAffineMap
+{
+};
+
 // Transforms: Tuple<transforms...>
 // LowerDimensionIdss : Tuple<Sequence<...>, ...>
 // UpperDimensionIdss : Tuple<Sequence<...>, ...>
@@ -99,6 +114,290 @@ struct TensorDescriptor
         return make_tuple(itran_found, idim_up_found, found);
     }
 
+    // Affine bottom of the transformation chain
+    //
+    // The transforms from the offset up whose lower index is a constant plus a linear function of
+    // their upper index (IsLinearTransform), e.g. the Embed/UnMerge of the naive descriptor and
+    // the Pad and Embed of a convolution input, compose into one affine map. Its inputs are the
+    // hidden dimensions on top of these transforms, its outputs are the offset and the upper
+    // dimensions of the transforms whose validity is checked (Pad). move_tensor_coordinate()
+    // evaluates the map instead of walking these transforms, and leaves the hidden dimensions in
+    // between as they are.
+
+    // 1 for the transforms in the affine bottom: affine transforms whose lower dimensions are the
+    // offset or upper dimensions of other transforms in it
+    __host__ __device__ static constexpr auto CalculateAffineTransformFlags()
+    {
+        // 1 for the offset and for the upper dimensions of the affine transforms found so far
+        auto is_affine_dim = make_zero_multi_index<ndim_hidden_>();
+
+        static_for<0, ndim_hidden_, 1>{}([&](auto idim) { is_affine_dim(idim) = 1; });
+
+        static_for<0, ntransform_, 1>{}([&](auto itran) {
+            constexpr auto dims_up = UpperDimensionIdss{}[itran];
+
+            static_for<0, dims_up.Size(), 1>{}([&](auto i) { is_affine_dim(dims_up[i]) = 0; });
+        });
+
+        auto is_affine_tran = make_zero_multi_index<ntransform_>();
+
+        static_for<0, ntransform_, 1>{}([&](auto itran) {
+            using Tran = remove_cvref_t<decltype(Transforms{}[itran])>;
+
+            constexpr auto dims_low = LowerDimensionIdss{}[itran];
+            constexpr auto dims_up  = UpperDimensionIdss{}[itran];
+
+            bool is_affine = Tran::IsLinearTransform();
+
+            static_for<0, dims_low.Size(), 1>{}(
+                [&](auto i) { is_affine = is_affine && is_affine_dim[dims_low[i]]; });
+
+            if(is_affine)
+            {
+                is_affine_tran(itran) = 1;
+
+                static_for<0, dims_up.Size(), 1>{}(
+                    [&](auto i) { is_affine_dim(dims_up[i]) = 1; });
+            }
+        });
+
+        return is_affine_tran;
+    }
+
+    // 1 for the inputs: upper dimensions of the affine bottom that are not its lower dimensions.
+    // 2 for the outputs: lower dimensions of the affine bottom that are not upper dimensions of
+    // any transform (the offset), and upper dimensions of it whose validity is checked
+    __host__ __device__ static constexpr auto CalculateAffineDimensionFlags()
+    {
+        auto is_up        = make_zero_multi_index<ndim_hidden_>();
+        auto is_affine_up = make_zero_multi_index<ndim_hidden_>();
+        auto is_checked   = make_zero_multi_index<ndim_hidden_>();
+        auto is_low       = make_zero_multi_index<ndim_hidden_>();
+
+        static_for<0, ntransform_, 1>{}([&](auto itran) {
+            using Tran = remove_cvref_t<decltype(Transforms{}[itran])>;
+
+            constexpr auto dims_low = LowerDimensionIdss{}[itran];
+            constexpr auto dims_up  = UpperDimensionIdss{}[itran];
+
+            constexpr bool is_affine = CalculateAffineTransformFlags()[itran];
+
+            static_for<0, dims_up.Size(), 1>{}([&](auto i) {
+                is_up(dims_up[i])        = 1;
+                is_affine_up(dims_up[i]) = is_affine;
+                is_checked(dims_up[i]) =
+                    is_affine && !Tran::IsValidUpperIndexAlwaysMappedToValidLowerIndex();
+            });
+
+            if constexpr(is_affine)
+            {
+                static_for<0, dims_low.Size(), 1>{}([&](auto i) { is_low(dims_low[i]) = 1; });
+            }
+        });
+
+        auto flags = make_zero_multi_index<ndim_hidden_>();
+
+        static_for<0, ndim_hidden_, 1>{}([&](auto idim) {
+            if(is_affine_up[idim] && !is_low[idim])
+                flags(idim) = 1;
+            else if((is_low[idim] && !is_up[idim]) || is_checked[idim])
+                flags(idim) = 2;
+        });
+
+        return flags;
+    }
+
+    __host__ __device__ static constexpr auto GetAffineTransformMask()
+    {
+        return generate_sequence_v2(
+            [](auto itran) { return Number<CalculateAffineTransformFlags()[itran]>{}; },
+            Number<ntransform_>{});
+    }
+
+    __host__ __device__ static constexpr auto GetAffineInputDimensionIds()
+    {
+        constexpr auto mask = generate_sequence_v2(
+            [](auto idim) { return Number<CalculateAffineDimensionFlags()[idim] == 1>{}; },
+            Number<ndim_hidden_>{});
+
+        return pick_sequence_elements_by_mask(
+            typename arithmetic_sequence_gen<0, ndim_hidden_, 1>::type{}, mask);
+    }
+
+    __host__ __device__ static constexpr auto GetAffineOutputDimensionIds()
+    {
+        constexpr auto mask = generate_sequence_v2(
+            [](auto idim) { return Number<CalculateAffineDimensionFlags()[idim] == 2>{}; },
+            Number<ndim_hidden_>{});
+
+        return pick_sequence_elements_by_mask(
+            typename arithmetic_sequence_gen<0, ndim_hidden_, 1>::type{}, mask);
+    }
+
+    // 1 for the inputs that output IOut depends on, judging by which dimensions each affine
+    // transform reads. The other strides of the output are 0
+    template <index_t IOut>
+    __host__ __device__ static constexpr auto CalculateAffineDependencyFlags(Number<IOut>)
+    {
+        constexpr auto dims_in    = GetAffineInputDimensionIds();
+        constexpr index_t dim_out = GetAffineOutputDimensionIds().At(Number<IOut>{});
+
+        auto flags = make_zero_multi_index<dims_in.Size()>();
+
+        static_for<0, dims_in.Size(), 1>{}([&](auto i) {
+            // 1 for the hidden dimensions that depend on input i
+            auto is_dependent = make_zero_multi_index<ndim_hidden_>();
+
+            is_dependent(dims_in[i]) = 1;
+
+            static_for<ntransform_ - 1, -1, -1>{}([&](auto itran) {
+                if constexpr(GetAffineTransformMask()[itran])
+                {
+                    constexpr auto dims_low = LowerDimensionIdss{}[itran];
+                    constexpr auto dims_up  = UpperDimensionIdss{}[itran];
+
+                    bool is_up_dependent = false;
+
+                    static_for<0, dims_up.Size(), 1>{}([&](auto j) {
+                        is_up_dependent = is_up_dependent || is_dependent[dims_up[j]];
+                    });
+
+                    static_for<0, dims_low.Size(), 1>{}([&](auto j) {
+                        is_dependent(dims_low[j]) = is_dependent[dims_low[j]] || is_up_dependent;
+                    });
+                }
+            });
+
+            flags(i) = is_dependent[Number<dim_out>{}];
+        });
+
+        return flags;
+    }
+
+    // positions in GetAffineInputDimensionIds() of the inputs that output IOut depends on
+    template <index_t IOut>
+    __host__ __device__ static constexpr auto GetAffineDependentInputIds(Number<IOut>)
+    {
+        constexpr index_t nin = GetAffineInputDimensionIds().Size();
+
+        constexpr auto mask = generate_sequence_v2(
+            [](auto i) { return Number<CalculateAffineDependencyFlags(Number<IOut>{})[i]>{}; },
+            Number<nin>{});
+
+        return pick_sequence_elements_by_mask(typename arithmetic_sequence_gen<0, nin, 1>::type{},
+                                              mask);
+    }
+
+    // the affine transform whose lower dimensions include output IOut: the output changes when
+    // that transform is done by a step
+    template <index_t IOut>
+    __host__ __device__ static constexpr index_t GetAffineOutputTransformId(Number<IOut>)
+    {
+        constexpr index_t dim_out = GetAffineOutputDimensionIds().At(Number<IOut>{});
+
+        index_t itran_found = 0;
+
+        static_for<0, ntransform_, 1>{}([&](auto itran) {
+            constexpr auto dims_low = LowerDimensionIdss{}[itran];
+
+            static_for<0, dims_low.Size(), 1>{}([&](auto i) {
+                if constexpr(dims_low[i] == dim_out)
+                    itran_found = itran;
+            });
+        });
+
+        return itran_found;
+    }
+
+    // only worth it if there is a chain to flatten
+    __host__ __device__ static constexpr bool HasAffineFastPath()
+    {
+#if CK_EXPERIMENTAL_TENSOR_DESCRIPTOR_FLATTEN_AFFINE_TRANSFORMS
+        index_t num_affine_tran = 0;
+
+        static_for<0, ntransform_, 1>{}(
+            [&](auto itran) { num_affine_tran += GetAffineTransformMask()[itran]; });
+
+        return num_affine_tran > 1;
+#else
+        return false;
+#endif
+    }
+
+    __host__ __device__ static constexpr bool IsAffineMapKnownAtCompileTime()
+    {
+        bool is_known = true;
+
+        static_for<0, ntransform_, 1>{}([&](auto itran) {
+            if constexpr(GetAffineTransformMask()[itran])
+                is_known &= remove_cvref_t<decltype(Transforms{}[itran])>::IsKnownAtCompileTime();
+        });
+
+        return is_known;
+    }
+
+    // evaluate the affine bottom, with get_transform(itran) giving the transforms, at zero inputs
+    // for the bases and at each unit input for the strides
+    template <typename GetTransform>
+    __host__ __device__ static constexpr auto CalculateAffineMap(GetTransform get_transform)
+    {
+        constexpr auto dims_in  = GetAffineInputDimensionIds();
+        constexpr auto dims_out = GetAffineOutputDimensionIds();
+
+        constexpr index_t nin  = dims_in.Size();
+        constexpr index_t nout = dims_out.Size();
+
+        // all the strides, before the ones that are always 0 are dropped
+        StaticallyIndexedArray<MultiIndex<nin>, nout> strides{};
+        MultiIndex<nout> bases{};
+
+        static_for<0, nin + 1, 1>{}([&](auto i) {
+            auto idx_hidden = make_zero_multi_index<ndim_hidden_>();
+
+            if constexpr(i < nin)
+                idx_hidden(dims_in[i]) = 1;
+
+            static_for<ntransform_, 0, -1>{}([&](auto itran_p1) {
+                constexpr auto itran = itran_p1 - Number<1>{};
+
+                if constexpr(GetAffineTransformMask()[itran])
+                {
+                    constexpr auto dims_low = LowerDimensionIdss{}[itran];
+                    constexpr auto dims_up  = UpperDimensionIdss{}[itran];
+
+                    const auto idx_up = get_container_subset(idx_hidden, dims_up);
+
+                    auto idx_low = make_zero_multi_index<dims_low.Size()>();
+
+                    get_transform(itran).CalculateLowerIndex(idx_low, idx_up);
+
+                    set_container_subset(idx_hidden, dims_low, idx_low);
+                }
+            });
+
+            static_for<0, nout, 1>{}([&](auto o) {
+                if constexpr(i < nin)
+                    strides(o)(i) = idx_hidden[dims_out[o]];
+                else
+                    bases(o) = idx_hidden[dims_out[o]];
+            });
+        });
+
+        AffineMap affine_map{};
+
+        affine_map.bases_ = bases;
+
+        static_for<0, nout, 1>{}([&](auto o) {
+            constexpr auto ids_in = GetAffineDependentInputIds(o);
+
+            static_for<0, ids_in.Size(), 1>{}([&](auto j) {
+                affine_map.strides_(o)(j) = strides[o][ids_in[j]] - bases[o];
+            });
+        });
+
+        return affine_map;
+    }
+
     constexpr static index_t ntransform_   = GetNumOfTransform();
     constexpr static index_t ndim_visible_ = GetNumOfVisibleDimension();
     constexpr static index_t ndim_hidden_  = GetNumOfHiddenDimension();
@@ -110,6 +409,46 @@ struct TensorDescriptor
     // may be index_t or Number<>
     using ElementSize = remove_cv_t<decltype(InitializeElementSize(Transforms{}))>;
 
+    __host__ __device__ static constexpr auto GetAffineMapType()
+    {
+        if constexpr(HasAffineFastPath())
+        {
+            constexpr index_t nout = GetAffineOutputDimensionIds().Size();
+
+            const auto strides = generate_tuple(
+                [](auto o) { return MultiIndex<GetAffineDependentInputIds(o).Size()>{}; },
+                Number<nout>{});
+
+            return TensorDescriptorAffineMap<remove_cv_t<decltype(strides)>, nout>{};
+        }
+        else
+        {
+            return TensorDescriptorAffineMap<Tuple<>, 0>{};
+        }
+    }
+
+    using AffineMap = decltype(GetAffineMapType());
+
+    // the affine map is only stored if it is calculated from runtime values
+    constexpr static bool is_affine_map_stored_ =
+        HasAffineFastPath() && !IsAffineMapKnownAtCompileTime();
+
+    using AffineMapStorage =
+        conditional_t<is_affine_map_stored_, AffineMap, TensorDescriptorNoAffineMap>;
+
+    __host__ __device__ static constexpr auto InitializeAffineMap(const Transforms& transforms)
+    {
+        if constexpr(is_affine_map_stored_)
+        {
+            return CalculateAffineMap(
+                [&](auto itran) -> const auto& { return transforms[itran]; });
+        }
+        else
+        {
+            return AffineMapStorage{};
+        }
+    }
+
     public:
     __host__ __device__ constexpr TensorDescriptor() = default;
 
@@ -117,8 +456,8 @@ struct TensorDescriptor
                                                    ElementSpaceSize element_space_size)
         : transforms_{transforms},
           element_size_{InitializeElementSize(transforms)},
-          element_space_size_{element_space_size}
-
+          element_space_size_{element_space_size},
+          affine_map_{InitializeAffineMap(transforms)}
     {
         static_assert(Transforms::Size() == ntransform_ &&
                           LowerDimensionIdss::Size() == ntransform_ &&
@@ -180,6 +519,22 @@ struct TensorDescriptor
         return VisibleDimensionIds{};
     }
 
+    // only if HasAffineFastPath()
+    __host__ __device__ constexpr auto GetAffineMap() const
+    {
+        if constexpr(is_affine_map_stored_)
+        {
+            return affine_map_;
+        }
+        else
+        {
+            constexpr auto affine_map = CalculateAffineMap(
+                [](auto itran) { return remove_cvref_t<decltype(Transforms{}[itran])>{}; });
+
+            return affine_map;
+        }
+    }
+
     __host__ __device__ static constexpr bool IsKnownAtCompileTime()
     {
         bool is_known = true;
@@ -213,6 +568,7 @@ struct TensorDescriptor
     Transforms transforms_;
     ElementSize element_size_;
     ElementSpaceSize element_space_size_;
+    [[no_unique_address]] AffineMapStorage affine_map_;
 };
 
 template <index_t NDimHidden, typename VisibleDimensionIds>
@@ -277,7 +633,7 @@ struct TensorCoordinateStep
     MultiIndex<NTransform> do_transforms_;
 
     // HACK: control UpdateLowerIndex()
-    static constexpr UpdateLowerIndexHack update_lower_index_hack_;
+    static constexpr UpdateLowerIndexHack update_lower_index_hack_{};
 };
 
 // TODO: How to fix this? It uses an struct instead of lambda because lambda
@@ -400,6 +756,9 @@ __host__ __device__ constexpr auto make_tensor_coordinate(const TensorDesc& tens
     set_container_subset(idx_hidden, visible_dim_ids, idx_visible);
 
     // calculate hidden index
+    // The affine bottom of the chain is walked too, not evaluated by its affine map: walking it
+    // shares the index of each dimension between the offset and the validity checks, the map
+    // recomputes it for each of them
     static_for<ntransform, 0, -1>{}([&tensor_desc, &idx_hidden](auto itran_p1) {
         auto itran              = itran_p1 - Number<1>{};
         const auto& tran        = tensor_desc.GetTransforms().At(itran);
@@ -510,9 +869,12 @@ __host__ __device__ constexpr void move_tensor_coordinate(const TensorDesc& tens
 
     set_container_subset(idx_hidden, TensorDesc::GetVisibleDimensionIds(), idx_hidden_pick_visible);
 
-    // update rest of hidden index
+    // update rest of hidden index, but the affine bottom of the chain, which is done below
     static_for<ntransform - 1, -1, -1>{}([&](auto itran) {
-        if(coord_step.do_transforms_[itran])
+        constexpr bool is_affine_bottom =
+            TensorDesc::HasAffineFastPath() && TensorDesc::GetAffineTransformMask().At(itran);
+
+        if(!is_affine_bottom && coord_step.do_transforms_[itran])
         {
             const auto& tran        = tensor_desc.GetTransforms().At(itran);
             constexpr auto dims_low = TensorDesc::GetLowerDimensionIdss().At(itran);
@@ -533,6 +895,34 @@ __host__ __device__ constexpr void move_tensor_coordinate(const TensorDesc& tens
             set_container_subset(idx_hidden, dims_low, idx_low);
         }
     });
+
+    // update the offset and the checked dimensions of the affine bottom by its affine map. The
+    // other dimensions of it are not updated, and nothing reads them
+    if constexpr(TensorDesc::HasAffineFastPath())
+    {
+        const auto affine_map = tensor_desc.GetAffineMap();
+
+        constexpr auto dims_in  = TensorDesc::GetAffineInputDimensionIds();
+        constexpr auto dims_out = TensorDesc::GetAffineOutputDimensionIds();
+
+        static_for<0, dims_out.Size(), 1>{}([&](auto o) {
+            constexpr index_t itran = TensorDesc::GetAffineOutputTransformId(o);
+
+            if(coord_step.do_transforms_[Number<itran>{}])
+            {
+                constexpr auto ids_in = TensorDesc::GetAffineDependentInputIds(o);
+
+                index_t idx_diff_out = 0;
+
+                static_for<0, ids_in.Size(), 1>{}([&](auto j) {
+                    idx_diff_out +=
+                        affine_map.strides_[o][j] * idx_diff_hidden[dims_in[ids_in[j]]];
+                });
+
+                idx_hidden(dims_out[o]) += idx_diff_out;
+            }
+        });
+    }
 }
 
 template <typename TensorDesc, typename TensorCoord>
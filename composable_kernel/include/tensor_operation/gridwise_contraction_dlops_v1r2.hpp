@@ -32,21 +32,31 @@ __global__ void
             const AGridDesc_GK0_GM0_GM10_GM11_GK1 a_grid_desc_gk0_gm0_gm10_gm11_gk1,
             const BGridDesc_GK0_GN0_GN10_GN11_GK1 b_grid_desc_gk0_gn0_gn10_gn11_gk1,
             const CGridDesc_GM10_BM0_BM1_GN10_BN0_BN1 c_grid_desc_gm10_bm0_bm1_gn10_bn0_bn1,
-            const CGridBlockCluster_BlockId_To_GM10_GN10 c_grid_block_cluster_blockid_to_gm10_gn10)
+            const CGridBlockCluster_BlockId_To_GM10_GN10 c_grid_block_cluster_blockid_to_gm10_gn10,
+            const index_t num_block_per_group,
+            const index_t a_grid_group_stride,
+            const index_t b_grid_group_stride,
+            const index_t c_grid_group_stride)
 {
     constexpr index_t shared_block_size =
         GridwiseContraction::GetSharedMemoryNumberOfByte() / sizeof(FloatAB);
 
     __shared__ FloatAB p_shared_block[shared_block_size];
 
-    GridwiseContraction::Run(p_a_grid,
-                             p_b_grid,
-                             p_c_grid,
+    // the blocks of group g are [g * num_block_per_group, (g + 1) * num_block_per_group), they
+    // contract A, B and C shifted by g group strides
+    const index_t block_id = get_block_1d_id();
+    const index_t group    = __builtin_amdgcn_readfirstlane(block_id / num_block_per_group);
+
+    GridwiseContraction::Run(p_a_grid + group * a_grid_group_stride,
+                             p_b_grid + group * b_grid_group_stride,
+                             p_c_grid + group * c_grid_group_stride,
                              p_shared_block,
                              a_grid_desc_gk0_gm0_gm10_gm11_gk1,
                              b_grid_desc_gk0_gn0_gn10_gn11_gk1,
                              c_grid_desc_gm10_bm0_bm1_gn10_bn0_bn1,
                              c_grid_block_cluster_blockid_to_gm10_gn10,
+                             block_id - group * num_block_per_group,
                              integral_constant<bool, HasMainKBlockLoop>{},
                              integral_constant<bool, HasDoubleTailKBlockLoop>{});
 }
@@ -316,6 +326,42 @@ struct GridwiseContractionDlops_A_GK0_GM0_GM1_GK1_B_GK0_GN0_GN1_GK1_C_GM0_GM1_GN
     using CGridBlockCluster_BlockId_To_GM10_GN10 =
         decltype(MakeCGridBlockCluster_BlockId_To_GM10_GN10(CGridDesc_GM0_GM1_GN0_GN1{}));
 
+    // step hacks given as Tuple<> stand for none: 0 for every transform of GridDesc in both
+    // directions of every dimension, as the transfers use without hacks. The count includes the
+    // transforms appended above, which callers then need not know
+    template <typename StepHacks, typename GridDesc>
+    __host__ __device__ static constexpr auto GetGridStepHacks(StepHacks, GridDesc)
+    {
+        if constexpr(is_same<StepHacks, Tuple<>>::value)
+        {
+            constexpr auto zeros =
+                typename uniform_sequence_gen<GridDesc::GetNumOfTransform(), 0>::type{};
+
+            constexpr auto ndim = Number<GridDesc::GetNumOfDimension()>{};
+
+            return make_tuple(generate_tuple([&](auto) { return zeros; }, ndim),
+                              generate_tuple([&](auto) { return zeros; }, ndim));
+        }
+        else
+        {
+            return StepHacks{};
+        }
+    }
+
+    // move slice window step hacks given as Sequence<> stand for none
+    template <typename StepHacks, typename GridDesc>
+    __host__ __device__ static constexpr auto GetGridMoveSliceWindowStepHacks(StepHacks, GridDesc)
+    {
+        if constexpr(is_same<StepHacks, Sequence<>>::value)
+        {
+            return typename uniform_sequence_gen<GridDesc::GetNumOfTransform(), 0>::type{};
+        }
+        else
+        {
+            return StepHacks{};
+        }
+    }
+
     template <bool HasMainKBlockLoop, bool HasDoubleTailKBlockLoop>
     __device__ static void
     Run(const FloatAB* __restrict__ p_a_grid,
@@ -326,6 +372,7 @@ struct GridwiseContractionDlops_A_GK0_GM0_GM1_GK1_B_GK0_GN0_GN1_GK1_C_GM0_GM1_GN
         const BGridDesc_GK0_GN0_GN10_GN11_GK1& b_grid_desc_gk0_gn0_gn10_gn11_gk1,
         const CGridDesc_GM10_BM0_BM1_GN10_BN0_BN1& c_grid_desc_gm10_bm0_bm1_gn10_bn0_bn1,
         const CGridBlockCluster_BlockId_To_GM10_GN10& c_grid_block_cluster_blockid_to_gm10_gn10,
+        const index_t block_id,
         integral_constant<bool, HasMainKBlockLoop>,
         integral_constant<bool, HasDoubleTailKBlockLoop>)
     {
@@ -338,10 +385,21 @@ struct GridwiseContractionDlops_A_GK0_GM0_GM1_GK1_B_GK0_GN0_GN1_GK1_C_GM0_GM1_GN
 
         const auto GK0 = a_grid_desc_gk0_gm0_gm10_gm11_gk1.GetLength(I0);
 
+        constexpr auto a_grid_step_hacks =
+            GetGridStepHacks(AGridStepHacks{}, AGridDesc_GK0_GM0_GM10_GM11_GK1{});
+        constexpr auto b_grid_step_hacks =
+            GetGridStepHacks(BGridStepHacks{}, BGridDesc_GK0_GN0_GN10_GN11_GK1{});
+        constexpr auto c_grid_step_hacks =
+            GetGridStepHacks(CGridStepHacks{}, CGridDesc_GM10_BM0_BM1_GN10_BN0_BN1{});
+        constexpr auto a_grid_move_slice_window_step_hacks = GetGridMoveSliceWindowStepHacks(
+            AGridMoveSliceWindowStepHacks{}, AGridDesc_GK0_GM0_GM10_GM11_GK1{});
+        constexpr auto b_grid_move_slice_window_step_hacks = GetGridMoveSliceWindowStepHacks(
+            BGridMoveSliceWindowStepHacks{}, BGridDesc_GK0_GN0_GN10_GN11_GK1{});
+
         // divide block work by [GM10, GN10]
         const auto c_gm10_gn10_block_cluster_idx =
             c_grid_block_cluster_blockid_to_gm10_gn10.CalculateBottomIndex(
-                make_multi_index(get_block_1d_id()));
+                make_multi_index(block_id));
 
         // HACK: this force index data into SGPR
         const index_t igm10 = __builtin_amdgcn_readfirstlane(c_gm10_gn10_block_cluster_idx[I0]);
@@ -496,9 +554,9 @@ struct GridwiseContractionDlops_A_GK0_GM0_GM1_GK1_B_GK0_GN0_GN1_GK1_C_GM0_GM1_GN
         // LDS double buffer: preload data into LDS
         {
             a_blockwise_copy.RunRead(
-                a_grid_desc_gk0_gm0_gm10_gm11_gk1, a_global_buf, AGridStepHacks{});
+                a_grid_desc_gk0_gm0_gm10_gm11_gk1, a_global_buf, a_grid_step_hacks);
             b_blockwise_copy.RunRead(
-                b_grid_desc_gk0_gn0_gn10_gn11_gk1, b_global_buf, BGridStepHacks{});
+                b_grid_desc_gk0_gn0_gn10_gn11_gk1, b_global_buf, b_grid_step_hacks);
 
             a_blockwise_copy.RunWrite(a_block_desc_gk0_gm0_gm10_gm11_gk1, a_block_even_buf);
             b_blockwise_copy.RunWrite(b_block_desc_gk0_gn0_gn10_gn11_gk1, b_block_even_buf);
@@ -515,18 +573,18 @@ struct GridwiseContractionDlops_A_GK0_GM0_GM1_GK1_B_GK0_GN0_GN1_GK1_C_GM0_GM1_GN
                 // even iteration
                 a_blockwise_copy.MoveSrcSliceWindow(a_grid_desc_gk0_gm0_gm10_gm11_gk1,
                                                     a_block_slice_copy_step,
-                                                    AGridMoveSliceWindowStepHacks{});
+                                                    a_grid_move_slice_window_step_hacks);
                 b_blockwise_copy.MoveSrcSliceWindow(b_grid_desc_gk0_gn0_gn10_gn11_gk1,
                                                     b_block_slice_copy_step,
-                                                    BGridMoveSliceWindowStepHacks{});
+                                                    b_grid_move_slice_window_step_hacks);
 
                 __syncthreads();
 
                 // LDS doubel buffer: load next data from device mem
                 a_blockwise_copy.RunRead(
-                    a_grid_desc_gk0_gm0_gm10_gm11_gk1, a_global_buf, AGridStepHacks{});
+                    a_grid_desc_gk0_gm0_gm10_gm11_gk1, a_global_buf, a_grid_step_hacks);
                 b_blockwise_copy.RunRead(
-                    b_grid_desc_gk0_gn0_gn10_gn11_gk1, b_global_buf, BGridStepHacks{});
+                    b_grid_desc_gk0_gn0_gn10_gn11_gk1, b_global_buf, b_grid_step_hacks);
 
                 // LDS double buffer: GEMM on current data
                 blockwise_gemm.Run(c_thread_desc_bm0_bm1_bn0_bn1,
@@ -541,18 +599,18 @@ struct GridwiseContractionDlops_A_GK0_GM0_GM1_GK1_B_GK0_GN0_GN1_GK1_C_GM0_GM1_GN
                 // odd iteration
                 a_blockwise_copy.MoveSrcSliceWindow(a_grid_desc_gk0_gm0_gm10_gm11_gk1,
                                                     a_block_slice_copy_step,
-                                                    AGridMoveSliceWindowStepHacks{});
+                                                    a_grid_move_slice_window_step_hacks);
                 b_blockwise_copy.MoveSrcSliceWindow(b_grid_desc_gk0_gn0_gn10_gn11_gk1,
                                                     b_block_slice_copy_step,
-                                                    BGridMoveSliceWindowStepHacks{});
+                                                    b_grid_move_slice_window_step_hacks);
 
                 __syncthreads();
 
                 // LDS doubel buffer: load next data from device mem
                 a_blockwise_copy.RunRead(
-                    a_grid_desc_gk0_gm0_gm10_gm11_gk1, a_global_buf, AGridStepHacks{});
+                    a_grid_desc_gk0_gm0_gm10_gm11_gk1, a_global_buf, a_grid_step_hacks);
                 b_blockwise_copy.RunRead(
-                    b_grid_desc_gk0_gn0_gn10_gn11_gk1, b_global_buf, BGridStepHacks{});
+                    b_grid_desc_gk0_gn0_gn10_gn11_gk1, b_global_buf, b_grid_step_hacks);
 
                 // LDS double buffer: GEMM on current data
                 blockwise_gemm.Run(
@@ -571,18 +629,18 @@ struct GridwiseContractionDlops_A_GK0_GM0_GM1_GK1_B_GK0_GN0_GN1_GK1_C_GM0_GM1_GN
         {
             a_blockwise_copy.MoveSrcSliceWindow(a_grid_desc_gk0_gm0_gm10_gm11_gk1,
                                                 a_block_slice_copy_step,
-                                                AGridMoveSliceWindowStepHacks{});
+                                                a_grid_move_slice_window_step_hacks);
             b_blockwise_copy.MoveSrcSliceWindow(b_grid_desc_gk0_gn0_gn10_gn11_gk1,
                                                 b_block_slice_copy_step,
-                                                BGridMoveSliceWindowStepHacks{});
+                                                b_grid_move_slice_window_step_hacks);
 
             __syncthreads();
 
             // LDS double buffer: load last data from device mem
             a_blockwise_copy.RunRead(
-                a_grid_desc_gk0_gm0_gm10_gm11_gk1, a_global_buf, AGridStepHacks{});
+                a_grid_desc_gk0_gm0_gm10_gm11_gk1, a_global_buf, a_grid_step_hacks);
             b_blockwise_copy.RunRead(
-                b_grid_desc_gk0_gn0_gn10_gn11_gk1, b_global_buf, BGridStepHacks{});
+                b_grid_desc_gk0_gn0_gn10_gn11_gk1, b_global_buf, b_grid_step_hacks);
 
             // LDS double buffer: GEMM on 2nd-last data
             blockwise_gemm.Run(
@@ -650,7 +708,7 @@ struct GridwiseContractionDlops_A_GK0_GM0_GM1_GK1_B_GK0_GN0_GN1_GK1_C_GM0_GM1_GN
                      c_thread_buf,
                      c_grid_desc_gm10_bm0_bm1_gn10_bn0_bn1,
                      c_grid_buf,
-                     CGridStepHacks{});
+                     c_grid_step_hacks);
         }
     }
 };
@@ -2,6 +2,7 @@
 #define CK_AMD_BUFFER_ADDRESSING_HPP
 
 #include "data_type.hpp"
+#include "c_style_pointer_cast.hpp"
 
 namespace ck {
 
@@ -31,6 +32,114 @@ __device__ int32x4_t make_wave_buffer_resource(T* p_wave, index_t element_space_
     return wave_buffer_resource.content;
 }
 
+#ifdef CK_CPU_TARGET
+// CPU target: buffer instructions on host memory, with the range check of the hardware: an access
+// that does not fit in the range of the buffer resource loads zero and stores nothing. This is also
+// what makes the OOB check offset trick work
+template <typename T>
+__device__ char* get_cpu_buffer_address(int32x4_t wave_buffer_resource,
+                                        index_t thread_addr_offset,
+                                        index_t wave_addr_offset,
+                                        index_t access_byte)
+{
+    BufferResource<T> resource;
+
+    resource.content = wave_buffer_resource;
+
+    const uint32_t range  = resource.range(Number<2>{});
+    const uint32_t offset = static_cast<uint32_t>(thread_addr_offset) + wave_addr_offset;
+
+    if(static_cast<uint64_t>(offset) + access_byte > range)
+        return nullptr;
+
+    return c_style_pointer_cast<char*>(resource.address(Number<0>{})) + offset;
+}
+
+template <typename T>
+__device__ void cpu_atomic_add(T* p, T x)
+{
+    if constexpr(std::is_integral<T>::value)
+    {
+        __atomic_fetch_add(p, x, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        T old_value;
+        T new_value;
+
+        __atomic_load(p, &old_value, __ATOMIC_RELAXED);
+
+        do
+        {
+            new_value = old_value + x;
+        } while(!__atomic_compare_exchange(
+            p, &old_value, &new_value, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    }
+}
+
+template <typename T, index_t N>
+__device__ typename vector_type<T, N>::type amd_buffer_load_impl(int32x4_t src_wave_buffer_resource,
+                                                                 index_t src_thread_addr_offset,
+                                                                 index_t src_wave_addr_offset)
+{
+    using vector_t = typename vector_type<T, N>::type;
+
+    vector_t tmp{};
+
+    if(const char* p = get_cpu_buffer_address<T>(src_wave_buffer_resource,
+                                                 src_thread_addr_offset,
+                                                 src_wave_addr_offset,
+                                                 sizeof(vector_t)))
+    {
+        __builtin_memcpy(&tmp, p, sizeof(vector_t));
+    }
+
+    return tmp;
+}
+
+template <typename T, index_t N>
+__device__ void amd_buffer_store_impl(const typename vector_type<T, N>::type src_thread_data,
+                                      int32x4_t dst_wave_buffer_resource,
+                                      index_t dst_thread_addr_offset,
+                                      index_t dst_wave_addr_offset)
+{
+    using vector_t = typename vector_type<T, N>::type;
+
+    if(char* p = get_cpu_buffer_address<T>(dst_wave_buffer_resource,
+                                           dst_thread_addr_offset,
+                                           dst_wave_addr_offset,
+                                           sizeof(vector_t)))
+    {
+        __builtin_memcpy(p, &src_thread_data, sizeof(vector_t));
+    }
+}
+
+// atomic per element, as the hardware
+template <typename T, index_t N>
+__device__ void amd_buffer_atomic_add_impl(const typename vector_type<T, N>::type src_thread_data,
+                                           int32x4_t dst_wave_buffer_resource,
+                                           index_t dst_thread_addr_offset,
+                                           index_t dst_wave_addr_offset)
+{
+    static_assert(is_same<T, float>::value || is_same<T, int32_t>::value,
+                  "wrong! not implemented");
+
+    T src[N];
+
+    __builtin_memcpy(src, &src_thread_data, sizeof(src));
+
+    for(index_t i = 0; i < N; ++i)
+    {
+        if(char* p = get_cpu_buffer_address<T>(dst_wave_buffer_resource,
+                                               dst_thread_addr_offset,
+                                               dst_wave_addr_offset + i * sizeof(T),
+                                               sizeof(T)))
+        {
+            cpu_atomic_add(c_style_pointer_cast<T*>(p), src[i]);
+        }
+    }
+}
+#else
 // load
 __device__ int8_t
 llvm_amdgcn_raw_buffer_load_i8(int32x4_t srsrc,
@@ -762,6 +871,8 @@ __device__ void amd_buffer_atomic_add_impl(const typename vector_type<T, N>::typ
     }
 }
 
+#endif
+
 // buffer_load requires:
 //   1) p_src_wave must point to global memory space
 //   2) p_src_wave must be a wavewise pointer.
@@ -792,7 +903,7 @@ amd_buffer_load_invalid_element_return_return_zero(const T* p_src_wave,
     vector_t tmp = amd_buffer_load_impl<scalar_t, vector_size>(
         src_wave_buffer_resource, src_thread_addr_offset, 0);
 
-    return src_thread_element_valid ? tmp : vector_t(0);
+    return src_thread_element_valid ? tmp : vector_t{0};
 #endif
 }
 
@@ -821,7 +932,12 @@ amd_buffer_load_invalid_element_return_customized_value(const T* p_src_wave,
     vector_t tmp = amd_buffer_load_impl<scalar_t, vector_size>(
         src_wave_buffer_resource, src_thread_addr_offset, 0);
 
+#ifdef CK_CPU_TARGET
+    // a GCC vector has no splat constructor, but splats a scalar operand
+    return src_thread_element_valid ? tmp : vector_t{} + customized_value;
+#else
     return src_thread_element_valid ? tmp : vector_t(customized_value);
+#endif
 }
 
 // buffer_store requires:
@@ -20,19 +20,23 @@
 #include "number.hpp"
 #include "sequence.hpp"
 #include "sequence_helper.hpp"
-#include "synchronization.hpp"
 #include "tuple.hpp"
 #include "tuple_helper.hpp"
 #include "type.hpp"
 #include "magic_division.hpp"
-#include "utility.hpp"
 #include "c_style_pointer_cast.hpp"
 #include "amd_address_space.hpp"
+
+// work-item ids, synchronization, buffers and vector instructions, which the CPU target emulates
+#if CK_HAS_VECTOR_TYPE
+#include "synchronization.hpp"
+#include "utility.hpp"
 #include "amd_buffer_addressing.hpp"
 #include "static_buffer.hpp"
 #include "dynamic_buffer.hpp"
 
 #include "inner_product.hpp"
+#endif
 
 // TODO: remove this
 #if CK_USE_AMD_INLINE_ASM
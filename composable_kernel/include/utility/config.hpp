@@ -1,19 +1,104 @@
 #ifndef CK_CONFIG_AMD_HPP
 #define CK_CONFIG_AMD_HPP
 
+// CPU target: host-only build with a plain C++ compiler and no HIP runtime, for host code that
+// uses the descriptor algebra (Sequence, Tuple, TensorDescriptor, TensorAdaptor and the
+// multi-index transforms). Device-only headers are left out of common_header.hpp.
+#if defined(CK_CPU_TARGET) && !defined(MIOPEN_DONT_USE_HIP_RUNTIME_HEADERS)
+#define MIOPEN_DONT_USE_HIP_RUNTIME_HEADERS
+#endif
+
 #ifndef MIOPEN_DONT_USE_HIP_RUNTIME_HEADERS
 #include "hip/hip_runtime.h"
 #include "hip/hip_fp16.h"
 #endif
+
+#ifdef CK_CPU_TARGET
+// what hip_runtime.h would otherwise bring in
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <sys/types.h>
+
+#ifndef __host__
+#define __host__
+#endif
+#ifndef __device__
+#define __device__
+#endif
+#ifndef __global__
+#define __global__
+#endif
+#ifndef __launch_bounds__
+#define __launch_bounds__(...)
+#endif
+
+// the work-items of a workgroup run as fibers on one host thread (cpu_work_group.hpp), so a
+// thread_local variable is the LDS of the one workgroup running on that thread. Aligned for the
+// widest vector access
+#ifndef __shared__
+#define __shared__ alignas(64) static thread_local
+#endif
+
+// a wavefront-uniform value is just the value
+#define __builtin_amdgcn_readfirstlane(x) (x)
+
+// bfloat16 conversions, as bfloat16_dev.hpp
+inline float bfloat16_to_float(ushort src_val)
+{
+    const uint32_t u = static_cast<uint32_t>(src_val) << 16;
+
+    float f;
+    __builtin_memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+inline ushort float_to_bfloat16(float src_val)
+{
+    uint32_t u;
+    __builtin_memcpy(&u, &src_val, sizeof(u));
+
+    if((~u & 0x7f800000) == 0)
+    {
+        // Inf or NaN, preserve signaling NaN
+        if((u & 0xffff) != 0)
+            u |= 0x10000;
+    }
+    else
+    {
+#ifdef MIOPEN_USE_RNE_BFLOAT16
+        u += 0x7fff + ((u >> 16) & 1);
+#endif
+    }
+
+    return static_cast<ushort>(u >> 16);
+}
+#else
 #include "bfloat16_dev.hpp"
+#endif
 
 // "Constant" address space for kernel parameter
+#ifdef CK_CPU_TARGET
+#define CONSTANT
+#else
 #define CONSTANT __attribute__((address_space(4)))
+#endif
+
+// vector types, and the buffers and kernels built on them, need _Float16 on the CPU target
+#if !defined(CK_CPU_TARGET) || defined(__FLT16_MAX__)
+#define CK_HAS_VECTOR_TYPE 1
+#else
+#define CK_HAS_VECTOR_TYPE 0
+#endif
 
 // GPU target
-// should enable one and only one GPU target
+// should enable one and only one GPU target, or the CPU target
 #if !(defined(CK_AMD_GPU_GFX803) || defined(CK_AMD_GPU_GFX900) || defined(CK_AMD_GPU_GFX906) || \
-      defined(CK_AMD_GPU_GFX908) || defined(CK_AMD_GPU_GFX90A) || defined(CK_AMD_GPU_GFX1030))
+      defined(CK_AMD_GPU_GFX908) || defined(CK_AMD_GPU_GFX90A) || defined(CK_AMD_GPU_GFX1030) || \
+      defined(CK_CPU_TARGET))
 #error Need to define (only) one GPU target
 #endif
 
@@ -31,6 +116,8 @@
 #define CK_BUFFER_RESOURCE_3RD_DWORD 0x00020000
 #elif defined(CK_AMD_GPU_GFX1030)
 #define CK_BUFFER_RESOURCE_3RD_DWORD 0x31014000
+#elif defined(CK_CPU_TARGET)
+#define CK_BUFFER_RESOURCE_3RD_DWORD 0
 #endif
 
 // FMA instruction
@@ -46,6 +133,13 @@
 // multi index
 #define CK_USE_DYNAMICALLY_INDEXED_MULTI_INDEX 0
 
+// no AMD instructions on the CPU target, buffer addressing is emulated (amd_buffer_addressing.hpp)
+#ifdef CK_CPU_TARGET
+#define CK_USE_AMD_INLINE_ASM 0
+#define CK_USE_AMD_INNER_PRODUCT_INLINE_ASM 0
+#define CK_USE_AMD_XDLOPS 0
+#endif
+
 // AMD inline asm
 #ifndef CK_USE_AMD_INLINE_ASM
 #define CK_USE_AMD_INLINE_ASM 1
@@ -96,6 +190,18 @@
 // merge transformation use magic number division
 #define CK_EXPERIMENTAL_MERGE_USE_MAGIC_DIVISION 0
 
+// make_merge_transform_auto pick the merge transformation by its cost table, otherwise it is
+// make_merge_transform
+#ifndef CK_EXPERIMENTAL_MERGE_TRANSFORM_AUTO
+#define CK_EXPERIMENTAL_MERGE_TRANSFORM_AUTO 0
+#endif
+
+// tensor descriptor flatten the affine transforms at the bottom of the transformation chain into
+// one affine map from the hidden indices on top of them to the offset
+#ifndef CK_EXPERIMENTAL_TENSOR_DESCRIPTOR_FLATTEN_AFFINE_TRANSFORMS
+#define CK_EXPERIMENTAL_TENSOR_DESCRIPTOR_FLATTEN_AFFINE_TRANSFORMS 0
+#endif
+
 // hack: have underlying assumption that need to be satsified, otherwise it's a bug
 // hack for forcing register to keep idx_diff_low_const in SGPR. idx_diff_low_const must be
 // thread-invariant, otherwise it's a bug
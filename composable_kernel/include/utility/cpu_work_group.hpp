@@ -0,0 +1,220 @@
+#ifndef CK_CPU_WORK_GROUP_HPP
+#define CK_CPU_WORK_GROUP_HPP
+
+#include "config.hpp"
+
+#include <exception>
+#include <stdexcept>
+#include <vector>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+namespace ck {
+
+// CPU target: one workgroup, run by one host thread. Its work-items are fibers that the host
+// thread runs in turn, each until it reaches a barrier or returns. A barrier is passed once every
+// work-item that has not returned waits at it, so the work-items go through the barriers together
+// as they do on the GPU. get_thread_local_1d_id() and get_block_1d_id() read the ids set by the
+// scheduler before it switches to a work-item.
+struct CpuWorkGroup
+{
+    // stack of each work-item, where the thread private buffers of the kernel live
+    static constexpr std::size_t StackByte = 256 * 1024;
+
+    // the workgroup of this host thread
+    static CpuWorkGroup& GetInstance()
+    {
+        static thread_local CpuWorkGroup work_group;
+
+        return work_group;
+    }
+
+    CpuWorkGroup(const CpuWorkGroup&) = delete;
+    CpuWorkGroup& operator=(const CpuWorkGroup&) = delete;
+
+    ~CpuWorkGroup()
+    {
+        if(p_stacks_ != nullptr)
+            munmap(p_stacks_, stacks_byte_);
+    }
+
+    index_t GetThreadId() const { return thread_id_; }
+
+    index_t GetBlockId() const { return block_id_; }
+
+    index_t GetBlockSize() const { return block_size_; }
+
+    index_t GetGridSize() const { return grid_size_; }
+
+    // run kernel() as every work-item of workgroup block_id, and return when all of them returned.
+    // An exception thrown by a work-item stops the workgroup and is rethrown here, the other
+    // work-items are abandoned without unwinding their stacks
+    template <typename F>
+    void Run(index_t block_id, index_t block_size, index_t grid_size, F& kernel)
+    {
+        if(is_running_)
+            throw std::runtime_error("wrong! workgroup is already running on this thread");
+
+        block_id_   = block_id;
+        block_size_ = block_size;
+        grid_size_  = grid_size;
+        thread_id_  = 0;
+
+        // a single work-item never waits for anyone
+        if(block_size == 1)
+        {
+            kernel();
+            return;
+        }
+
+        p_kernel_   = &kernel;
+        run_kernel_ = [](void* p) { (*static_cast<F*>(p))(); };
+
+        AllocateStacks(block_size);
+
+        work_items_.resize(block_size);
+
+        for(index_t i = 0; i < block_size; ++i)
+        {
+            auto& work_item = work_items_[i];
+
+            getcontext(&work_item.context);
+
+            work_item.context.uc_stack.ss_sp   = GetStack(i);
+            work_item.context.uc_stack.ss_size = StackByte;
+            work_item.context.uc_link          = &scheduler_context_;
+
+            makecontext(&work_item.context, &CpuWorkGroup::WorkItemEntry, 0);
+
+            work_item.is_done = false;
+        }
+
+        is_running_ = true;
+
+        index_t num_done = 0;
+
+        // each round takes every work-item that has not returned to its next barrier
+        while(num_done < block_size)
+        {
+            for(index_t i = 0; i < block_size; ++i)
+            {
+                if(work_items_[i].is_done)
+                    continue;
+
+                thread_id_ = i;
+
+                swapcontext(&scheduler_context_, &work_items_[i].context);
+
+                if(p_exception_)
+                {
+                    is_running_ = false;
+
+                    std::exception_ptr p_exception = p_exception_;
+                    p_exception_                   = nullptr;
+
+                    std::rethrow_exception(p_exception);
+                }
+
+                if(work_items_[i].is_done)
+                    ++num_done;
+            }
+        }
+
+        is_running_ = false;
+    }
+
+    // block-wide barrier, called by a work-item
+    void Barrier()
+    {
+        if(is_running_)
+            swapcontext(&work_items_[thread_id_].context, &scheduler_context_);
+    }
+
+    private:
+    CpuWorkGroup() = default;
+
+    struct WorkItem
+    {
+        ucontext_t context;
+        bool is_done;
+    };
+
+    static void WorkItemEntry()
+    {
+        auto& work_group = GetInstance();
+
+        try
+        {
+            work_group.run_kernel_(work_group.p_kernel_);
+        }
+        catch(...)
+        {
+            work_group.p_exception_ = std::current_exception();
+        }
+
+        work_group.work_items_[work_group.thread_id_].is_done = true;
+
+        // returning switches to uc_link, the scheduler
+    }
+
+    // one mapping for all stacks, with an inaccessible page below each stack to catch overflow
+    void AllocateStacks(index_t num_stack)
+    {
+        if(num_stack <= num_stack_)
+            return;
+
+        if(p_stacks_ != nullptr)
+            munmap(p_stacks_, stacks_byte_);
+
+        const std::size_t page_byte = sysconf(_SC_PAGESIZE);
+
+        stack_stride_ = StackByte + page_byte;
+        stacks_byte_  = stack_stride_ * num_stack;
+
+        p_stacks_ = static_cast<char*>(
+            mmap(nullptr, stacks_byte_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+        if(p_stacks_ == MAP_FAILED)
+        {
+            p_stacks_    = nullptr;
+            num_stack_   = 0;
+            stacks_byte_ = 0;
+
+            throw std::runtime_error("wrong! cannot allocate work-item stacks");
+        }
+
+        for(index_t i = 0; i < num_stack; ++i)
+            mprotect(GetStack(i), StackByte, PROT_READ | PROT_WRITE);
+
+        num_stack_ = num_stack;
+    }
+
+    char* GetStack(index_t i) const
+    {
+        return p_stacks_ + i * stack_stride_ + (stack_stride_ - StackByte);
+    }
+
+    index_t thread_id_  = 0;
+    index_t block_id_   = 0;
+    index_t block_size_ = 1;
+    index_t grid_size_  = 1;
+
+    bool is_running_ = false;
+
+    void* p_kernel_            = nullptr;
+    void (*run_kernel_)(void*) = nullptr;
+
+    std::exception_ptr p_exception_;
+
+    ucontext_t scheduler_context_;
+    std::vector<WorkItem> work_items_;
+
+    char* p_stacks_           = nullptr;
+    index_t num_stack_        = 0;
+    std::size_t stack_stride_ = 0;
+    std::size_t stacks_byte_  = 0;
+};
+
+} // namespace ck
+#endif
@@ -5,18 +5,156 @@
 
 namespace ck {
 
+#if defined(CK_CPU_TARGET) && !defined(__FLT16_MAX__)
+// fp16 for host compilers without _Float16: IEEE binary16 storage, computing in float
+struct half_t
+{
+    ushort mBits = 0;
+
+    half_t() = default;
+
+    half_t(float x) : mBits(FromFloat(x)) {}
+
+    operator float() const { return ToFloat(mBits); }
+
+    static float ToFloat(ushort h)
+    {
+        const uint32_t sign = uint32_t(h & 0x8000) << 16;
+        const uint32_t expo = (h >> 10) & 0x1f;
+        const uint32_t mant = h & 0x3ff;
+
+        uint32_t bits;
+
+        if(expo == 0x1f)
+        {
+            // inf, NaN
+            bits = sign | 0x7f800000 | (mant << 13);
+        }
+        else if(expo != 0)
+        {
+            bits = sign | ((expo + 112) << 23) | (mant << 13);
+        }
+        else if(mant == 0)
+        {
+            bits = sign;
+        }
+        else
+        {
+            // denormal: normalize
+            uint32_t e = 113;
+            uint32_t m = mant;
+
+            while((m & 0x400) == 0)
+            {
+                m <<= 1;
+                --e;
+            }
+
+            bits = sign | (e << 23) | ((m & 0x3ff) << 13);
+        }
+
+        float f;
+        __builtin_memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    // round to nearest even
+    static ushort FromFloat(float f)
+    {
+        uint32_t bits;
+        __builtin_memcpy(&bits, &f, sizeof(bits));
+
+        const ushort sign = (bits >> 16) & 0x8000;
+        const uint32_t abs_bits = bits & 0x7fffffff;
+
+        // inf, NaN (kept quiet)
+        if(abs_bits >= 0x7f800000)
+            return sign | 0x7c00 |
+                   (abs_bits > 0x7f800000 ? 0x200 | ((abs_bits >> 13) & 0x3ff) : 0);
+
+        // overflows to inf
+        if(abs_bits >= 0x477ff000)
+            return sign | 0x7c00;
+
+        // normal
+        if(abs_bits >= 0x38800000)
+        {
+            const uint32_t r = abs_bits - 0x38000000 + 0xfff + ((abs_bits >> 13) & 1);
+            return sign | (r >> 13);
+        }
+
+        // denormal or zero: the value in units of 2^-24, rounded to nearest even
+        if(abs_bits < 0x33000000)
+            return sign;
+
+        const uint32_t mant  = (abs_bits & 0x7fffff) | 0x800000;
+        const uint32_t shift = 126 - (abs_bits >> 23);
+        const uint32_t half  = 1u << (shift - 1);
+        const uint32_t rest  = mant & ((1u << shift) - 1);
+
+        uint32_t r = mant >> shift;
+
+        if(rest > half || (rest == half && (r & 1)))
+            ++r;
+
+        return sign | r;
+    }
+};
+#else
 using half_t = _Float16;
+#endif
+
+#if CK_HAS_VECTOR_TYPE
+// native vector of N T: clang ext_vector_type on the device, GCC generic vector on the CPU target
+template <typename T, index_t N>
+struct ext_vector
+{
+#ifdef CK_CPU_TARGET
+    typedef T type __attribute__((vector_size(N * sizeof(T))));
+#else
+    typedef T type __attribute__((ext_vector_type(N)));
+#endif
+};
+
+template <typename T, index_t N>
+using ext_vector_t = typename ext_vector<T, N>::type;
+
+#ifdef CK_CPU_TARGET
+// a GCC vector type can't be deduced in a partial specialization, so it is recognized by its
+// subscript instead
+template <typename TV, typename = void>
+struct native_vector_traits
+{
+    static constexpr bool is_vector = false;
+};
+
+template <typename TV>
+struct native_vector_traits<
+    TV,
+    std::enable_if_t<!std::is_class<TV>::value && !std::is_pointer<TV>::value &&
+                         !std::is_array<TV>::value,
+                     std::void_t<decltype(std::declval<TV>()[0])>>>
+{
+    static constexpr bool is_vector = true;
+
+    using scalar_type = std::decay_t<decltype(std::declval<TV>()[0])>;
+
+    static constexpr index_t vector_size = sizeof(TV) / sizeof(scalar_type);
+};
+#endif
 
 // vector_type
 template <typename T, index_t N>
 struct vector_type;
 
+#ifndef CK_CPU_TARGET
 // Caution: DO NOT REMOVE
 // intentionally have only declaration but no definition to cause compilation failure when trying to
 // instantiate this template. The purpose is to catch user's mistake when trying to make "vector of
 // vectors"
 template <typename T, index_t V, index_t N>
 struct vector_type<T __attribute__((ext_vector_type(V))), N>;
+#endif
 
 // Caution: DO NOT REMOVE
 // intentionally have only declaration but no definition to cause compilation failure when trying to
@@ -27,6 +165,20 @@ struct vector_type<vector_type<T, V>, N>;
 
 // vector_type_maker
 // This is the right way to handle "vector of vectors": making a bigger vector instead
+#ifdef CK_CPU_TARGET
+template <typename T, index_t N, typename = void>
+struct vector_type_maker
+{
+    using type = vector_type<T, N>;
+};
+
+template <typename T, index_t N0>
+struct vector_type_maker<T, N0, std::enable_if_t<native_vector_traits<T>::is_vector>>
+{
+    using type = vector_type<typename native_vector_traits<T>::scalar_type,
+                             N0 * native_vector_traits<T>::vector_size>;
+};
+#else
 template <typename T, index_t N>
 struct vector_type_maker
 {
@@ -38,6 +190,7 @@ struct vector_type_maker<T __attribute__((ext_vector_type(N1))), N0>
 {
     using type = vector_type<T, N0 * N1>;
 };
+#endif
 
 template <typename T, index_t N0, index_t N1>
 struct vector_type_maker<vector_type<T, N1>, N0>
@@ -55,6 +208,17 @@ __host__ __device__ constexpr auto make_vector_type(Number<N>)
 }
 
 // scalar_type
+#ifdef CK_CPU_TARGET
+template <typename TV, typename = void>
+struct scalar_type;
+
+template <typename TV>
+struct scalar_type<TV, std::enable_if_t<native_vector_traits<TV>::is_vector>>
+{
+    using type                           = typename native_vector_traits<TV>::scalar_type;
+    static constexpr index_t vector_size = native_vector_traits<TV>::vector_size;
+};
+#else
 template <typename TV>
 struct scalar_type;
 
@@ -64,6 +228,7 @@ struct scalar_type<T __attribute__((ext_vector_type(N)))>
     using type                           = T;
     static constexpr index_t vector_size = N;
 };
+#endif
 
 template <typename T, index_t N>
 struct scalar_type<vector_type<T, N>>
@@ -153,7 +318,7 @@ template <typename T>
 struct vector_type<T, 2>
 {
     using d1_t = T;
-    typedef T d2_t __attribute__((ext_vector_type(2)));
+    using d2_t = ext_vector_t<T, 2>;
 
     using type = d2_t;
 
@@ -203,8 +368,8 @@ template <typename T>
 struct vector_type<T, 4>
 {
     using d1_t = T;
-    typedef T d2_t __attribute__((ext_vector_type(2)));
-    typedef T d4_t __attribute__((ext_vector_type(4)));
+    using d2_t = ext_vector_t<T, 2>;
+    using d4_t = ext_vector_t<T, 4>;
 
     using type = d4_t;
 
@@ -265,9 +430,9 @@ template <typename T>
 struct vector_type<T, 8>
 {
     using d1_t = T;
-    typedef T d2_t __attribute__((ext_vector_type(2)));
-    typedef T d4_t __attribute__((ext_vector_type(4)));
-    typedef T d8_t __attribute__((ext_vector_type(8)));
+    using d2_t = ext_vector_t<T, 2>;
+    using d4_t = ext_vector_t<T, 4>;
+    using d8_t = ext_vector_t<T, 8>;
 
     using type = d8_t;
 
@@ -339,10 +504,10 @@ template <typename T>
 struct vector_type<T, 16>
 {
     using d1_t = T;
-    typedef T d2_t __attribute__((ext_vector_type(2)));
-    typedef T d4_t __attribute__((ext_vector_type(4)));
-    typedef T d8_t __attribute__((ext_vector_type(8)));
-    typedef T d16_t __attribute__((ext_vector_type(16)));
+    using d2_t = ext_vector_t<T, 2>;
+    using d4_t = ext_vector_t<T, 4>;
+    using d8_t = ext_vector_t<T, 8>;
+    using d16_t = ext_vector_t<T, 16>;
 
     using type = d16_t;
 
@@ -425,11 +590,11 @@ template <typename T>
 struct vector_type<T, 32>
 {
     using d1_t = T;
-    typedef T d2_t __attribute__((ext_vector_type(2)));
-    typedef T d4_t __attribute__((ext_vector_type(4)));
-    typedef T d8_t __attribute__((ext_vector_type(8)));
-    typedef T d16_t __attribute__((ext_vector_type(16)));
-    typedef T d32_t __attribute__((ext_vector_type(32)));
+    using d2_t = ext_vector_t<T, 2>;
+    using d4_t = ext_vector_t<T, 4>;
+    using d8_t = ext_vector_t<T, 8>;
+    using d16_t = ext_vector_t<T, 16>;
+    using d32_t = ext_vector_t<T, 32>;
 
     using type = d32_t;
 
@@ -521,12 +686,12 @@ template <typename T>
 struct vector_type<T, 64>
 {
     using d1_t = T;
-    typedef T d2_t __attribute__((ext_vector_type(2)));
-    typedef T d4_t __attribute__((ext_vector_type(4)));
-    typedef T d8_t __attribute__((ext_vector_type(8)));
-    typedef T d16_t __attribute__((ext_vector_type(16)));
-    typedef T d32_t __attribute__((ext_vector_type(32)));
-    typedef T d64_t __attribute__((ext_vector_type(64)));
+    using d2_t = ext_vector_t<T, 2>;
+    using d4_t = ext_vector_t<T, 4>;
+    using d8_t = ext_vector_t<T, 8>;
+    using d16_t = ext_vector_t<T, 16>;
+    using d32_t = ext_vector_t<T, 32>;
+    using d64_t = ext_vector_t<T, 64>;
 
     using type = d64_t;
 
@@ -629,13 +794,13 @@ template <typename T>
 struct vector_type<T, 128>
 {
     using d1_t = T;
-    typedef T d2_t __attribute__((ext_vector_type(2)));
-    typedef T d4_t __attribute__((ext_vector_type(4)));
-    typedef T d8_t __attribute__((ext_vector_type(8)));
-    typedef T d16_t __attribute__((ext_vector_type(16)));
-    typedef T d32_t __attribute__((ext_vector_type(32)));
-    typedef T d64_t __attribute__((ext_vector_type(64)));
-    typedef T d128_t __attribute__((ext_vector_type(128)));
+    using d2_t = ext_vector_t<T, 2>;
+    using d4_t = ext_vector_t<T, 4>;
+    using d8_t = ext_vector_t<T, 8>;
+    using d16_t = ext_vector_t<T, 16>;
+    using d32_t = ext_vector_t<T, 32>;
+    using d64_t = ext_vector_t<T, 64>;
+    using d128_t = ext_vector_t<T, 128>;
 
     using type = d128_t;
 
@@ -747,14 +912,14 @@ template <typename T>
 struct vector_type<T, 256>
 {
     using d1_t = T;
-    typedef T d2_t __attribute__((ext_vector_type(2)));
-    typedef T d4_t __attribute__((ext_vector_type(4)));
-    typedef T d8_t __attribute__((ext_vector_type(8)));
-    typedef T d16_t __attribute__((ext_vector_type(16)));
-    typedef T d32_t __attribute__((ext_vector_type(32)));
-    typedef T d64_t __attribute__((ext_vector_type(64)));
-    typedef T d128_t __attribute__((ext_vector_type(128)));
-    typedef T d256_t __attribute__((ext_vector_type(256)));
+    using d2_t = ext_vector_t<T, 2>;
+    using d4_t = ext_vector_t<T, 4>;
+    using d8_t = ext_vector_t<T, 8>;
+    using d16_t = ext_vector_t<T, 16>;
+    using d32_t = ext_vector_t<T, 32>;
+    using d64_t = ext_vector_t<T, 64>;
+    using d128_t = ext_vector_t<T, 128>;
+    using d256_t = ext_vector_t<T, 256>;
 
     using type = d256_t;
 
@@ -915,6 +1080,8 @@ using int8x16_t = typename vector_type<int8_t, 16>::type;
 using int8x32_t = typename vector_type<int8_t, 32>::type;
 using int8x64_t = typename vector_type<int8_t, 64>::type;
 
+#endif
+
 // data type conversion
 template <typename T>
 struct type_convert
@@ -928,18 +1095,19 @@ struct type_convert
 
 template <>
 template <>
-__device__ float type_convert<float>::operator()<ushort>(ushort x) const
+inline __device__ float type_convert<float>::operator()<ushort>(ushort x) const
 {
     return bfloat16_to_float(x);
 }
 
 template <>
 template <>
-__device__ ushort type_convert<ushort>::operator()<float>(float x) const
+inline __device__ ushort type_convert<ushort>::operator()<float>(float x) const
 {
     return float_to_bfloat16(x);
 }
 
+#ifndef CK_CPU_TARGET
 // TODO: deprecate this
 template <typename T>
 struct inner_product_with_conversion
@@ -1007,6 +1175,8 @@ struct inner_product_with_conversion
     }
 };
 
+#endif
+
 template <typename T>
 struct NumericLimits
 {
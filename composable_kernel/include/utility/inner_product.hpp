@@ -9,7 +9,7 @@ template <typename TA, typename TB, typename TC>
 __device__ void inner_product(const TA& a, const TB& b, TC& c);
 
 template <>
-__device__ void inner_product<float, float, float>(const float& a, const float& b, float& c)
+inline __device__ void inner_product<float, float, float>(const float& a, const float& b, float& c)
 {
 #if CK_USE_AMD_INNER_PRODUCT_INLINE_ASM && defined(CK_USE_AMD_V_MAC_F32)
     asm volatile("\n \
@@ -29,7 +29,7 @@ __device__ void inner_product<float, float, float>(const float& a, const float&
 }
 
 template <>
-__device__ void
+inline __device__ void
 inner_product<float2_t, float2_t, float>(const float2_t& a, const float2_t& b, float& c)
 {
     constexpr auto I0 = Number<0>{};
@@ -45,7 +45,7 @@ inner_product<float2_t, float2_t, float>(const float2_t& a, const float2_t& b, f
 }
 
 template <>
-__device__ void
+inline __device__ void
 inner_product<float4_t, float4_t, float>(const float4_t& a, const float4_t& b, float& c)
 {
     constexpr auto I0 = Number<0>{};
@@ -71,7 +71,8 @@ inner_product<float4_t, float4_t, float>(const float4_t& a, const float4_t& b, f
 }
 
 template <>
-__device__ void inner_product<half2_t, half2_t, float>(const half2_t& a, const half2_t& b, float& c)
+inline __device__ void
+inner_product<half2_t, half2_t, float>(const half2_t& a, const half2_t& b, float& c)
 {
 #if defined(CK_USE_AMD_V_DOT2_F32_F16)
 #if CK_USE_AMD_INNER_PRODUCT_INLINE_ASM
@@ -84,7 +85,7 @@ __device__ void inner_product<half2_t, half2_t, float>(const half2_t& a, const h
     c = __builtin_amdgcn_sdot2(a, b, c, false);
 #endif
 #else
-    const auto convert = type_convert<int32_t>{};
+    const auto convert = type_convert<float>{};
 
     const vector_type<half_t, 2> a_vector{a};
     const vector_type<half_t, 2> b_vector{b};
@@ -96,7 +97,8 @@ __device__ void inner_product<half2_t, half2_t, float>(const half2_t& a, const h
 }
 
 template <>
-__device__ void inner_product<half4_t, half4_t, float>(const half4_t& a, const half4_t& b, float& c)
+inline __device__ void
+inner_product<half4_t, half4_t, float>(const half4_t& a, const half4_t& b, float& c)
 {
     constexpr auto I0 = Number<0>{};
     constexpr auto I1 = Number<1>{};
@@ -111,7 +113,8 @@ __device__ void inner_product<half4_t, half4_t, float>(const half4_t& a, const h
 }
 
 template <>
-__device__ void inner_product<half8_t, half8_t, float>(const half8_t& a, const half8_t& b, float& c)
+inline __device__ void
+inner_product<half8_t, half8_t, float>(const half8_t& a, const half8_t& b, float& c)
 {
     constexpr auto I0 = Number<0>{};
     constexpr auto I1 = Number<1>{};
@@ -136,7 +139,7 @@ __device__ void inner_product<half8_t, half8_t, float>(const half8_t& a, const h
 }
 
 template <>
-__device__ void
+inline __device__ void
 inner_product<int8x4_t, int8x4_t, int32_t>(const int8x4_t& a, const int8x4_t& b, int32_t& c)
 {
 #if defined(CK_USE_DOT4_I32_I8)
@@ -162,7 +165,7 @@ inner_product<int8x4_t, int8x4_t, int32_t>(const int8x4_t& a, const int8x4_t& b,
 }
 
 template <>
-__device__ void
+inline __device__ void
 inner_product<int8x8_t, int8x8_t, int32_t>(const int8x8_t& a, const int8x8_t& b, int32_t& c)
 {
     constexpr auto I0 = Number<0>{};
@@ -178,7 +181,7 @@ inner_product<int8x8_t, int8x8_t, int32_t>(const int8x8_t& a, const int8x8_t& b,
 }
 
 template <>
-__device__ void
+inline __device__ void
 inner_product<int8x16_t, int8x16_t, int32_t>(const int8x16_t& a, const int8x16_t& b, int32_t& c)
 {
     constexpr auto I0 = Number<0>{};
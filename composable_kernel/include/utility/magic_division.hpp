@@ -10,22 +10,21 @@
 namespace ck {
 
 // magic number division
-// Caution:
-//   1. For uint32_t as dividend: magic number division implementation being used would produce
-//   correct result if the dividend is uint32_t and its value is within 31-bit value range.
-//   2. For int32_t as dividendd: magic number division for int32_t dividened has not been
-//   implemented, the int32_t dividend would be bit-wise interpreted as uint32_t and magic number
-//   division implementation for uint32_t is then used. Therefore, dividend value need to be
-//   non-negative.
-// TODO:
-//   1. Implement magic number divison for int32_t
-//   2. Implement magic number divison for unit32_t with 32-bit value range
+// For a divisor d in [1, 2^32 - 1], shift s = ceil(log2(d)) and multiplier m =
+// 2^32 * (2^s - d) / d + 1, so that n / d = (n * (2^32 + m)) >> (32 + s), with a 33-bit
+// multiplier 2^32 + m. With t = (n * m) >> 32 this is (t + n) >> s, but t + n takes 33 bits:
+//   1. DoMagicDivision(uint32_t) does the extra add/shift (t + ((n - t) >> 1)) >> (s - 1), and is
+//   correct for all uint32_t dividends.
+//   2. DoMagicDivisionNonNegative(int32_t) does (t + n) >> s, and is correct for dividends in
+//   [0, 2^31 - 1] and divisors in [1, 2^31 - 1]. This is the one for index calculation.
+//   3. DoMagicDivision(int32_t) rounds down (toward negative infinity, unlike operator/), and
+//   DoMagicDivisionCeil rounds up. For int32_t the divisor need to be in [1, 2^31 - 1]
 struct MagicDivision
 {
     // uint32_t
     __host__ __device__ static constexpr auto CalculateMagicNumbers(uint32_t divisor)
     {
-        // assert(divisior >= 1 && divisior <= INT32_MAX);
+        // assert(divisor >= 1);
         uint32_t shift = 0;
         for(shift = 0; shift < 32; ++shift)
         {
@@ -36,8 +35,8 @@ struct MagicDivision
         }
 
         uint64_t one        = 1;
+        // 2^s - d < d, so it is less than 2^32
         uint64_t multiplier = ((one << 32) * ((one << shift) - divisor)) / divisor + 1;
-        // assert(multiplier <= 0xffffffffUL);
 
         return make_tuple(uint32_t(multiplier), shift);
     }
@@ -110,25 +109,72 @@ struct MagicDivision
         return CalculateMagicShift(integral_constant<uint32_t, Divisor>{});
     }
 
-    // magic division for uint32_t
+    // high 32 bits of the 64-bit product
+    __host__ __device__ static constexpr uint32_t MultiplyHigh(uint32_t a, uint32_t b)
+    {
+#if defined(__HIP_DEVICE_COMPILE__)
+        return __umulhi(a, b);
+#else
+        return static_cast<uint32_t>((static_cast<uint64_t>(a) * b) >> 32);
+#endif
+    }
+
+    // magic division for uint32_t, rounding down
     __host__ __device__ static constexpr uint32_t
     DoMagicDivision(uint32_t dividend, uint32_t multiplier, uint32_t shift)
     {
-        uint32_t tmp = __umulhi(dividend, multiplier);
-        return (tmp + dividend) >> shift;
+        uint32_t tmp = MultiplyHigh(dividend, multiplier);
+
+        // (tmp + dividend) >> shift without the carry out of 32 bits. shift is 0 only for divisor
+        // 1, where tmp is 0
+        uint32_t shift1 = shift > 0 ? 1 : 0;
+
+        return (tmp + ((dividend - tmp) >> shift1)) >> (shift - shift1);
     }
 
-    // magic division for int32_t
-    // HACK: use dividend_i32 as if it's uint32_t, dividend_i32 need to be
-    // non-negative for result to be correct
-    // TODO: figure out how to do magic number divison for int32_t as dividended
+    // magic division for uint32_t, rounding up
+    __host__ __device__ static constexpr uint32_t
+    DoMagicDivisionCeil(uint32_t dividend, uint32_t multiplier, uint32_t shift)
+    {
+        return dividend == 0 ? 0 : DoMagicDivision(dividend - 1, multiplier, shift) + 1;
+    }
+
+    // magic division for int32_t in [0, 2^31 - 1], rounding down
     __host__ __device__ static constexpr int32_t
-    DoMagicDivision(int32_t dividend_i32, uint32_t multiplier, uint32_t shift)
+    DoMagicDivisionNonNegative(int32_t dividend_i32, uint32_t multiplier, uint32_t shift)
     {
         uint32_t dividend_u32 = as_type<uint32_t>(dividend_i32);
-        uint32_t tmp          = __umulhi(dividend_u32, multiplier);
+        uint32_t tmp          = MultiplyHigh(dividend_u32, multiplier);
         return (tmp + dividend_u32) >> shift;
     }
+
+    // magic division for int32_t, rounding down
+    __host__ __device__ static constexpr int32_t
+    DoMagicDivision(int32_t dividend_i32, uint32_t multiplier, uint32_t shift)
+    {
+        // floor(n / d) = ~floor(~n / d) for negative n, and ~n is non-negative
+        int32_t sign = dividend_i32 >> 31;
+
+        return DoMagicDivisionNonNegative(dividend_i32 ^ sign, multiplier, shift) ^ sign;
+    }
+
+    // magic division for int32_t, rounding up
+    __host__ __device__ static constexpr int32_t
+    DoMagicDivisionCeil(int32_t dividend_i32, uint32_t multiplier, uint32_t shift)
+    {
+        // ceil(n / d) = -floor(-n / d) for non-positive n, where -n can be 2^31. The short
+        // formula is still exact for it, tmp is less than 2^31
+        if(dividend_i32 > 0)
+        {
+            return DoMagicDivisionNonNegative(dividend_i32 - 1, multiplier, shift) + 1;
+        }
+        else
+        {
+            uint32_t dividend_u32 = 0U - as_type<uint32_t>(dividend_i32);
+            uint32_t tmp          = MultiplyHigh(dividend_u32, multiplier);
+            return as_type<int32_t>(0U - ((tmp + dividend_u32) >> shift));
+        }
+    }
 };
 
 } // namespace ck
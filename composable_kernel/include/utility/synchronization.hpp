@@ -3,11 +3,19 @@
 
 #include "config.hpp"
 
+#ifdef CK_CPU_TARGET
+#include "cpu_work_group.hpp"
+
+inline __device__ void __syncthreads() { ck::CpuWorkGroup::GetInstance().Barrier(); }
+#endif
+
 namespace ck {
 
-__device__ void block_sync_lds()
+inline __device__ void block_sync_lds()
 {
-#if CK_BLOCK_SYNC_LDS_WITHOUT_SYNC_VMEM
+#if defined(CK_CPU_TARGET)
+    CpuWorkGroup::GetInstance().Barrier();
+#elif CK_BLOCK_SYNC_LDS_WITHOUT_SYNC_VMEM
     asm volatile("\
     s_waitcnt lgkmcnt(0) \n \
     s_barrier \
@@ -3,11 +3,24 @@
 
 #include "config.hpp"
 
+#ifdef CK_CPU_TARGET
+#include "cpu_work_group.hpp"
+#endif
+
 namespace ck {
 
-__device__ index_t get_thread_local_1d_id() { return threadIdx.x; }
+#ifdef CK_CPU_TARGET
+inline __device__ index_t get_thread_local_1d_id()
+{
+    return CpuWorkGroup::GetInstance().GetThreadId();
+}
 
-__device__ index_t get_block_1d_id() { return blockIdx.x; }
+inline __device__ index_t get_block_1d_id() { return CpuWorkGroup::GetInstance().GetBlockId(); }
+#else
+inline __device__ index_t get_thread_local_1d_id() { return threadIdx.x; }
+
+inline __device__ index_t get_block_1d_id() { return blockIdx.x; }
+#endif
 
 } // namespace ck
 
@@ -35,6 +35,7 @@ void device_convolution_forward_implicit_gemm_v6r1_dlops_nchw_kcyx_nkhw(
     constexpr auto I0 = Number<0>{};
     constexpr auto I1 = Number<1>{};
     constexpr auto I2 = Number<2>{};
+    constexpr auto I3 = Number<3>{};
 
     DeviceMem in_n_c_hi_wi_device_buf(sizeof(TInWei) * in_n_c_hi_wi.mDesc.GetElementSpace());
     DeviceMem wei_k_c_y_x_device_buf(sizeof(TInWei) * wei_k_c_y_x.mDesc.GetElementSpace());
@@ -114,6 +115,9 @@ void device_convolution_forward_implicit_gemm_v6r1_dlops_nchw_kcyx_nkhw(
     constexpr index_t CThreadTransferDstScalarPerVector_BN1 = 1;
 #endif
 
+    // groups, inferred from the channels of the input and the weight as the host references do
+    const index_t G = in_n_c_hi_wi_lengths[I1] / wei_k_c_y_x_lengths[I1];
+
     const auto descs =
         transform_forward_convolution_into_contraction_v6r1_nchw_kcyx_nkhw_pad(wei_desc_k_c_y_x,
                                                                                in_desc_n_c_hi_wi,
@@ -175,17 +179,26 @@ void device_convolution_forward_implicit_gemm_v6r1_dlops_nchw_kcyx_nkhw(
     constexpr auto in_grid_move_slice_window_step_hacks =
         Sequence<0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 2, 0, 0, 0, 0, 0>{};
 
-    for(index_t i = 0; i < 5; ++i)
-    {
-        float ave_time = driver_contraction_dlops_v1r2<
+    const auto f_run_contraction = [&](auto wei_grid_desc,
+                                       auto in_grid_desc,
+                                       auto out_grid_desc,
+                                       auto wei_step_hacks,
+                                       auto in_step_hacks,
+                                       auto out_step_hacks,
+                                       auto wei_move_slice_window_step_hacks,
+                                       auto in_move_slice_window_step_hacks,
+                                       index_t wei_group_stride,
+                                       index_t in_group_stride,
+                                       index_t out_group_stride) {
+        return driver_contraction_dlops_v1r2<
             BlockSize,
             TInWei,
             TAcc,
             TOut,
             InMemoryDataOperationEnum_t::Set,
-            decltype(wei_grid_desc_gk0_gm0_gm1_gk1),
-            decltype(in_grid_desc_gk0_gn0_gn1_gk1),
-            decltype(out_grid_desc_gm0_gm1_gn0_gn1),
+            decltype(wei_grid_desc),
+            decltype(in_grid_desc),
+            decltype(out_grid_desc),
             GM1PerBlockGM11,
             GN1PerBlockGN11,
             GK0PerBlock,
@@ -211,23 +224,85 @@ void device_convolution_forward_implicit_gemm_v6r1_dlops_nchw_kcyx_nkhw(
             Sequence<3, 4, 5, 0, 1, 2>, // CThreadTransferSrcDstAccessOrder
             5,                          // CThreadTransferSrcDstVectorDim
             CThreadTransferDstScalarPerVector_BN1,
-            decltype(wei_grid_step_hacks),
-            decltype(in_grid_step_hacks),
-            decltype(out_grid_step_hacks),
-            decltype(wei_grid_move_slice_window_step_hacks),
-            decltype(in_grid_move_slice_window_step_hacks)>(
+            decltype(wei_step_hacks),
+            decltype(in_step_hacks),
+            decltype(out_step_hacks),
+            decltype(wei_move_slice_window_step_hacks),
+            decltype(in_move_slice_window_step_hacks)>(
             static_cast<TInWei*>(wei_k_c_y_x_device_buf.GetDeviceBuffer()),
             static_cast<TInWei*>(in_n_c_hi_wi_device_buf.GetDeviceBuffer()),
             static_cast<TOut*>(out_n_k_ho_wo_device_buf.GetDeviceBuffer()),
-            wei_grid_desc_gk0_gm0_gm1_gk1,
-            in_grid_desc_gk0_gn0_gn1_gk1,
-            out_grid_desc_gm0_gm1_gn0_gn1,
-            wei_grid_step_hacks,
-            in_grid_step_hacks,
-            out_grid_step_hacks,
-            wei_grid_move_slice_window_step_hacks,
-            in_grid_move_slice_window_step_hacks,
+            wei_grid_desc,
+            in_grid_desc,
+            out_grid_desc,
+            wei_step_hacks,
+            in_step_hacks,
+            out_step_hacks,
+            wei_move_slice_window_step_hacks,
+            in_move_slice_window_step_hacks,
+            G,
+            wei_group_stride,
+            in_group_stride,
+            out_group_stride,
             nrepeat);
+    };
+
+    for(index_t i = 0; i < 5; ++i)
+    {
+        float ave_time = 0;
+
+        if(G == 1)
+        {
+            ave_time = f_run_contraction(wei_grid_desc_gk0_gm0_gm1_gk1,
+                                         in_grid_desc_gk0_gn0_gn1_gk1,
+                                         out_grid_desc_gm0_gm1_gn0_gn1,
+                                         wei_grid_step_hacks,
+                                         in_grid_step_hacks,
+                                         out_grid_step_hacks,
+                                         wei_grid_move_slice_window_step_hacks,
+                                         in_grid_move_slice_window_step_hacks,
+                                         0,
+                                         0,
+                                         0);
+        }
+        else
+        {
+            // the descriptors of group 0, group g reads and writes the channels of its group at
+            // g group strides past it, all groups run in one launch. Only this NCHW transform has a
+            // grouped variant, the drivers reject groups for the other algorithms
+            const auto grouped_descs =
+                transform_forward_convolution_into_contraction_v6r1_nchw_kcyx_nkhw_grouped_pad(
+                    wei_desc_k_c_y_x,
+                    in_desc_n_c_hi_wi,
+                    out_desc_n_k_ho_wo,
+                    conv_strides,
+                    conv_dilations,
+                    in_left_pads,
+                    in_right_pads,
+                    Number<GN0>{},
+                    Number<GK1>{},
+                    G,
+                    0);
+
+            // K and C per group, of the weight, times the spatial lengths of each tensor
+            const index_t KPerGroup = wei_k_c_y_x_lengths[I0] / G;
+            const index_t CPerGroup = wei_k_c_y_x_lengths[I1];
+
+            // the grouped descriptors freeze the group and unmerge K and C by group, which the
+            // hacks above do not cover: no hacks for them
+            ave_time = f_run_contraction(
+                grouped_descs[I0],
+                grouped_descs[I1],
+                grouped_descs[I2],
+                Tuple<>{},
+                Tuple<>{},
+                Tuple<>{},
+                Sequence<>{},
+                Sequence<>{},
+                KPerGroup * CPerGroup * wei_k_c_y_x_lengths[I2] * wei_k_c_y_x_lengths[I3],
+                CPerGroup * in_n_c_hi_wi_lengths[I2] * in_n_c_hi_wi_lengths[I3],
+                KPerGroup * out_n_k_ho_wo_lengths[I2] * out_n_k_ho_wo_lengths[I3]);
+        }
 
         float perf = static_cast<float>(calculate_convolution_flops(
                          in_desc_n_c_hi_wi, wei_desc_k_c_y_x, out_desc_n_k_ho_wo)) /
@@ -56,6 +56,10 @@ driver_contraction_dlops_v1r2(const FloatAB* p_a_grid,
                               CGridStepHacks,
                               AGridMoveSliceWindowStepHacks,
                               BGridMoveSliceWindowStepHacks,
+                              ck::index_t num_group,
+                              ck::index_t a_grid_group_stride,
+                              ck::index_t b_grid_group_stride,
+                              ck::index_t c_grid_group_stride,
                               ck::index_t nrepeat)
 
 {
@@ -143,7 +147,12 @@ driver_contraction_dlops_v1r2(const FloatAB* p_a_grid,
     using CGridBlockCluster_BlockId_To_GM10_GN10 =
         decltype(c_grid_block_cluster_blockid_to_gm10_gn10);
 
-    const index_t grid_size = GridwiseContraction::CalculateGridSize(c_grid_desc_gm0_gm1_gn0_gn1);
+    // the descriptors are of group 0, group g is the same contraction with A, B and C moved by g
+    // group strides, all groups run in one launch
+    const index_t num_block_per_group =
+        GridwiseContraction::CalculateGridSize(c_grid_desc_gm0_gm1_gn0_gn1);
+
+    const index_t grid_size = num_group * num_block_per_group;
 
     const bool has_main_k_block_loop = GridwiseContraction::CalculateHasMainKBlockLoop(GK0);
 
@@ -200,7 +209,11 @@ driver_contraction_dlops_v1r2(const FloatAB* p_a_grid,
                                           a_grid_desc_gk0_gm0_gm10_gm11_gk1,
                                           b_grid_desc_gk0_gn0_gn10_gn11_gk1,
                                           c_grid_desc_gm10_bm0_bm1_gn10_bn0_bn1,
-                                          c_grid_block_cluster_blockid_to_gm10_gn10);
+                                          c_grid_block_cluster_blockid_to_gm10_gn10,
+                                          num_block_per_group,
+                                          a_grid_group_stride,
+                                          b_grid_group_stride,
+                                          c_grid_group_stride);
     }
     else if(has_main_k_block_loop && !has_double_tail_k_block_loop)
     {
@@ -226,7 +239,11 @@ driver_contraction_dlops_v1r2(const FloatAB* p_a_grid,
                                           a_grid_desc_gk0_gm0_gm10_gm11_gk1,
                                           b_grid_desc_gk0_gn0_gn10_gn11_gk1,
                                           c_grid_desc_gm10_bm0_bm1_gn10_bn0_bn1,
-                                          c_grid_block_cluster_blockid_to_gm10_gn10);
+                                          c_grid_block_cluster_blockid_to_gm10_gn10,
+                                          num_block_per_group,
+                                          a_grid_group_stride,
+                                          b_grid_group_stride,
+                                          c_grid_group_stride);
     }
     else if(!has_main_k_block_loop && has_double_tail_k_block_loop)
     {
@@ -252,7 +269,11 @@ driver_contraction_dlops_v1r2(const FloatAB* p_a_grid,
                                           a_grid_desc_gk0_gm0_gm10_gm11_gk1,
                                           b_grid_desc_gk0_gn0_gn10_gn11_gk1,
                                           c_grid_desc_gm10_bm0_bm1_gn10_bn0_bn1,
-                                          c_grid_block_cluster_blockid_to_gm10_gn10);
+                                          c_grid_block_cluster_blockid_to_gm10_gn10,
+                                          num_block_per_group,
+                                          a_grid_group_stride,
+                                          b_grid_group_stride,
+                                          c_grid_group_stride);
     }
     else
     {
@@ -278,7 +299,11 @@ driver_contraction_dlops_v1r2(const FloatAB* p_a_grid,
                                           a_grid_desc_gk0_gm0_gm10_gm11_gk1,
                                           b_grid_desc_gk0_gn0_gn10_gn11_gk1,
                                           c_grid_desc_gm10_bm0_bm1_gn10_bn0_bn1,
-                                          c_grid_block_cluster_blockid_to_gm10_gn10);
+                                          c_grid_block_cluster_blockid_to_gm10_gn10,
+                                          num_block_per_group,
+                                          a_grid_group_stride,
+                                          b_grid_group_stride,
+                                          c_grid_group_stride);
     }
 
     return ave_time;
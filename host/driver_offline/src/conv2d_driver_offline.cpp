@@ -0,0 +1,237 @@
+#include <iostream>
+#include <numeric>
+#include <initializer_list>
+#include <cstdlib>
+#include <stdlib.h>
+#include "config.hpp"
+#include "print.hpp"
+#include "host_tensor.hpp"
+#include "host_tensor_generator.hpp"
+#include "host_tensor_compare.hpp"
+#include "conv_common.hpp"
+#include "host_conv.hpp"
+#include "host_conv_bwd_data.hpp"
+#include "host_conv_bwd_weight.hpp"
+#include "host_conv_implicit_gemm.hpp"
+#include "host_conv_fft.hpp"
+#include "host_conv_winograd.hpp"
+
+int main(int argc, char* argv[])
+{
+    using namespace ck;
+
+    // "--seed <value>" may appear anywhere, it is removed before positional parsing
+    const std::uint64_t seed = get_seed_from_args(argc, argv);
+
+    if(argc != 18)
+    {
+        printf("arg1 to 2: layout (0 = NCHW; 1 = NHWC), do_log\n");
+        printf("optional: --seed <value> for random initialization\n");
+        printf("rest: N, K, C, Y, X, Hi, Wi, Sy, Sx, Dy, Dx, LeftPy, LeftPx, RightPy, RightPx\n");
+        exit(1);
+    }
+
+    const ConvTensorLayout layout =
+        std::stoi(argv[1]) == 0 ? ConvTensorLayout::NCHW : ConvTensorLayout::NHWC;
+    const bool do_log = std::stoi(argv[2]);
+
+    int args[15];
+
+    for(int i = 0; i < 15; ++i)
+    {
+        args[i] = std::stoi(argv[3 + i]);
+    }
+
+    const int N = args[0], K = args[1], C = args[2], Y = args[3], X = args[4];
+    const int Hi = args[5], Wi = args[6];
+
+    const int conv_stride_h = args[7], conv_stride_w = args[8];
+    const int conv_dilation_h = args[9], conv_dilation_w = args[10];
+    const int in_left_pad_h = args[11], in_left_pad_w = args[12];
+    const int in_right_pad_h = args[13], in_right_pad_w = args[14];
+
+    const int Ho =
+        (Hi + in_left_pad_h + in_right_pad_h - (Y - 1) * conv_dilation_h - 1) / conv_stride_h + 1;
+    const int Wo =
+        (Wi + in_left_pad_w + in_right_pad_w - (X - 1) * conv_dilation_w - 1) / conv_stride_w + 1;
+
+    // lengths in NCHW order, permuted to NHWC for that layout
+    auto f_lengths = [&](int i0, int i1, int i2, int i3) {
+        return layout == ConvTensorLayout::NCHW
+                   ? std::vector<std::size_t>{std::size_t(i0),
+                                              std::size_t(i1),
+                                              std::size_t(i2),
+                                              std::size_t(i3)}
+                   : std::vector<std::size_t>{std::size_t(i0),
+                                              std::size_t(i2),
+                                              std::size_t(i3),
+                                              std::size_t(i1)};
+    };
+
+    Tensor<float> in(f_lengths(N, C, Hi, Wi));
+    Tensor<float> wei(f_lengths(K, C, Y, X));
+    Tensor<float> out(f_lengths(N, K, Ho, Wo));
+
+    std::cout << "layout: " << layout << std::endl;
+    ostream_HostTensorDescriptor(in.mDesc, std::cout << "in: ");
+    ostream_HostTensorDescriptor(wei.mDesc, std::cout << "wei: ");
+    ostream_HostTensorDescriptor(out.mDesc, std::cout << "out: ");
+    print_array("InLeftPads", make_tuple(in_left_pad_h, in_left_pad_w));
+    print_array("InRightPads", make_tuple(in_right_pad_h, in_right_pad_w));
+    print_array("ConvStrides", make_tuple(conv_stride_h, conv_stride_w));
+    print_array("ConvDilations", make_tuple(conv_dilation_h, conv_dilation_w));
+
+    const auto conv_strides   = make_tuple(conv_stride_h, conv_stride_w);
+    const auto conv_dilations = make_tuple(conv_dilation_h, conv_dilation_w);
+    const auto in_left_pads   = make_tuple(in_left_pad_h, in_left_pad_w);
+    const auto in_right_pads  = make_tuple(in_right_pad_h, in_right_pad_w);
+
+    std::size_t num_thread = std::thread::hardware_concurrency();
+
+    in.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5, seed}, num_thread);
+    wei.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5, seed + 1}, num_thread);
+
+    // the direct reference run again on |x| gives the sums of |a * b| of every result, which scale
+    // the tolerance of the sums
+    const auto in_abs  = make_abs_host_tensor(in);
+    const auto wei_abs = make_abs_host_tensor(wei);
+
+    Tensor<float> out_ref(out.mDesc);
+    Tensor<float> out_abs_sum(out.mDesc);
+
+    host_direct_convolution(
+        in, wei, out_ref, conv_strides, conv_dilations, in_left_pads, in_right_pads, layout);
+    host_direct_convolution(in_abs,
+                            wei_abs,
+                            out_abs_sum,
+                            conv_strides,
+                            conv_dilations,
+                            in_left_pads,
+                            in_right_pads,
+                            layout);
+
+    const std::size_t fwd_reduction_length = std::size_t(C) * Y * X;
+
+    bool pass = true;
+
+    // forward: FFT, for every stride, dilation and padding, not only where it is preferred
+    {
+        host_conv_fwd_fft(
+            in, wei, out, conv_strides, conv_dilations, in_left_pads, in_right_pads, layout);
+
+        std::cout << "fwd fft: " << std::endl;
+        pass = check_error(out_ref, out, out_abs_sum, fwd_reduction_length) && pass;
+
+        if(do_log)
+        {
+            LogRangeAsType<float>(std::cout << "out_ref: ", out_ref.mData, ",") << std::endl;
+            LogRangeAsType<float>(std::cout << "out    : ", out.mData, ",") << std::endl;
+        }
+    }
+
+    // forward: Winograd F(2x2, 3x3), F(4x4, 3x3) and F(6x6, 3x3), for the layers they support
+    if(Y == 3 && X == 3 && conv_stride_h == 1 && conv_stride_w == 1 && conv_dilation_h == 1 &&
+       conv_dilation_w == 1)
+    {
+        auto f_check_winograd = [&](auto out_tile_size) {
+            host_conv_fwd_winograd<out_tile_size>(
+                in, wei, out, conv_strides, conv_dilations, in_left_pads, in_right_pads, layout);
+
+            std::cout << "fwd winograd F(" << out_tile_size << ", 3): " << std::endl;
+            pass = check_error(out_ref, out, out_abs_sum, fwd_reduction_length) && pass;
+        };
+
+        f_check_winograd(Number<2>{});
+        f_check_winograd(Number<4>{});
+        f_check_winograd(Number<6>{});
+    }
+
+    // backward data and weight: implicit GEMM, on an output gradient independent of the forward
+    // output
+    {
+        Tensor<float> out_grad(out.mDesc);
+        Tensor<float> in_grad(in.mDesc);
+        Tensor<float> in_grad_ref(in.mDesc);
+        Tensor<float> wei_grad(wei.mDesc);
+        Tensor<float> wei_grad_ref(wei.mDesc);
+        Tensor<float> in_grad_abs_sum(in.mDesc);
+        Tensor<float> wei_grad_abs_sum(wei.mDesc);
+
+        out_grad.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5, seed + 2}, num_thread);
+
+        const auto out_grad_abs = make_abs_host_tensor(out_grad);
+
+        host_direct_convolution_backward_data(in_grad_ref,
+                                              wei,
+                                              out_grad,
+                                              conv_strides,
+                                              conv_dilations,
+                                              in_left_pads,
+                                              in_right_pads,
+                                              layout);
+        host_direct_convolution_backward_data(in_grad_abs_sum,
+                                              wei_abs,
+                                              out_grad_abs,
+                                              conv_strides,
+                                              conv_dilations,
+                                              in_left_pads,
+                                              in_right_pads,
+                                              layout);
+        host_conv_bwd_data_implicit_gemm(in_grad,
+                                         wei,
+                                         out_grad,
+                                         conv_strides,
+                                         conv_dilations,
+                                         in_left_pads,
+                                         in_right_pads,
+                                         layout);
+
+        std::cout << "bwd data implicit gemm: " << std::endl;
+        pass = check_error(in_grad_ref, in_grad, in_grad_abs_sum, std::size_t(K) * Y * X) && pass;
+
+        host_direct_convolution_backward_weights(out_grad,
+                                                 in,
+                                                 wei_grad_ref,
+                                                 conv_strides,
+                                                 conv_dilations,
+                                                 in_left_pads,
+                                                 in_right_pads,
+                                                 layout);
+        host_direct_convolution_backward_weights(out_grad_abs,
+                                                 in_abs,
+                                                 wei_grad_abs_sum,
+                                                 conv_strides,
+                                                 conv_dilations,
+                                                 in_left_pads,
+                                                 in_right_pads,
+                                                 layout);
+        host_conv_bwd_weight_implicit_gemm(out_grad,
+                                           in,
+                                           wei_grad,
+                                           conv_strides,
+                                           conv_dilations,
+                                           in_left_pads,
+                                           in_right_pads,
+                                           layout);
+
+        std::cout << "bwd weight implicit gemm: " << std::endl;
+        pass = check_error(
+                   wei_grad_ref, wei_grad, wei_grad_abs_sum, std::size_t(N) * Ho * Wo) &&
+               pass;
+
+        if(do_log)
+        {
+            LogRangeAsType<float>(std::cout << "in_grad_ref : ", in_grad_ref.mData, ",")
+                << std::endl;
+            LogRangeAsType<float>(std::cout << "in_grad     : ", in_grad.mData, ",") << std::endl;
+            LogRangeAsType<float>(std::cout << "wei_grad_ref: ", wei_grad_ref.mData, ",")
+                << std::endl;
+            LogRangeAsType<float>(std::cout << "wei_grad    : ", wei_grad.mData, ",")
+                << std::endl;
+        }
+    }
+
+    std::cout << (pass ? "PASS" : "FAIL") << std::endl;
+
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,335 @@
+#include <iostream>
+#include <numeric>
+#include <initializer_list>
+#include <cstdlib>
+#include <stdlib.h>
+#include "config.hpp"
+#include "data_type_enum.hpp"
+#include "print.hpp"
+#include "host_tensor.hpp"
+#include "host_tensor_generator.hpp"
+#include "host_tensor_compare.hpp"
+#include "conv_common.hpp"
+#include "host_conv3d.hpp"
+#include "convolution_problem_descriptor.hpp"
+
+// element (n, c, d, h, w) of an activation, or (k, c, z, y, x) of a weight, in either layout
+template <typename T>
+T& at(Tensor<T>& t, ConvTensorLayout layout, int i0, int i1, int i2, int i3, int i4)
+{
+    return layout == ConvTensorLayout::NCDHW ? t(i0, i1, i2, i3, i4) : t(i0, i2, i3, i4, i1);
+}
+
+// Direct backward-data reference, accumulated in double: input element (n, c, di, hi, wi) sums
+// out * wei over every filter tap (z, y, x) whose output position is on the stride grid.
+// Ungrouped only, like host_conv3d_bwd_data_implicit_gemm
+void host_direct_convolution_3d_backward_data(Tensor<float>& in,
+                                              Tensor<float>& wei,
+                                              Tensor<float>& out,
+                                              const ck::driver::Convolution3dProblemDescriptor& p,
+                                              ConvTensorLayout layout)
+{
+    const int s[3]  = {p.ConvStrideD, p.ConvStrideH, p.ConvStrideW};
+    const int dl[3] = {p.ConvDilationD, p.ConvDilationH, p.ConvDilationW};
+    const int lp[3] = {p.InLeftPadD, p.InLeftPadH, p.InLeftPadW};
+    const int lo[3] = {p.Do, p.Ho, p.Wo};
+
+    // output position along one dimension that filter tap t reaches input position i from, or -1
+    auto f_out_pos = [&](int dim, int i, int t) {
+        const int tmp = i + lp[dim] - t * dl[dim];
+
+        return tmp >= 0 && tmp % s[dim] == 0 && tmp / s[dim] < lo[dim] ? tmp / s[dim] : -1;
+    };
+
+    auto f = [&](auto n, auto c, auto di, auto hi, auto wi) {
+        double v = 0;
+
+        for(int z = 0; z < p.Z; ++z)
+        {
+            const int d = f_out_pos(0, di, z);
+
+            for(int y = 0; d >= 0 && y < p.Y; ++y)
+            {
+                const int h = f_out_pos(1, hi, y);
+
+                for(int x = 0; h >= 0 && x < p.X; ++x)
+                {
+                    const int w = f_out_pos(2, wi, x);
+
+                    for(int k = 0; w >= 0 && k < p.K; ++k)
+                    {
+                        v += double(at(out, layout, n, k, d, h, w)) *
+                             double(at(wei, layout, k, c, z, y, x));
+                    }
+                }
+            }
+        }
+
+        at(in, layout, n, c, di, hi, wi) = v;
+    };
+
+    make_ParallelTensorFunctor(f, p.N, p.C, p.Di, p.Hi, p.Wi)(
+        std::thread::hardware_concurrency());
+}
+
+// Direct backward-weight reference, accumulated in double: weight element (k, c, z, y, x) sums
+// out * in over every output position whose input position is inside the unpadded input.
+// Ungrouped only, like host_conv3d_bwd_weight_implicit_gemm
+void host_direct_convolution_3d_backward_weights(
+    Tensor<float>& in,
+    Tensor<float>& wei,
+    Tensor<float>& out,
+    const ck::driver::Convolution3dProblemDescriptor& p,
+    ConvTensorLayout layout)
+{
+    auto f = [&](auto k, auto c, auto z, auto y, auto x) {
+        double v = 0;
+
+        for(int n = 0; n < p.N; ++n)
+        {
+            for(int d = 0; d < p.Do; ++d)
+            {
+                const int di = d * p.ConvStrideD + z * p.ConvDilationD - p.InLeftPadD;
+
+                for(int h = 0; di >= 0 && di < p.Di && h < p.Ho; ++h)
+                {
+                    const int hi = h * p.ConvStrideH + y * p.ConvDilationH - p.InLeftPadH;
+
+                    for(int w = 0; hi >= 0 && hi < p.Hi && w < p.Wo; ++w)
+                    {
+                        const int wi = w * p.ConvStrideW + x * p.ConvDilationW - p.InLeftPadW;
+
+                        if(wi >= 0 && wi < p.Wi)
+                        {
+                            v += double(at(out, layout, n, k, d, h, w)) *
+                                 double(at(in, layout, n, c, di, hi, wi));
+                        }
+                    }
+                }
+            }
+        }
+
+        at(wei, layout, k, c, z, y, x) = v;
+    };
+
+    make_ParallelTensorFunctor(f, p.K, p.C, p.Z, p.Y, p.X)(std::thread::hardware_concurrency());
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace ck;
+
+    // "--seed <value>" may appear anywhere, it is removed before positional parsing
+    const std::uint64_t seed = get_seed_from_args(argc, argv);
+
+    // grouped convolution, the weight has C / G channels
+    const index_t G = get_group_from_args(argc, argv);
+
+    if(argc != 24)
+    {
+        printf("arg1 to 2: layout (0 = NCDHW; 1 = NDHWC), do_log\n");
+        printf("optional: --seed <value> for random initialization\n");
+        printf("optional: --group <G> for grouped convolution, forward only\n");
+        printf("rest: N, K, C, Z, Y, X, Di, Hi, Wi, Sz, Sy, Sx, Dz, Dy, Dx, LeftPz, LeftPy, "
+               "LeftPx, RightPz, RightPy, RightPx\n");
+        exit(1);
+    }
+
+    const ConvTensorLayout layout =
+        std::stoi(argv[1]) == 0 ? ConvTensorLayout::NCDHW : ConvTensorLayout::NDHWC;
+    const bool do_log = std::stoi(argv[2]);
+
+    int args[21];
+
+    for(int i = 0; i < 21; ++i)
+    {
+        args[i] = std::stoi(argv[3 + i]);
+    }
+
+    const int N = args[0], K = args[1], C = args[2], Z = args[3], Y = args[4], X = args[5];
+    const int Di = args[6], Hi = args[7], Wi = args[8];
+
+    // output lengths, from the filter extent with dilation
+    auto f_out_length = [&](int i_length, int filter, int dim) {
+        const int filter_eff = (filter - 1) * args[12 + dim] + 1;
+
+        return (i_length + args[15 + dim] + args[18 + dim] - filter_eff) / args[9 + dim] + 1;
+    };
+
+    const driver::Convolution3dProblemDescriptor p(N,
+                                                   K,
+                                                   C,
+                                                   Z,
+                                                   Y,
+                                                   X,
+                                                   Di,
+                                                   Hi,
+                                                   Wi,
+                                                   f_out_length(Di, Z, 0),
+                                                   f_out_length(Hi, Y, 1),
+                                                   f_out_length(Wi, X, 2),
+                                                   args[9],
+                                                   args[10],
+                                                   args[11],
+                                                   args[12],
+                                                   args[13],
+                                                   args[14],
+                                                   args[15],
+                                                   args[16],
+                                                   args[17],
+                                                   args[18],
+                                                   args[19],
+                                                   args[20],
+                                                   DataTypeEnum_t::Float,
+                                                   DataTypeEnum_t::Float,
+                                                   DataTypeEnum_t::Float,
+                                                   G);
+
+    if(p.G < 1 || p.C % p.G != 0 || p.K % p.G != 0)
+    {
+        throw std::runtime_error("wrong! C and K must be multiples of the group count");
+    }
+
+    // lengths in NCDHW order, permuted to NDHWC for that layout
+    auto f_lengths = [&](int i0, int i1, int i2, int i3, int i4) {
+        return layout == ConvTensorLayout::NCDHW
+                   ? std::vector<std::size_t>{std::size_t(i0),
+                                              std::size_t(i1),
+                                              std::size_t(i2),
+                                              std::size_t(i3),
+                                              std::size_t(i4)}
+                   : std::vector<std::size_t>{std::size_t(i0),
+                                              std::size_t(i2),
+                                              std::size_t(i3),
+                                              std::size_t(i4),
+                                              std::size_t(i1)};
+    };
+
+    Tensor<float> in(f_lengths(p.N, p.C, p.Di, p.Hi, p.Wi));
+    Tensor<float> wei(f_lengths(p.K, p.C / p.G, p.Z, p.Y, p.X));
+    Tensor<float> out(f_lengths(p.N, p.K, p.Do, p.Ho, p.Wo));
+
+    std::cout << "layout: " << layout << std::endl;
+    ostream_HostTensorDescriptor(in.mDesc, std::cout << "in: ");
+    ostream_HostTensorDescriptor(wei.mDesc, std::cout << "wei: ");
+    ostream_HostTensorDescriptor(out.mDesc, std::cout << "out: ");
+    print_array("InLeftPads", make_tuple(p.InLeftPadD, p.InLeftPadH, p.InLeftPadW));
+    print_array("InRightPads", make_tuple(p.InRightPadD, p.InRightPadH, p.InRightPadW));
+    print_array("ConvStrides", make_tuple(p.ConvStrideD, p.ConvStrideH, p.ConvStrideW));
+    print_array("ConvDilations", make_tuple(p.ConvDilationD, p.ConvDilationH, p.ConvDilationW));
+    std::cout << "flop: " << p.CalculateFlop() << std::endl;
+
+    const auto conv_strides   = make_tuple(p.ConvStrideD, p.ConvStrideH, p.ConvStrideW);
+    const auto conv_dilations = make_tuple(p.ConvDilationD, p.ConvDilationH, p.ConvDilationW);
+    const auto in_left_pads   = make_tuple(p.InLeftPadD, p.InLeftPadH, p.InLeftPadW);
+    const auto in_right_pads  = make_tuple(p.InRightPadD, p.InRightPadH, p.InRightPadW);
+
+    std::size_t num_thread = std::thread::hardware_concurrency();
+
+    in.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5, seed}, num_thread);
+    wei.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5, seed + 1}, num_thread);
+
+    // the direct references run again on |x| give the sums of |a * b| of every result, which
+    // scale the tolerance of the sums
+    auto in_abs  = make_abs_host_tensor(in);
+    auto wei_abs = make_abs_host_tensor(wei);
+
+    bool pass = true;
+
+    // forward: implicit GEMM, with the offsets of the 3-D forward transforms, vs direct
+    {
+        Tensor<float> out_ref(out.mDesc);
+        Tensor<float> out_abs_sum(out.mDesc);
+
+        host_direct_convolution_3d(
+            in, wei, out_ref, conv_strides, conv_dilations, in_left_pads, in_right_pads, layout);
+        host_direct_convolution_3d(in_abs,
+                                   wei_abs,
+                                   out_abs_sum,
+                                   conv_strides,
+                                   conv_dilations,
+                                   in_left_pads,
+                                   in_right_pads,
+                                   layout);
+        host_conv3d_fwd_implicit_gemm(
+            in, wei, out, conv_strides, conv_dilations, in_left_pads, in_right_pads, layout);
+
+        std::cout << "fwd: " << std::endl;
+        pass = check_error(out_ref, out, out_abs_sum, std::size_t(p.C / p.G) * p.Z * p.Y * p.X) &&
+               pass;
+
+        if(do_log)
+        {
+            LogRangeAsType<float>(std::cout << "out_ref: ", out_ref.mData, ",") << std::endl;
+            LogRangeAsType<float>(std::cout << "out    : ", out.mData, ",") << std::endl;
+        }
+    }
+
+    // the backward engines are ungrouped only
+    if(p.G == 1)
+    {
+        // an output gradient independent of the forward output
+        Tensor<float> out_grad(out.mDesc);
+        Tensor<float> in_grad(in.mDesc);
+        Tensor<float> in_grad_ref(in.mDesc);
+        Tensor<float> wei_grad(wei.mDesc);
+        Tensor<float> wei_grad_ref(wei.mDesc);
+        Tensor<float> in_grad_abs_sum(in.mDesc);
+        Tensor<float> wei_grad_abs_sum(wei.mDesc);
+
+        out_grad.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5, seed + 2}, num_thread);
+
+        auto out_grad_abs = make_abs_host_tensor(out_grad);
+
+        host_direct_convolution_3d_backward_data(in_grad_ref, wei, out_grad, p, layout);
+        host_direct_convolution_3d_backward_data(
+            in_grad_abs_sum, wei_abs, out_grad_abs, p, layout);
+        host_conv3d_bwd_data_implicit_gemm(in_grad,
+                                           wei,
+                                           out_grad,
+                                           conv_strides,
+                                           conv_dilations,
+                                           in_left_pads,
+                                           in_right_pads,
+                                           layout);
+
+        std::cout << "bwd data: " << std::endl;
+        pass = check_error(
+                   in_grad_ref, in_grad, in_grad_abs_sum, std::size_t(p.K) * p.Z * p.Y * p.X) &&
+               pass;
+
+        host_direct_convolution_3d_backward_weights(in, wei_grad_ref, out_grad, p, layout);
+        host_direct_convolution_3d_backward_weights(
+            in_abs, wei_grad_abs_sum, out_grad_abs, p, layout);
+        host_conv3d_bwd_weight_implicit_gemm(out_grad,
+                                             in,
+                                             wei_grad,
+                                             conv_strides,
+                                             conv_dilations,
+                                             in_left_pads,
+                                             in_right_pads,
+                                             layout);
+
+        std::cout << "bwd weight: " << std::endl;
+        pass = check_error(wei_grad_ref,
+                           wei_grad,
+                           wei_grad_abs_sum,
+                           std::size_t(p.N) * p.Do * p.Ho * p.Wo) &&
+               pass;
+
+        if(do_log)
+        {
+            LogRangeAsType<float>(std::cout << "in_grad_ref : ", in_grad_ref.mData, ",")
+                << std::endl;
+            LogRangeAsType<float>(std::cout << "in_grad     : ", in_grad.mData, ",") << std::endl;
+            LogRangeAsType<float>(std::cout << "wei_grad_ref: ", wei_grad_ref.mData, ",")
+                << std::endl;
+            LogRangeAsType<float>(std::cout << "wei_grad    : ", wei_grad.mData, ",")
+                << std::endl;
+        }
+    }
+
+    std::cout << (pass ? "PASS" : "FAIL") << std::endl;
+
+    return pass ? 0 : 1;
+}
@@ -10,8 +10,10 @@
 #include "device.hpp"
 #include "host_tensor.hpp"
 #include "host_tensor_generator.hpp"
+#include "host_tensor_compare.hpp"
 #include "conv_common.hpp"
 #include "host_conv_bwd_data.hpp"
+#include "host_conv_implicit_gemm.hpp"
 #include "device_tensor.hpp"
 #include "device_convolution_backward_data_implicit_gemm_v4r1_xdlops_nhwc_kyxc_nhwk.hpp"
 #include "device_convolution_backward_data_implicit_gemm_v4r1r2_xdlops_nhwc_kyxc_nhwk.hpp"
@@ -31,6 +33,9 @@ int main(int argc, char* argv[])
 {
     using namespace ck;
 
+    // "--seed <value>" may appear anywhere, it is removed before positional parsing
+    const std::uint64_t seed = get_seed_from_args(argc, argv);
+
     constexpr auto I0 = Number<0>{};
     constexpr auto I1 = Number<1>{};
     constexpr auto I2 = Number<2>{};
@@ -44,6 +49,7 @@ int main(int argc, char* argv[])
     if(argc != 22)
     {
         printf("arg1 to 6: layout, algo, do_verification, init_method, do_log, nrepeat\n");
+        printf("optional: --seed <value> for random initialization\n");
         printf("rest: N, K, C, Y, X, Hi, Wi, Sy, Sx, Dy, Dx, LeftPy, LeftPx, RightPy, RightPx\n");
         exit(1);
     }
@@ -82,6 +88,7 @@ int main(int argc, char* argv[])
     if(argc < 7)
     {
         printf("arg1 to 6: layout, algo, do_verification, init_method, do_log, nrepeat\n");
+        printf("optional: --seed <value> for random initialization\n");
         exit(1);
     }
 
@@ -190,25 +197,25 @@ int main(int argc, char* argv[])
         break;
     case 2:
         out.GenerateTensorValue(GeneratorTensor_1{}, num_thread);
-        wei.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        wei.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed + 1}, num_thread);
         break;
     case 3:
-        out.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        out.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed}, num_thread);
         wei.GenerateTensorValue(GeneratorTensor_1{}, num_thread);
         break;
     case 4:
-        out.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
-        wei.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        out.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed}, num_thread);
+        wei.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed + 1}, num_thread);
         break;
     case 5:
-        out.GenerateTensorValue(GeneratorTensor_3<float>{0.0, 1.0}, num_thread);
-        wei.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5}, num_thread);
+        out.GenerateTensorValue(GeneratorTensor_3<float>{0.0, 1.0, seed}, num_thread);
+        wei.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5, seed + 1}, num_thread);
         break;
     default:
-        out.GenerateTensorValue(GeneratorTensor_2{1, 5}, num_thread);
+        out.GenerateTensorValue(GeneratorTensor_2{1, 5, seed}, num_thread);
 
-        auto gen_wei = [](auto... is) {
-            return GeneratorTensor_2{1, 5}(is...) * GeneratorTensor_Checkboard{}(is...);
+        auto gen_wei = [=](auto... is) {
+            return GeneratorTensor_2{1, 5, seed + 1}(is...) * GeneratorTensor_Checkboard{}(is...);
         };
         wei.GenerateTensorValue(gen_wei, num_thread);
     }
@@ -324,16 +331,28 @@ int main(int argc, char* argv[])
 
     if(do_verification)
     {
-        host_direct_convolution_backward_data(in_host,
-                                              wei,
-                                              out,
-                                              make_tuple(conv_stride_h, conv_stride_w),
-                                              make_tuple(conv_dilation_h, conv_dilation_w),
-                                              make_tuple(in_left_pad_h, in_left_pad_w),
-                                              make_tuple(in_right_pad_h, in_right_pad_w),
-                                              layout);
-
-        check_error(in_host, in_device);
+        host_conv_bwd_data_implicit_gemm(in_host,
+                                         wei,
+                                         out,
+                                         make_tuple(conv_stride_h, conv_stride_w),
+                                         make_tuple(conv_dilation_h, conv_dilation_w),
+                                         make_tuple(in_left_pad_h, in_left_pad_w),
+                                         make_tuple(in_right_pad_h, in_right_pad_w),
+                                         layout);
+
+        // the sums of |wei * out|, they scale the tolerance of the K * Y * X long sums
+        Tensor<in_data_t> in_abs_sum(in_host.mDesc);
+
+        host_conv_bwd_data_implicit_gemm(in_abs_sum,
+                                         make_abs_host_tensor(wei),
+                                         make_abs_host_tensor(out),
+                                         make_tuple(conv_stride_h, conv_stride_w),
+                                         make_tuple(conv_dilation_h, conv_dilation_w),
+                                         make_tuple(in_left_pad_h, in_left_pad_w),
+                                         make_tuple(in_right_pad_h, in_right_pad_w),
+                                         layout);
+
+        check_error(in_host, in_device, in_abs_sum, static_cast<std::size_t>(K) * Y * X);
 
         if(do_log)
         {
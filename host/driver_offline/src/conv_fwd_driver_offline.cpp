@@ -3,30 +3,48 @@
 #include <initializer_list>
 #include <cstdlib>
 #include <stdlib.h>
+#ifndef CK_CPU_TARGET
 #include <half.hpp>
+#endif
 #include "config.hpp"
 #include "debug.hpp"
 #include "print.hpp"
 #include "device.hpp"
 #include "host_tensor.hpp"
 #include "host_tensor_generator.hpp"
+#include "host_tensor_compare.hpp"
 #include "conv_common.hpp"
 #include "host_conv.hpp"
+#include "host_conv_implicit_gemm.hpp"
+#include "host_conv_depthwise.hpp"
+#include "host_conv_fft.hpp"
 #include "device_tensor.hpp"
 #include "device_convolution_forward_implicit_gemm_v4r4_dlops_nchw_kcyx_nkhw.hpp"
 #include "device_convolution_forward_implicit_gemm_v4r4r2_dlops_nhwc_kyxc_nhwk.hpp"
 #include "device_convolution_forward_implicit_gemm_v6r1_dlops_nchw_kcyx_nkhw.hpp"
 #include "device_convolution_forward_implicit_gemm_v5r1_dlops_nchw_kcyx_nkhw.hpp"
+#ifndef CK_CPU_TARGET
 #include "device_convolution_forward_implicit_gemm_v4r4r2_xdlops_nchw_kcyx_nkhw.hpp"
 #include "device_convolution_forward_implicit_gemm_v4r4r4_xdlops_nhwc_kyxc_nhwk.hpp"
+#endif
 
 #define USE_DYNAMIC_MODE 1
+#ifdef CK_CPU_TARGET
+// the CPU target has no XDLOPS, run the DLOPS kernels instead
+#define USE_CONV_FWD_V4R4_NCHW 1
+#define USE_CONV_FWD_V4R4R2_NHWC 0
+#define USE_CONV_FWD_V6R1_NCHW 1
+#define USE_CONV_FWD_V5R1_NCHW 0
+#define USE_CONV_FWD_V4R4R2_XDL_NCHW 0
+#define USE_CONV_FWD_V4R4R4_XDL_NHWC 0
+#else
 #define USE_CONV_FWD_V4R4_NCHW 0
 #define USE_CONV_FWD_V4R4R2_NHWC 0
 #define USE_CONV_FWD_V6R1_NCHW 0
 #define USE_CONV_FWD_V5R1_NCHW 0
 #define USE_CONV_FWD_V4R4R2_XDL_NCHW 0
 #define USE_CONV_FWD_V4R4R4_XDL_NHWC 1
+#endif
 
 enum ConvForwardAlgo
 {
@@ -42,6 +60,12 @@ int main(int argc, char* argv[])
 {
     using namespace ck;
 
+    // "--seed <value>" may appear anywhere, it is removed before positional parsing
+    const std::uint64_t seed = get_seed_from_args(argc, argv);
+
+    // grouped convolution, the weight has C / G channels
+    const index_t G = get_group_from_args(argc, argv);
+
     constexpr auto I0 = Number<0>{};
     constexpr auto I1 = Number<1>{};
     constexpr auto I2 = Number<2>{};
@@ -55,6 +79,8 @@ int main(int argc, char* argv[])
     if(argc != 22)
     {
         printf("arg1 to 6: layout, algo, do_verification, init_method, do_log, nrepeat\n");
+        printf("optional: --seed <value> for random initialization\n");
+        printf("optional: --group <G> for grouped convolution, v6r1 only\n");
         printf("rest: N, K, C, Y, X, Hi, Wi, Sy, Sx, Dy, Dx, LeftPy, LeftPx, RightPy, RightPx\n");
         exit(1);
     }
@@ -93,6 +119,8 @@ int main(int argc, char* argv[])
     if(argc < 7)
     {
         printf("arg1 to 6: layout, algo, do_verification, init_method, do_log, nrepeat\n");
+        printf("optional: --seed <value> for random initialization\n");
+        printf("optional: --group <G> for grouped convolution, v6r1 only\n");
         exit(1);
     }
 
@@ -127,7 +155,22 @@ int main(int argc, char* argv[])
     constexpr auto Wo = (Wi + in_left_pad_w + in_right_pad_w - XEff) / conv_stride_w + I1;
 #endif
 
-#if 0
+    if(G < 1 || C % G != 0 || K % G != 0)
+    {
+        throw std::runtime_error("wrong! C and K must be multiples of the group count");
+    }
+
+    if(G != 1 && algo != ConvForwardAlgo::V6R1NCHW)
+    {
+        throw std::runtime_error("wrong! only v6r1 supports grouped convolution");
+    }
+
+#if defined(CK_CPU_TARGET)
+    // there is no scalar fp16 inner product for the DLOPS kernels
+    using in_data_t  = float;
+    using acc_data_t = float;
+    using out_data_t = float;
+#elif 0
     using in_data_t  = float;
     using acc_data_t = float;
     using out_data_t = float;
@@ -150,7 +193,7 @@ int main(int argc, char* argv[])
         in_lengths_host[2]  = static_cast<std::size_t>(Hi);
         in_lengths_host[3]  = static_cast<std::size_t>(Wi);
         wei_lengths_host[0] = static_cast<std::size_t>(K);
-        wei_lengths_host[1] = static_cast<std::size_t>(C);
+        wei_lengths_host[1] = static_cast<std::size_t>(C / G);
         wei_lengths_host[2] = static_cast<std::size_t>(Y);
         wei_lengths_host[3] = static_cast<std::size_t>(X);
         out_lengths_host[0] = static_cast<std::size_t>(N);
@@ -167,7 +210,7 @@ int main(int argc, char* argv[])
         wei_lengths_host[0] = static_cast<std::size_t>(K);
         wei_lengths_host[1] = static_cast<std::size_t>(Y);
         wei_lengths_host[2] = static_cast<std::size_t>(X);
-        wei_lengths_host[3] = static_cast<std::size_t>(C);
+        wei_lengths_host[3] = static_cast<std::size_t>(C / G);
         out_lengths_host[0] = static_cast<std::size_t>(N);
         out_lengths_host[1] = static_cast<std::size_t>(Ho);
         out_lengths_host[2] = static_cast<std::size_t>(Wo);
@@ -205,32 +248,34 @@ int main(int argc, char* argv[])
         break;
     case 2:
         in.GenerateTensorValue(GeneratorTensor_1{}, num_thread);
-        wei.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        wei.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed + 1}, num_thread);
         break;
     case 3:
-        in.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        in.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed}, num_thread);
         wei.GenerateTensorValue(GeneratorTensor_1{}, num_thread);
         break;
     case 4:
-        in.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
-        wei.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        in.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed}, num_thread);
+        wei.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed + 1}, num_thread);
         break;
     case 5:
-        in.GenerateTensorValue(GeneratorTensor_3<float>{0.0, 1.0}, num_thread);
-        wei.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5}, num_thread);
+        in.GenerateTensorValue(GeneratorTensor_3<float>{0.0, 1.0, seed}, num_thread);
+        wei.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5, seed + 1}, num_thread);
         break;
     default:
-        in.GenerateTensorValue(GeneratorTensor_2{1, 5}, num_thread);
+        in.GenerateTensorValue(GeneratorTensor_2{1, 5, seed}, num_thread);
 
-        auto gen_wei = [](auto... is) {
-            return GeneratorTensor_2{1, 5}(is...) * GeneratorTensor_Checkboard{}(is...);
+        auto gen_wei = [=](auto... is) {
+            return GeneratorTensor_2{1, 5, seed + 1}(is...) * GeneratorTensor_Checkboard{}(is...);
         };
         wei.GenerateTensorValue(gen_wei, num_thread);
     }
 
+#if USE_CONV_FWD_V4R4_NCHW || USE_CONV_FWD_V6R1_NCHW || USE_CONV_FWD_V5R1_NCHW || \
+    USE_CONV_FWD_V4R4R2_XDL_NCHW
     auto f_make_for_device_nchw = [&]() {
         const auto in_lengths_dev     = make_tuple(N, C, Hi, Wi);
-        const auto wei_lengths_dev    = make_tuple(K, C, Y, X);
+        const auto wei_lengths_dev    = make_tuple(K, C / G, Y, X);
         const auto out_lengths_dev    = make_tuple(N, K, Ho, Wo);
         const auto conv_strides_dev   = make_tuple(conv_stride_h, conv_stride_w);
         const auto conv_dilations_dev = make_tuple(conv_dilation_h, conv_dilation_w);
@@ -245,10 +290,12 @@ int main(int argc, char* argv[])
                           in_left_pads_dev,
                           in_right_pads_dev);
     };
+#endif
 
+#if USE_CONV_FWD_V4R4R2_NHWC || USE_CONV_FWD_V4R4R4_XDL_NHWC
     auto f_make_for_device_nhwc = [&]() {
         const auto in_lengths_dev     = make_tuple(N, Hi, Wi, C);
-        const auto wei_lengths_dev    = make_tuple(K, Y, X, C);
+        const auto wei_lengths_dev    = make_tuple(K, Y, X, C / G);
         const auto out_lengths_dev    = make_tuple(N, Ho, Wo, K);
         const auto conv_strides_dev   = make_tuple(conv_stride_h, conv_stride_w);
         const auto conv_dilations_dev = make_tuple(conv_dilation_h, conv_dilation_w);
@@ -263,6 +310,7 @@ int main(int argc, char* argv[])
                           in_left_pads_dev,
                           in_right_pads_dev);
     };
+#endif
 
 #if USE_CONV_FWD_V4R4_NCHW
     if(algo == ConvForwardAlgo::V4R4NCHW)
@@ -423,18 +471,101 @@ int main(int argc, char* argv[])
     }
 #endif
 
+    bool pass = true;
+
     if(do_verification)
     {
-        host_direct_convolution(in,
-                                wei,
-                                out_host,
-                                make_tuple(conv_stride_h, conv_stride_w),
-                                make_tuple(conv_dilation_h, conv_dilation_w),
-                                make_tuple(in_left_pad_h, in_left_pad_w),
-                                make_tuple(in_right_pad_h, in_right_pad_w),
-                                layout);
+        // FFT where is_host_conv_fft_preferred measured a gain, implicit GEMM for everything else,
+        // also for 3x3 stride-1 layers where host_conv_fwd_winograd is slower and less accurate.
+        // Grouped layers take the depthwise kernel when every group has one input channel and
+        // implicit GEMM otherwise, and both are checked against the direct reference
+        const bool is_fp = std::is_floating_point<acc_data_t>::value;
+
+        // the sums of |in * wei|, they scale the tolerance of the (C / G) * Y * X long sums
+        Tensor<out_data_t> out_abs_sum(out_lengths_host);
+
+        host_conv_fwd_implicit_gemm(make_abs_host_tensor(in),
+                                    make_abs_host_tensor(wei),
+                                    out_abs_sum,
+                                    make_tuple(conv_stride_h, conv_stride_w),
+                                    make_tuple(conv_dilation_h, conv_dilation_w),
+                                    make_tuple(in_left_pad_h, in_left_pad_w),
+                                    make_tuple(in_right_pad_h, in_right_pad_w),
+                                    layout);
+
+        const std::size_t reduction_length = static_cast<std::size_t>(C / G) * Y * X;
+
+        if(G != 1)
+        {
+            if(G == C)
+            {
+                host_conv_fwd_depthwise(in,
+                                        wei,
+                                        out_host,
+                                        make_tuple(conv_stride_h, conv_stride_w),
+                                        make_tuple(conv_dilation_h, conv_dilation_w),
+                                        make_tuple(in_left_pad_h, in_left_pad_w),
+                                        make_tuple(in_right_pad_h, in_right_pad_w),
+                                        layout);
+            }
+            else
+            {
+                host_conv_fwd_implicit_gemm(in,
+                                            wei,
+                                            out_host,
+                                            make_tuple(conv_stride_h, conv_stride_w),
+                                            make_tuple(conv_dilation_h, conv_dilation_w),
+                                            make_tuple(in_left_pad_h, in_left_pad_w),
+                                            make_tuple(in_right_pad_h, in_right_pad_w),
+                                            layout);
+            }
+
+            Tensor<out_data_t> out_ref(out_lengths_host);
+
+            host_direct_convolution(in,
+                                    wei,
+                                    out_ref,
+                                    make_tuple(conv_stride_h, conv_stride_w),
+                                    make_tuple(conv_dilation_h, conv_dilation_w),
+                                    make_tuple(in_left_pad_h, in_left_pad_w),
+                                    make_tuple(in_right_pad_h, in_right_pad_w),
+                                    layout);
+
+            pass = check_error(out_ref, out_host, out_abs_sum, reduction_length);
+        }
+        else if(is_fp && is_host_conv_fft_preferred(C,
+                                                    K,
+                                                    Y,
+                                                    X,
+                                                    Ho,
+                                                    Wo,
+                                                    conv_stride_h,
+                                                    conv_stride_w,
+                                                    conv_dilation_h,
+                                                    conv_dilation_w))
+        {
+            host_conv_fwd_fft(in,
+                              wei,
+                              out_host,
+                              make_tuple(conv_stride_h, conv_stride_w),
+                              make_tuple(conv_dilation_h, conv_dilation_w),
+                              make_tuple(in_left_pad_h, in_left_pad_w),
+                              make_tuple(in_right_pad_h, in_right_pad_w),
+                              layout);
+        }
+        else
+        {
+            host_conv_fwd_implicit_gemm(in,
+                                        wei,
+                                        out_host,
+                                        make_tuple(conv_stride_h, conv_stride_w),
+                                        make_tuple(conv_dilation_h, conv_dilation_w),
+                                        make_tuple(in_left_pad_h, in_left_pad_w),
+                                        make_tuple(in_right_pad_h, in_right_pad_w),
+                                        layout);
+        }
 
-        check_error(out_host, out_device);
+        pass = check_error(out_host, out_device, out_abs_sum, reduction_length) && pass;
 
         if(do_log)
         {
@@ -444,4 +575,6 @@ int main(int argc, char* argv[])
             LogRangeAsType<float>(std::cout << "out_device: ", out_device.mData, ",") << std::endl;
         }
     }
+
+    return pass ? 0 : 1;
 }
@@ -10,8 +10,10 @@
 #include "device.hpp"
 #include "host_tensor.hpp"
 #include "host_tensor_generator.hpp"
+#include "host_tensor_compare.hpp"
 #include "conv_common.hpp"
 #include "host_conv_bwd_weight.hpp"
+#include "host_conv_implicit_gemm.hpp"
 #include "device_tensor.hpp"
 #include "device_convolution_backward_weight_implicit_gemm_v4r4r2_xdlops_nchw_kcyx_nkhw.hpp"
 #include "device_convolution_backward_weight_implicit_gemm_v4r4r4_xdlops_nhwc_kyxc_nhwk.hpp"
@@ -39,6 +41,9 @@ int main(int argc, char* argv[])
 {
     using namespace ck;
 
+    // "--seed <value>" may appear anywhere, it is removed before positional parsing
+    const std::uint64_t seed = get_seed_from_args(argc, argv);
+
     constexpr auto I0 = Number<0>{};
     constexpr auto I1 = Number<1>{};
     constexpr auto I2 = Number<2>{};
@@ -52,6 +57,7 @@ int main(int argc, char* argv[])
     if(argc != 23)
     {
         printf("arg1 to 6: layout, algo, do_verification, init_method, do_log, nrepeat\n");
+        printf("optional: --seed <value> for random initialization\n");
         printf("rest: N, K, C, Y, X, Hi, Wi, Sy, Sx, Dy, Dx, LeftPy, LeftPx, RightPy, RightPx\n");
         printf("additional: desired_grid_size\n");
         exit(1);
@@ -93,6 +99,7 @@ int main(int argc, char* argv[])
     if(argc < 7)
     {
         printf("arg1 to 6: layout, algo, do_verification, init_method, do_log, nrepeat\n");
+        printf("optional: --seed <value> for random initialization\n");
         exit(1);
     }
 
@@ -208,25 +215,25 @@ int main(int argc, char* argv[])
         break;
     case 2:
         in.GenerateTensorValue(GeneratorTensor_1{}, num_thread);
-        out.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        out.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed + 1}, num_thread);
         break;
     case 3:
-        in.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        in.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed}, num_thread);
         out.GenerateTensorValue(GeneratorTensor_1{}, num_thread);
         break;
     case 4:
-        in.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
-        out.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        in.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed}, num_thread);
+        out.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed + 1}, num_thread);
         break;
     case 5:
-        in.GenerateTensorValue(GeneratorTensor_3<float>{-0.1, 0.1}, num_thread);
-        out.GenerateTensorValue(GeneratorTensor_3<float>{-0.1, 0.1}, num_thread);
+        in.GenerateTensorValue(GeneratorTensor_3<float>{-0.1, 0.1, seed}, num_thread);
+        out.GenerateTensorValue(GeneratorTensor_3<float>{-0.1, 0.1, seed + 1}, num_thread);
         break;
     default:
-        in.GenerateTensorValue(GeneratorTensor_2{1, 5}, num_thread);
+        in.GenerateTensorValue(GeneratorTensor_2{1, 5, seed}, num_thread);
 
-        auto gen_out = [](auto... is) {
-            return GeneratorTensor_2{1, 5}(is...) * GeneratorTensor_Checkboard{}(is...);
+        auto gen_out = [=](auto... is) {
+            return GeneratorTensor_2{1, 5, seed + 1}(is...) * GeneratorTensor_Checkboard{}(is...);
         };
         out.GenerateTensorValue(gen_out, num_thread);
     }
@@ -414,16 +421,28 @@ int main(int argc, char* argv[])
 
     if(do_verification)
     {
-        host_direct_convolution_backward_weights(out,
-                                                 in,
-                                                 wei_host,
-                                                 make_tuple(conv_stride_h, conv_stride_w),
-                                                 make_tuple(conv_dilation_h, conv_dilation_w),
-                                                 make_tuple(in_left_pad_h, in_left_pad_w),
-                                                 make_tuple(in_right_pad_h, in_right_pad_w),
-                                                 layout);
-
-        check_error(wei_host, wei_device);
+        host_conv_bwd_weight_implicit_gemm(out,
+                                           in,
+                                           wei_host,
+                                           make_tuple(conv_stride_h, conv_stride_w),
+                                           make_tuple(conv_dilation_h, conv_dilation_w),
+                                           make_tuple(in_left_pad_h, in_left_pad_w),
+                                           make_tuple(in_right_pad_h, in_right_pad_w),
+                                           layout);
+
+        // the sums of |out * in|, they scale the tolerance of the N * Ho * Wo long sums
+        Tensor<wei_data_t> wei_abs_sum(wei_host.mDesc);
+
+        host_conv_bwd_weight_implicit_gemm(make_abs_host_tensor(out),
+                                           make_abs_host_tensor(in),
+                                           wei_abs_sum,
+                                           make_tuple(conv_stride_h, conv_stride_w),
+                                           make_tuple(conv_dilation_h, conv_dilation_w),
+                                           make_tuple(in_left_pad_h, in_left_pad_w),
+                                           make_tuple(in_right_pad_h, in_right_pad_w),
+                                           layout);
+
+        check_error(wei_host, wei_device, wei_abs_sum, static_cast<std::size_t>(N) * Ho * Wo);
 
         if(do_log)
         {
@@ -10,8 +10,10 @@
 #include "device.hpp"
 #include "host_tensor.hpp"
 #include "host_tensor_generator.hpp"
+#include "host_tensor_compare.hpp"
 #include "gemm_common.hpp"
 #include "host_gemm.hpp"
+#include "host_gemm_packed.hpp"
 #include "device_tensor.hpp"
 #include "device_gemm_xdlops_mk_kn_mn.hpp"
 #include "device_gemm_xdlops_mk_nk_mn.hpp"
@@ -47,9 +49,13 @@ int main(int argc, char* argv[])
 {
     using namespace ck;
 
+    // "--seed <value>" may appear anywhere, it is removed before positional parsing
+    const std::uint64_t seed = get_seed_from_args(argc, argv);
+
     if(argc != 12)
     {
         printf("arg1 to 6: layout, algo, do_verification, init_method, do_log, nrepeat\n");
+        printf("optional: --seed <value> for random initialization\n");
         printf("rest: M, N, K\n");
         printf("debug_driver_gemm_xdlops_v2r3::M01, debug_driver_gemm_xdlops_v2r3::N01\n");
         exit(1);
@@ -160,19 +166,19 @@ int main(int argc, char* argv[])
         break;
     case 2:
         a.GenerateTensorValue(GeneratorTensor_1{}, num_thread);
-        b.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        b.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed + 1}, num_thread);
         break;
     case 3:
-        a.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        a.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed}, num_thread);
         b.GenerateTensorValue(GeneratorTensor_1{}, num_thread);
         break;
     case 4:
-        a.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
-        b.GenerateTensorValue(GeneratorTensor_2{-5, 5}, num_thread);
+        a.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed}, num_thread);
+        b.GenerateTensorValue(GeneratorTensor_2{-5, 5, seed + 1}, num_thread);
         break;
     default:
-        a.GenerateTensorValue(GeneratorTensor_3<float>{0.0, 1.0}, num_thread);
-        b.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5}, num_thread);
+        a.GenerateTensorValue(GeneratorTensor_3<float>{0.0, 1.0, seed}, num_thread);
+        b.GenerateTensorValue(GeneratorTensor_3<float>{-0.5, 0.5, seed + 1}, num_thread);
     }
 
 #if USE_GEMM_XDL_MK_KN_MN
@@ -273,9 +279,14 @@ int main(int argc, char* argv[])
 
     if(do_verification)
     {
-        host_gemm(a, b, c_host, layout);
+        host_gemm_packed(a, b, c_host, layout);
+
+        // the sums of |a * b|, they scale the tolerance of the K long sums
+        Tensor<c_data_t> c_abs_sum(c_host.mDesc);
+
+        host_gemm_packed(make_abs_host_tensor(a), make_abs_host_tensor(b), c_abs_sum, layout);
 
-        check_error(c_host, c_device);
+        check_error(c_host, c_device, c_abs_sum, static_cast<std::size_t>(K));
 
         if(do_log)
         {
@@ -0,0 +1,277 @@
+#include <iostream>
+#include <numeric>
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+#include <stdlib.h>
+#include <limits>
+#include <string>
+#include <random>
+#include "host_tensor.hpp"
+#include "host_tensor_compare.hpp"
+#include "host_gemm_packed.hpp"
+
+// every tensor shape is checked with one thread and with the thread pool
+const std::vector<std::size_t> num_threads = {1, 4};
+
+// counts the calls of every host tensor functor over lens, returns false if a count is not the
+// element count of lens
+template <typename... Xs>
+bool check_functor_call_count(Xs... xs)
+{
+    const std::vector<std::size_t> lens = {static_cast<std::size_t>(xs)...};
+
+    const std::size_t size = std::accumulate(
+        lens.begin(), lens.end(), std::size_t{1}, std::multiplies<std::size_t>());
+
+    bool pass = true;
+
+    auto check = [&](const char* name, std::size_t num_thread, std::size_t num_call) {
+        if(num_call == size)
+            return;
+
+        std::cout << name << " with " << num_thread << " thread(s) over {";
+        LogRange(std::cout, lens, ", ") << "}: " << num_call << " calls, expect " << size
+                                        << std::endl;
+
+        pass = false;
+    };
+
+    for(auto num_thread : num_threads)
+    {
+        std::atomic<std::size_t> num_call{0};
+
+        make_ParallelTensorFunctor([&](auto...) { ++num_call; }, xs...)(num_thread);
+        check("ParallelTensorFunctor", num_thread, num_call);
+
+        num_call = 0;
+        make_ParallelTensorTileFunctor([&](const auto&, std::size_t n) { num_call += n; },
+                                       xs...)(num_thread);
+        check("ParallelTensorTileFunctor", num_thread, num_call);
+
+        Tensor<float> a(lens);
+        Tensor<float> b(lens);
+        Tensor<float> c(lens);
+
+        num_call = 0;
+        a.Generate([&](auto...) { return static_cast<float>(++num_call); }, num_thread);
+        check("Tensor::Generate", num_thread, num_call);
+
+        num_call = 0;
+        a.ForEach([&](auto&, auto...) { ++num_call; }, num_thread);
+        check("Tensor::ForEach", num_thread, num_call);
+
+        num_call = 0;
+        b.Transform(a, [&](float x) { return ++num_call, x; }, num_thread);
+        check("Tensor::Transform", num_thread, num_call);
+
+        num_call = 0;
+        c.Zip(a, b, [&](float x, float y) { return ++num_call, x + y; }, num_thread);
+        check("Tensor::Zip", num_thread, num_call);
+    }
+
+    return pass;
+}
+
+// checks the |diff| histogram bins of compare_host_tensor on and around the edges documented at
+// HostTensorCompareResult, returns false if a diff lands in a wrong bin
+bool check_compare_bins()
+{
+    using host_tensor_compare_detail::get_bin;
+
+    constexpr std::size_t NumBin = HostTensorCompareResult::NumBin;
+
+    bool pass = true;
+
+    auto check = [&](double diff, std::size_t expect) {
+        const std::size_t bin = get_bin(diff);
+
+        if(bin == expect)
+            return;
+
+        std::cout << "get_bin(" << diff << "): " << bin << ", expect " << expect << std::endl;
+
+        pass = false;
+    };
+
+    check(0, 0);
+    check(std::numeric_limits<double>::denorm_min(), 1);
+    check(std::numeric_limits<double>::quiet_NaN(), NumBin - 1);
+    check(std::numeric_limits<double>::infinity(), NumBin - 1);
+
+    // the edge of bin b is 1e(b - 11), as printed by ostream_HostTensorCompareResult
+    for(std::size_t b = 1; b + 1 < NumBin; ++b)
+    {
+        const double edge = std::stod("1e" + std::to_string(static_cast<int>(b) - 11));
+
+        check(edge, b);
+        check(edge * 0.999, b);
+        check(edge * 1.001, b + 1);
+    }
+
+    return pass;
+}
+
+// compare_host_tensor with a scale tensor, packed and as a transposed view: the diffs are just
+// inside mScale * scale but for one element just outside, which must be the only mismatch
+bool check_compare_scale()
+{
+    const std::size_t M = 3, N = 700, bad_m = 2, bad_n = 517;
+
+    Tensor<float> ref({M, N});
+    Tensor<float> result({M, N});
+    Tensor<double> scale({M, N});
+    Tensor<double> scale_t({N, M});
+
+    HostTensorCompareOptions options;
+
+    options.mTolerance = HostTensorTolerance{0, 0, 0, 1e-3};
+
+    for(std::size_t m = 0; m < M; ++m)
+    {
+        for(std::size_t n = 0; n < N; ++n)
+        {
+            const double f = m == bad_m && n == bad_n ? 1.01 : 0.99;
+
+            scale(m, n)   = (m * N + n) % 7 + 1;
+            scale_t(n, m) = scale(m, n);
+            ref(m, n)     = float(m) - float(n) / 64;
+            result(m, n)  = ref(m, n) + f * options.mTolerance.mScale * scale(m, n);
+        }
+    }
+
+    bool pass = true;
+
+    for(bool transposed : {false, true})
+    {
+        const auto res =
+            transposed
+                ? compare_host_tensor(
+                      ref, result, scale_t.View().Permute(std::vector<std::size_t>{1, 0}), options)
+                : compare_host_tensor(ref, result, scale, options);
+
+        if(res.mNumMismatch != 1 || res.mMismatches.size() != 1 ||
+           res.mMismatches[0].mIndex != std::vector<std::size_t>{bad_m, bad_n})
+        {
+            std::cout << "compare with " << (transposed ? "transposed " : "") << "scale: "
+                      << res.mNumMismatch << " mismatches, expect 1 at {" << bad_m << ", "
+                      << bad_n << "}" << std::endl;
+
+            pass = false;
+        }
+    }
+
+    // without the scale every element is a mismatch
+    if(compare_host_tensor(ref, result, options).mNumMismatch != M * N)
+    {
+        std::cout << "compare without scale: not every element a mismatch" << std::endl;
+
+        pass = false;
+    }
+
+    return pass;
+}
+
+// the int8 micro-kernels of host_gemm_packed against the portable one, which must agree
+// exactly: K is not a multiple of KPack and spans several KC blocks, M and N are not multiples
+// of MR and NR, and the values include -128 and 127. Kernels the host CPU lacks are skipped
+bool check_gemm_int8()
+{
+    using namespace host_gemm_detail;
+
+    const std::size_t M = 37, N = 45, K = 1031;
+
+    std::vector<std::int8_t> a(M * K);
+    std::vector<std::int8_t> b(N * K);
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dis(-128, 127);
+
+    for(auto& x : a)
+        x = static_cast<std::int8_t>(dis(gen));
+    for(auto& x : b)
+        x = static_cast<std::int8_t>(dis(gen));
+
+    a[0] = b[0] = -128;
+    a[1] = b[1] = 127;
+
+    // A as M x K row-major, B as N x K column-major
+    const GemmOperandStrided<std::int8_t> a_op{a.data(), K, 1};
+    const GemmOperandStrided<std::int8_t> b_op{b.data(), 1, N};
+
+    std::vector<std::int32_t> c_ref(M * N);
+
+    gemm_packed<MicroKernelGeneric<std::int32_t, 4, 16>>(
+        a_op, b_op, GemmOutputStrided<std::int32_t>{c_ref.data(), N, 1}, M, N, K, 1);
+
+    bool pass = true;
+
+    auto f_check = [&](auto kernel, const char* name) {
+        using Kernel = decltype(kernel);
+
+        for(std::size_t num_thread : num_threads)
+        {
+            std::vector<std::int32_t> c(M * N);
+
+            gemm_packed<Kernel>(
+                a_op, b_op, GemmOutputStrided<std::int32_t>{c.data(), N, 1}, M, N, K, num_thread);
+
+            std::size_t num_mismatch = 0;
+
+            for(std::size_t i = 0; i < M * N; ++i)
+                num_mismatch += c[i] != c_ref[i];
+
+            if(num_mismatch != 0)
+            {
+                std::cout << name << " with " << num_thread << " threads: " << num_mismatch
+                          << " elements differ from the portable kernel" << std::endl;
+
+                pass = false;
+            }
+        }
+    };
+
+#if HOST_GEMM_X86_DISPATCH
+    if(__builtin_cpu_supports("avx512vnni"))
+        f_check(MicroKernelAvx512VnniInt8{}, "avx512 vnni int8");
+    else
+        std::cout << "avx512 vnni int8: skipped, not supported by the CPU" << std::endl;
+
+    if(__builtin_cpu_supports("avx2"))
+        f_check(MicroKernelAvx2Int8{}, "avx2 int8");
+    else
+        std::cout << "avx2 int8: skipped, not supported by the CPU" << std::endl;
+#endif
+
+    return pass;
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc != 1)
+    {
+        printf("no argument, checks the host tensor utilities\n");
+        exit(1);
+    }
+
+    bool pass = true;
+
+    // empty tensors, with the empty dimension outermost, innermost and in between
+    pass &= check_functor_call_count(0);
+    pass &= check_functor_call_count(0, 4);
+    pass &= check_functor_call_count(3, 0);
+    pass &= check_functor_call_count(2, 0, 5);
+
+    // tensors with several chunks and tiles
+    pass &= check_functor_call_count(1000);
+    pass &= check_functor_call_count(3, 1500);
+    pass &= check_functor_call_count(7, 5, 300, 11);
+
+    pass &= check_compare_bins();
+    pass &= check_compare_scale();
+    pass &= check_gemm_int8();
+
+    std::cout << (pass ? "PASS" : "FAIL") << std::endl;
+
+    return pass ? 0 : 1;
+}
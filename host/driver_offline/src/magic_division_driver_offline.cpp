@@ -0,0 +1,453 @@
+#include <iostream>
+#include <numeric>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <stdlib.h>
+#include "config.hpp"
+#include "common_header.hpp"
+#include "magic_division.hpp"
+#include "multi_index_transform_helper.hpp"
+#include "host_thread_pool.hpp"
+#include "host_tensor_generator.hpp"
+
+using namespace ck;
+
+// random dividends checked for each divisor, on top of the edge cases
+constexpr index_t NumRandomDividend = 16;
+
+constexpr index_t NumEdgeDividend = 20;
+
+// all divisors below it are checked when not checking all of them, then the divisors around each
+// power of 2 and as many random ones
+constexpr uint32_t NumSmallDivisor = 1U << 20;
+
+// i-th divisor of the sampled set
+uint32_t get_sampled_divisor(std::size_t i, std::uint64_t seed)
+{
+    if(i < NumSmallDivisor)
+        return i + 1;
+
+    i -= NumSmallDivisor;
+
+    // 2^k - 1, 2^k, 2^k + 1 for k in [20, 31], and 2^32 - 1
+    if(i < 12 * 3 + 1)
+        return i == 12 * 3 ? std::numeric_limits<uint32_t>::max()
+                           : (1U << (20 + i / 3)) + i % 3 - 1;
+
+    i -= 12 * 3 + 1;
+
+    return std::max<uint32_t>(host_rng_hash(seed, i) >> 32, 1);
+}
+
+std::size_t get_num_sampled_divisor() { return 2 * std::size_t{NumSmallDivisor} + 12 * 3 + 1; }
+
+// floor and ceil of n / d as the reference
+int64_t floor_div(int64_t n, int64_t d) { return n / d - (n % d != 0 && n < 0 ? 1 : 0); }
+
+int64_t ceil_div(int64_t n, int64_t d) { return n / d + (n % d != 0 && n > 0 ? 1 : 0); }
+
+// check every magic division of a set of dividends by divisor, return the number of wrong results
+std::size_t check_magic_division(uint32_t divisor, std::uint64_t seed, std::atomic<int>& num_log)
+{
+    const auto magic = MagicDivision::CalculateMagicNumbers(divisor);
+
+    const uint32_t multiplier = magic[Number<0>{}];
+    const uint32_t shift      = magic[Number<1>{}];
+
+    const uint32_t max_multiple = std::numeric_limits<uint32_t>::max() / divisor * divisor;
+
+    // as uint32_t, and the same bits as int32_t, where the ones from 2^31 on are negative
+    uint32_t dividends[NumEdgeDividend + NumRandomDividend] = {0,
+                                                               1,
+                                                               2,
+                                                               divisor - 1,
+                                                               divisor,
+                                                               divisor + 1,
+                                                               2 * divisor - 1,
+                                                               2 * divisor,
+                                                               max_multiple - 1,
+                                                               max_multiple,
+                                                               0xffffffffU,
+                                                               0xfffffffeU,
+                                                               0x7fffffffU,
+                                                               0x80000000U,
+                                                               0x80000001U,
+                                                               0x7fffffffU / divisor * divisor,
+                                                               0U - divisor,
+                                                               0U - divisor - 1,
+                                                               0U - divisor + 1,
+                                                               0U - 2 * divisor};
+
+    for(index_t i = 0; i < NumRandomDividend; ++i)
+        dividends[NumEdgeDividend + i] = host_rng_hash(seed, divisor, i) >> 32;
+
+    std::size_t num_error = 0;
+
+    auto check = [&](const char* name, int64_t dividend, int64_t result, int64_t ref) {
+        if(result != ref)
+        {
+            if(num_log++ < 32)
+                std::cout << name << ": " << dividend << " / " << divisor << " = " << result
+                          << ", should be " << ref << std::endl;
+
+            ++num_error;
+        }
+    };
+
+    for(uint32_t dividend : dividends)
+    {
+        check("DoMagicDivision(uint32_t)",
+              dividend,
+              MagicDivision::DoMagicDivision(dividend, multiplier, shift),
+              floor_div(dividend, divisor));
+
+        check("DoMagicDivisionCeil(uint32_t)",
+              dividend,
+              MagicDivision::DoMagicDivisionCeil(dividend, multiplier, shift),
+              ceil_div(dividend, divisor));
+
+        // int32_t divisors are positive
+        if(divisor > 0x7fffffffU)
+            continue;
+
+        const int32_t dividend_i32 = as_type<int32_t>(dividend);
+
+        check("DoMagicDivision(int32_t)",
+              dividend_i32,
+              MagicDivision::DoMagicDivision(dividend_i32, multiplier, shift),
+              floor_div(dividend_i32, divisor));
+
+        check("DoMagicDivisionCeil(int32_t)",
+              dividend_i32,
+              MagicDivision::DoMagicDivisionCeil(dividend_i32, multiplier, shift),
+              ceil_div(dividend_i32, divisor));
+
+        if(dividend_i32 >= 0)
+            check("DoMagicDivisionNonNegative",
+                  dividend_i32,
+                  MagicDivision::DoMagicDivisionNonNegative(dividend_i32, multiplier, shift),
+                  floor_div(dividend_i32, divisor));
+    }
+
+    return num_error;
+}
+
+// lower index of every step-th upper index, by CalculateLowerIndex from scratch, or by
+// UpdateLowerIndex from the previous one as in move_tensor_coordinate. step is index_t or Number<>,
+// for a step known at compile time. Returns the average time in ns per index, and the sum of all
+// lower indices as checksum
+template <typename Merge, typename Step>
+double run_merge(const Merge& merge, bool is_update, Step step, int nrepeat, int64_t& checksum)
+{
+    using LowerIndex = typename Merge::LowerIndex;
+    using UpperIndex = typename Merge::UpperIndex;
+
+    const index_t up_length = merge.GetUpperLengths()[Number<0>{}];
+
+    const auto idx_diff_up = make_multi_index(step);
+
+    // a step known at compile time is positive here, so it takes the carry-only step hack, as the
+    // kernels do when moving their slice windows forward
+    constexpr index_t Hack = std::is_same<Step, index_t>::value ? 0 : 1;
+
+    std::size_t num_index = 0;
+
+    auto run = [&]() {
+        LowerIndex idx_low;
+        LowerIndex idx_diff_low;
+
+        checksum  = 0;
+        num_index = 0;
+
+        merge.CalculateLowerIndex(idx_low, make_multi_index(0));
+
+        for(index_t up = step; up < up_length; up += step)
+        {
+            const UpperIndex idx_up = make_multi_index(up);
+
+            if(is_update)
+                merge.UpdateLowerIndex(idx_diff_low, idx_diff_up, idx_low, idx_up, Number<Hack>{});
+            else
+                merge.CalculateLowerIndex(idx_low, idx_up);
+
+            static_for<0, LowerIndex::Size(), 1>{}([&](auto i) { checksum += idx_low[i]; });
+
+            ++num_index;
+        }
+    };
+
+    // warm up
+    run();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for(int i = 0; i < nrepeat; ++i)
+        run();
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           (std::max(nrepeat, 1) * std::max<std::size_t>(num_index, 1));
+}
+
+template <typename LowLengths>
+bool benchmark_merge(const LowLengths& low_lengths, index_t step, int nrepeat)
+{
+    const auto merge_v1   = make_merge_transform_v1_carry_check(low_lengths);
+    const auto merge_v2   = Merge_v2_magic_division<LowLengths>{low_lengths};
+    const auto merge_v2r2 = Merge_v2r2_magic_division<LowLengths>{low_lengths};
+    const auto merge_v3   = make_merge_transform_v3_division_mod(low_lengths);
+
+    bool pass = true;
+
+    for(bool is_update : {false, true})
+    {
+        std::cout << (is_update ? "UpdateLowerIndex" : "CalculateLowerIndex") << std::endl;
+
+        int64_t checksum_ref = 0;
+
+        // v3 first, as reference
+        const double ave_time_v3 = run_merge(merge_v3, is_update, step, nrepeat, checksum_ref);
+
+        auto report = [&](const char* name, double ave_time, int64_t checksum) {
+            std::cout << "    " << name << ": " << ave_time << " ns";
+
+            if(checksum != checksum_ref)
+            {
+                std::cout << ", wrong! checksum " << checksum << ", should be " << checksum_ref;
+                pass = false;
+            }
+
+            std::cout << std::endl;
+        };
+
+        auto run_and_report = [&](const char* name, const auto& merge) {
+            int64_t checksum = 0;
+
+            const double ave_time = run_merge(merge, is_update, step, nrepeat, checksum);
+
+            report(name, ave_time, checksum);
+        };
+
+        run_and_report("Merge_v1_carry_check", merge_v1);
+        run_and_report("Merge_v2_magic_division", merge_v2);
+        run_and_report("Merge_v2r2_magic_division", merge_v2r2);
+        report("Merge_v3_division_mod", ave_time_v3, checksum_ref);
+    }
+
+    return pass;
+}
+
+// ns per lowering of each Merge variant, for the cost table of make_merge_transform_auto: moved by
+// UpdateLowerIndex by a step known at compile time, as the slice windows of the kernels, and
+// calculated by CalculateLowerIndex from an index known only at run time, as the ones from the
+// block and thread id
+template <typename LowLengths>
+void measure_merge_cost(const LowLengths& low_lengths,
+                        index_t step,
+                        int nrepeat,
+                        double (&cost_known_step)[4],
+                        double (&cost_unknown_step)[4])
+{
+    const auto merge_v1   = make_merge_transform_v1_carry_check(low_lengths);
+    const auto merge_v2   = Merge_v2_magic_division<LowLengths>{low_lengths};
+    const auto merge_v2r2 = Merge_v2r2_magic_division<LowLengths>{low_lengths};
+    const auto merge_v3   = make_merge_transform_v3_division_mod(low_lengths);
+
+    constexpr auto known_step = Number<8>{};
+
+    int64_t checksum = 0;
+
+    cost_known_step[0] = run_merge(merge_v1, true, known_step, nrepeat, checksum);
+    cost_known_step[1] = run_merge(merge_v2, true, known_step, nrepeat, checksum);
+    cost_known_step[2] = run_merge(merge_v2r2, true, known_step, nrepeat, checksum);
+    cost_known_step[3] = run_merge(merge_v3, true, known_step, nrepeat, checksum);
+
+    cost_unknown_step[0] = run_merge(merge_v1, false, step, nrepeat, checksum);
+    cost_unknown_step[1] = run_merge(merge_v2, false, step, nrepeat, checksum);
+    cost_unknown_step[2] = run_merge(merge_v2r2, false, step, nrepeat, checksum);
+    cost_unknown_step[3] = run_merge(merge_v3, false, step, nrepeat, checksum);
+}
+
+// cost table of make_merge_transform_auto, printed as in get_merge_transform_cost(). Each entry is
+// the mean over a merge shaped as N, Ho, Wo and one shaped as C, Y, X
+void print_merge_cost_table(int nrepeat)
+{
+    // run-time step of the same value as the compile-time one, the compiler cannot see through it
+    volatile index_t step_volatile = 8;
+
+    const index_t step = step_volatile;
+
+    // [is_step_known][is_lengths_known][NDimLow - 2][variant]
+    double cost[2][2][3][4] = {};
+
+    // the fastest of a few trials, the slower ones were disturbed by other work
+    constexpr index_t NumTrial = 5;
+
+    auto add = [&](index_t is_lengths_known, index_t ndim, const auto& low_lengths) {
+        double cost_known_step[4]   = {};
+        double cost_unknown_step[4] = {};
+
+        for(index_t trial = 0; trial < NumTrial; ++trial)
+        {
+            double cost_known_step_trial[4];
+            double cost_unknown_step_trial[4];
+
+            measure_merge_cost(
+                low_lengths, step, nrepeat, cost_known_step_trial, cost_unknown_step_trial);
+
+            for(index_t i = 0; i < 4; ++i)
+            {
+                cost_known_step[i] = trial == 0
+                                         ? cost_known_step_trial[i]
+                                         : std::min(cost_known_step[i], cost_known_step_trial[i]);
+                cost_unknown_step[i] =
+                    trial == 0 ? cost_unknown_step_trial[i]
+                               : std::min(cost_unknown_step[i], cost_unknown_step_trial[i]);
+            }
+        }
+
+        for(index_t i = 0; i < 4; ++i)
+        {
+            cost[1][is_lengths_known][ndim - 2][i] += 0.5 * cost_known_step[i];
+            cost[0][is_lengths_known][ndim - 2][i] += 0.5 * cost_unknown_step[i];
+        }
+    };
+
+    add(0, 2, make_tuple(index_t{128}, index_t{784}));
+    add(0, 2, make_tuple(index_t{256}, index_t{9}));
+    add(0, 3, make_tuple(index_t{128}, index_t{28}, index_t{28}));
+    add(0, 3, make_tuple(index_t{256}, index_t{3}, index_t{3}));
+    add(0, 4, make_tuple(index_t{2}, index_t{64}, index_t{28}, index_t{28}));
+    add(0, 4, make_tuple(index_t{2}, index_t{128}, index_t{3}, index_t{3}));
+
+    add(1, 2, make_tuple(Number<128>{}, Number<784>{}));
+    add(1, 2, make_tuple(Number<256>{}, Number<9>{}));
+    add(1, 3, make_tuple(Number<128>{}, Number<28>{}, Number<28>{}));
+    add(1, 3, make_tuple(Number<256>{}, Number<3>{}, Number<3>{}));
+    add(1, 4, make_tuple(Number<2>{}, Number<64>{}, Number<28>{}, Number<28>{}));
+    add(1, 4, make_tuple(Number<2>{}, Number<128>{}, Number<3>{}, Number<3>{}));
+
+    for(index_t is_step_known = 0; is_step_known < 2; ++is_step_known)
+    {
+        printf("{");
+
+        for(index_t is_lengths_known = 0; is_lengths_known < 2; ++is_lengths_known)
+        {
+            printf(is_lengths_known > 0 ? ", {" : "{");
+
+            for(index_t ndim = 0; ndim < 3; ++ndim)
+            {
+                const double* p = cost[is_step_known][is_lengths_known][ndim];
+
+                printf(ndim > 0 ? ", " : "");
+                printf("{%.1f, %.1f, %.1f, %.1f}", p[0], p[1], p[2], p[3]);
+            }
+
+            printf("}");
+        }
+
+        printf("}\n");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // "--seed <value>" may appear anywhere, it is removed before positional parsing
+    const std::uint64_t seed = get_seed_from_args(argc, argv);
+
+    if(argc != 3 && (argc < 6 || argc > 8))
+    {
+        printf("arg1 to 2: do_verification (0: no, 1: sampled divisors, 2: all divisors), "
+               "nrepeat\n");
+        printf("optional: --seed <value> for the random divisors and dividends\n");
+        printf("rest: step, 2 to 4 lengths of the merged dimensions, e.g. N Ho Wo or C Y X\n");
+        printf("      or nothing, to print the cost table of make_merge_transform_auto\n");
+        exit(1);
+    }
+
+    const int do_verification = std::stoi(argv[1]);
+    const int nrepeat         = std::stoi(argv[2]);
+
+    bool pass = true;
+
+    if(do_verification)
+    {
+        const std::size_t num_divisor = do_verification == 2
+                                            ? std::size_t{std::numeric_limits<uint32_t>::max()}
+                                            : get_num_sampled_divisor();
+
+        auto& pool = HostThreadPool::GetInstance();
+
+        std::atomic<std::size_t> num_error{0};
+        std::atomic<int> num_log{0};
+
+        const auto start = std::chrono::steady_clock::now();
+
+        pool.ParallelFor(0,
+                         num_divisor,
+                         pool.GetNumThread() * HostThreadPool::ChunkPerThread,
+                         [&](std::size_t ib, std::size_t ie) {
+                             std::size_t num_error_chunk = 0;
+
+                             for(std::size_t i = ib; i < ie; ++i)
+                             {
+                                 const uint32_t divisor = do_verification == 2
+                                                              ? static_cast<uint32_t>(i + 1)
+                                                              : get_sampled_divisor(i, seed);
+
+                                 num_error_chunk += check_magic_division(divisor, seed, num_log);
+                             }
+
+                             num_error += num_error_chunk;
+                         });
+
+        const auto end = std::chrono::steady_clock::now();
+
+        std::cout << "magic division: " << num_divisor << " divisors, "
+                  << NumEdgeDividend + NumRandomDividend << " dividends each, " << num_error
+                  << " wrong results, "
+                  << std::chrono::duration<double>(end - start).count() << " s" << std::endl;
+
+        pass = pass && num_error == 0;
+    }
+
+    if(argc == 3)
+    {
+        print_merge_cost_table(nrepeat);
+
+        std::cout << (pass ? "pass" : "fail") << std::endl;
+
+        return pass ? 0 : 1;
+    }
+
+    const index_t step = std::stoi(argv[3]);
+
+    // runtime lengths, as the implicit-GEMM merges of N, Ho, Wo or C, Y, X
+    const index_t L0 = std::stoi(argv[4]);
+    const index_t L1 = std::stoi(argv[5]);
+
+    if(argc == 6)
+    {
+        pass = benchmark_merge(make_tuple(L0, L1), step, nrepeat) && pass;
+    }
+    else if(argc == 7)
+    {
+        const index_t L2 = std::stoi(argv[6]);
+
+        pass = benchmark_merge(make_tuple(L0, L1, L2), step, nrepeat) && pass;
+    }
+    else
+    {
+        const index_t L2 = std::stoi(argv[6]);
+        const index_t L3 = std::stoi(argv[7]);
+
+        pass = benchmark_merge(make_tuple(L0, L1, L2, L3), step, nrepeat) && pass;
+    }
+
+    std::cout << (pass ? "pass" : "fail") << std::endl;
+
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <cstdlib>
+#include <stdlib.h>
+#include "config.hpp"
+#include "common_header.hpp"
+#include "tensor_descriptor.hpp"
+#include "tensor_descriptor_helper.hpp"
+#include "transform_forward_convolution_into_gemm_v4r4_nchw_kcyx_nkhw.hpp"
+#include "transform_forward_convolution_into_gemm_v4r4r4_nhwc_kyxc_nhwk.hpp"
+
+using namespace ck;
+
+// make_merge_transform_auto by the cost table: carry-check for the merges moved by compile-time
+// steps, as GemmK, and magic division for the ones calculated from the block and thread id, as
+// GemmN, unless there are 4 lengths
+static_assert(get_merge_transform_variant(true, false, 3) == MergeTransformVariant_t::CarryCheck,
+              "wrong! C, Y, X merge");
+static_assert(get_merge_transform_variant(true, true, 3) == MergeTransformVariant_t::CarryCheck,
+              "wrong! compile-time C, Y, X merge");
+static_assert(get_merge_transform_variant(true, false, 4) == MergeTransformVariant_t::MagicDivision,
+              "wrong! 4-D merge");
+static_assert(get_merge_transform_variant(false, false, 3) ==
+                  MergeTransformVariant_t::MagicDivision,
+              "wrong! N, Ho, Wo merge");
+
+template <typename LowLengths, bool IsStepKnown>
+using merge_transform_auto_t = remove_cvref_t<decltype(make_merge_transform_auto(
+    std::declval<LowLengths>(), integral_constant<bool, IsStepKnown>{}))>;
+
+using MergeLowLengths = Tuple<index_t, index_t, index_t>;
+
+#if CK_EXPERIMENTAL_MERGE_TRANSFORM_AUTO
+static_assert(std::is_same<merge_transform_auto_t<MergeLowLengths, true>,
+                           Merge_v1_carry_check<MergeLowLengths>>::value,
+              "wrong! C, Y, X merge");
+static_assert(std::is_same<merge_transform_auto_t<MergeLowLengths, false>,
+                           Merge_v2_magic_division<MergeLowLengths>>::value,
+              "wrong! N, Ho, Wo merge");
+#else
+static_assert(std::is_same<merge_transform_auto_t<MergeLowLengths, false>,
+                           remove_cvref_t<decltype(make_merge_transform(
+                               std::declval<MergeLowLengths>()))>>::value,
+              "wrong! make_merge_transform_auto is make_merge_transform when switched off");
+#endif
+
+// a descriptor with nothing to flatten stores no affine map, it is its transforms and sizes only
+using NaiveDesc3d = remove_cvref_t<decltype(
+    make_naive_tensor_descriptor_packed(std::declval<Tuple<index_t, index_t, index_t>>()))>;
+
+static_assert(sizeof(NaiveDesc3d) == sizeof(NaiveDesc3d{}.GetTransforms()) + 2 * sizeof(index_t),
+              "wrong! a naive descriptor stores an empty affine map");
+
+// A random walk over desc: every step moves a coordinate with move_tensor_coordinate and makes one
+// from scratch with make_tensor_coordinate at the same index, which must agree on the validity and
+// offset. Returns false on a mismatch
+template <typename Desc>
+bool check_move_vs_make(const char* name, const Desc& desc)
+{
+    constexpr index_t NDim = Desc::GetNumOfDimension();
+
+    std::mt19937 gen(5);
+
+    index_t num_mismatch = 0;
+
+    for(index_t walk = 0; walk < 2000; ++walk)
+    {
+        MultiIndex<NDim> idx;
+
+        static_for<0, NDim, 1>{}([&](auto i) { idx(i) = gen() % desc.GetLength(i); });
+
+        auto coord = make_tensor_coordinate(desc, idx);
+
+        for(index_t s = 0; s < 20; ++s)
+        {
+            // steps of -2 to 2 along about half of the dimensions, staying inside the lengths
+            MultiIndex<NDim> idx_diff;
+
+            static_for<0, NDim, 1>{}([&](auto i) {
+                index_t d = gen() % 2 ? 0 : static_cast<index_t>(gen() % 5) - 2;
+
+                if(idx[i] + d < 0 || idx[i] + d >= desc.GetLength(i))
+                    d = 0;
+
+                idx_diff(i) = d;
+                idx(i) += d;
+            });
+
+            move_tensor_coordinate(desc, coord, make_tensor_coordinate_step(desc, idx_diff));
+
+            const auto coord_ref = make_tensor_coordinate(desc, idx);
+
+            const bool valid =
+                coordinate_has_valid_offset_assuming_visible_index_is_valid(desc, coord);
+            const bool valid_ref =
+                coordinate_has_valid_offset_assuming_visible_index_is_valid(desc, coord_ref);
+
+            if(valid != valid_ref || (valid && coord.GetOffset() != coord_ref.GetOffset()))
+                ++num_mismatch;
+        }
+    }
+
+    if(num_mismatch != 0)
+    {
+        std::cout << name << ": " << num_mismatch << " moved coordinates differ from made ones"
+                  << std::endl;
+    }
+
+    return num_mismatch == 0;
+}
+
+// Every (GemmK, GemmN) of the padded NCHW implicit-GEMM B descriptor against the input element
+// that im2col reads, or the padding. Returns false on a mismatch
+template <typename Desc>
+bool check_nchw_gemmk_gemmn(const Desc& desc,
+                            index_t N,
+                            index_t C,
+                            index_t Hi,
+                            index_t Wi,
+                            index_t Y,
+                            index_t X,
+                            index_t Ho,
+                            index_t Wo,
+                            index_t sh,
+                            index_t sw,
+                            index_t dh,
+                            index_t dw,
+                            index_t ph,
+                            index_t pw)
+{
+    index_t num_mismatch = 0;
+
+    for(index_t k = 0; k < C * Y * X; ++k)
+    {
+        for(index_t n = 0; n < N * Ho * Wo; ++n)
+        {
+            const index_t c  = k / (Y * X);
+            const index_t y  = k / X % Y;
+            const index_t x  = k % X;
+            const index_t hi = n / Wo % Ho * sh + y * dh - ph;
+            const index_t wi = n % Wo * sw + x * dw - pw;
+
+            const bool valid_ref = hi >= 0 && hi < Hi && wi >= 0 && wi < Wi;
+
+            const auto coord = make_tensor_coordinate(desc, make_multi_index(k, n));
+
+            const bool valid =
+                coordinate_has_valid_offset_assuming_visible_index_is_valid(desc, coord);
+
+            if(valid != valid_ref ||
+               (valid && coord.GetOffset() != ((n / (Ho * Wo) * C + c) * Hi + hi) * Wi + wi))
+                ++num_mismatch;
+        }
+    }
+
+    if(num_mismatch != 0)
+    {
+        std::cout << "v4r4 nchw b: " << num_mismatch << " offsets differ from im2col" << std::endl;
+    }
+
+    return num_mismatch == 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc != 1)
+    {
+        printf("no argument, checks the tensor coordinates of convolution descriptors\n");
+        exit(1);
+    }
+
+    // strided, dilated and padded, so Embed and Pad both matter
+    const index_t N = 2, C = 3, Hi = 7, Wi = 6, K = 4, Y = 3, X = 2;
+    const index_t sh = 2, sw = 1, dh = 1, dw = 2, ph = 1, pw = 1;
+
+    const index_t Ho = (Hi + 2 * ph - dh * (Y - 1) - 1) / sh + 1;
+    const index_t Wo = (Wi + 2 * pw - dw * (X - 1) - 1) / sw + 1;
+
+    const auto conv_strides   = make_tuple(sh, sw);
+    const auto conv_dilations = make_tuple(dh, dw);
+    const auto in_pads        = make_tuple(ph, pw);
+
+    bool pass = true;
+
+    {
+        const auto descs = transform_forward_convolution_into_gemm_v4r4_nchw_kcyx_nkhw_pad(
+            make_naive_tensor_descriptor_packed(make_tuple(K, C, Y, X)),
+            make_naive_tensor_descriptor_packed(make_tuple(N, C, Hi, Wi)),
+            make_naive_tensor_descriptor_packed(make_tuple(N, K, Ho, Wo)),
+            conv_strides,
+            conv_dilations,
+            in_pads,
+            in_pads);
+
+        pass &= check_move_vs_make("v4r4 nchw a", descs[Number<0>{}]);
+        pass &= check_move_vs_make("v4r4 nchw b", descs[Number<1>{}]);
+        pass &= check_move_vs_make("v4r4 nchw c", descs[Number<2>{}]);
+
+        pass &= check_nchw_gemmk_gemmn(
+            descs[Number<1>{}], N, C, Hi, Wi, Y, X, Ho, Wo, sh, sw, dh, dw, ph, pw);
+    }
+
+    {
+        const auto descs = transform_forward_convolution_into_gemm_v4r4r4_nhwc_kyxc_nhwk_pad(
+            make_naive_tensor_descriptor_packed(make_tuple(N, Hi, Wi, C)),
+            make_naive_tensor_descriptor_packed(make_tuple(K, Y, X, C)),
+            make_naive_tensor_descriptor_packed(make_tuple(N, Ho, Wo, K)),
+            conv_strides,
+            conv_dilations,
+            in_pads,
+            in_pads,
+            Number<1>{});
+
+        pass &= check_move_vs_make("v4r4r4 nhwc a", descs[Number<0>{}]);
+        pass &= check_move_vs_make("v4r4r4 nhwc b", descs[Number<1>{}]);
+    }
+
+    {
+        // compile-time lengths, pads and strides
+        constexpr auto desc_0 =
+            make_naive_tensor_descriptor_packed(make_tuple(Number<3>{}, Number<8>{}));
+
+        constexpr auto desc_1 = transform_tensor_descriptor(
+            desc_0,
+            make_tuple(make_pass_through_transform(Number<3>{}),
+                       make_pad_transform(Number<8>{}, Number<2>{}, Number<1>{})),
+            make_tuple(Sequence<0>{}, Sequence<1>{}),
+            make_tuple(Sequence<0>{}, Sequence<1>{}));
+
+        constexpr auto desc_2 = transform_tensor_descriptor(
+            desc_1,
+            make_tuple(make_unmerge_transform(make_tuple(Number<3>{}, Number<1>{})),
+                       make_embed_transform(make_tuple(Number<4>{}, Number<4>{}),
+                                            make_tuple(Number<2>{}, Number<1>{}))),
+            make_tuple(Sequence<0>{}, Sequence<1>{}),
+            make_tuple(Sequence<0, 1>{}, Sequence<2, 3>{}));
+
+        pass &= check_move_vs_make("compile-time", desc_2);
+
+        // (2, 0, 3, 1) is (2, 3 * 2 + 1 - 2) of desc_0
+        const index_t offset = desc_2.CalculateOffset(make_multi_index(2, 0, 3, 1));
+
+        if(offset != 2 * 8 + 5)
+        {
+            std::cout << "compile-time: offset " << offset << ", expect " << 2 * 8 + 5
+                      << std::endl;
+
+            pass = false;
+        }
+    }
+
+    std::cout << (pass ? "PASS" : "FAIL") << std::endl;
+
+    return pass ? 0 : 1;
+}
@@ -9,7 +9,9 @@ enum ConvTensorLayout
     NHWC,
     CHWN,
     NCHWc,
-    NHWCc
+    NHWCc,
+    NCDHW,
+    NDHWC
 };
 
 template <typename... InDesc,
@@ -35,7 +37,8 @@ constexpr auto get_convolution_output_default_4d_tensor_descriptor(
 
     assert(in_desc.GetNumOfDimension() == 4);
     assert(wei_desc.GetNumOfDimension() == 4);
-    assert(in_desc.GetLength(I1) == wei_desc.GetLength(I1));
+    // a grouped weight has C / G channels
+    assert(in_desc.GetLength(I1) % wei_desc.GetLength(I1) == 0);
 
     const auto N  = in_desc.GetLength(I0);
     const auto Hi = in_desc.GetLength(I2);
@@ -60,6 +63,55 @@ constexpr auto get_convolution_output_default_4d_tensor_descriptor(
     return make_naive_tensor_descriptor_packed(make_tuple(N, K, Ho, Wo));
 }
 
+template <typename... InDesc,
+          typename... WeiDesc,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename LeftPads,
+          typename RightPads>
+constexpr auto get_convolution_output_default_5d_tensor_descriptor(
+    const ck::TensorDescriptor<InDesc...>& in_desc,
+    const ck::TensorDescriptor<WeiDesc...>& wei_desc,
+    const ConvStrides& conv_strides,
+    const ConvDilations conv_dilations,
+    const LeftPads& left_pads,
+    const RightPads& right_pads)
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+    constexpr auto I2 = Number<2>{};
+    constexpr auto I3 = Number<3>{};
+    constexpr auto I4 = Number<4>{};
+
+    assert(in_desc.GetNumOfDimension() == 5);
+    assert(wei_desc.GetNumOfDimension() == 5);
+
+    // a grouped weight has C / G channels
+    assert(in_desc.GetLength(I1) % wei_desc.GetLength(I1) == 0);
+
+    const auto N  = in_desc.GetLength(I0);
+    const auto Di = in_desc.GetLength(I2);
+    const auto Hi = in_desc.GetLength(I3);
+    const auto Wi = in_desc.GetLength(I4);
+
+    const auto K = wei_desc.GetLength(I0);
+    const auto Z = wei_desc.GetLength(I2);
+    const auto Y = wei_desc.GetLength(I3);
+    const auto X = wei_desc.GetLength(I4);
+
+    const auto ZEff = (Z - I1) * conv_dilations[I0] + I1;
+    const auto YEff = (Y - I1) * conv_dilations[I1] + I1;
+    const auto XEff = (X - I1) * conv_dilations[I2] + I1;
+
+    const auto Do = (Di + left_pads[I0] + right_pads[I0] - ZEff) / conv_strides[I0] + I1;
+    const auto Ho = (Hi + left_pads[I1] + right_pads[I1] - YEff) / conv_strides[I1] + I1;
+    const auto Wo = (Wi + left_pads[I2] + right_pads[I2] - XEff) / conv_strides[I2] + I1;
+
+    return make_naive_tensor_descriptor_packed(make_tuple(N, K, Do, Ho, Wo));
+}
+
 template <class InDesc, class WeiDesc, class OutDesc>
 constexpr std::size_t
 calculate_convolution_flops(const InDesc&, const WeiDesc& wei_desc, const OutDesc& out_desc)
@@ -76,6 +128,7 @@ calculate_convolution_flops(const InDesc&, const WeiDesc& wei_desc, const OutDes
     const index_t Ho = out_desc.GetLength(I2);
     const index_t Wo = out_desc.GetLength(I3);
 
+    // channels per group for a grouped weight
     const index_t C = wei_desc.GetLength(I1);
     const index_t Y = wei_desc.GetLength(I2);
     const index_t X = wei_desc.GetLength(I3);
@@ -83,4 +136,31 @@ calculate_convolution_flops(const InDesc&, const WeiDesc& wei_desc, const OutDes
     return std::size_t(2) * N * K * Ho * Wo * C * Y * X;
 }
 
+template <class InDesc, class WeiDesc, class OutDesc>
+constexpr std::size_t
+calculate_convolution_3d_flops(const InDesc&, const WeiDesc& wei_desc, const OutDesc& out_desc)
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+    constexpr auto I2 = Number<2>{};
+    constexpr auto I3 = Number<3>{};
+    constexpr auto I4 = Number<4>{};
+
+    const index_t N  = out_desc.GetLength(I0);
+    const index_t K  = out_desc.GetLength(I1);
+    const index_t Do = out_desc.GetLength(I2);
+    const index_t Ho = out_desc.GetLength(I3);
+    const index_t Wo = out_desc.GetLength(I4);
+
+    // channels per group for a grouped weight
+    const index_t C = wei_desc.GetLength(I1);
+    const index_t Z = wei_desc.GetLength(I2);
+    const index_t Y = wei_desc.GetLength(I3);
+    const index_t X = wei_desc.GetLength(I4);
+
+    return std::size_t(2) * N * K * Do * Ho * Wo * C * Z * Y * X;
+}
+
 #endif
@@ -5,8 +5,15 @@
 #include <functional>
 #include <thread>
 #include <chrono>
+#ifdef CK_CPU_TARGET
+#include <stdexcept>
+#include "config.hpp"
+#include "cpu_work_group.hpp"
+#include "host_thread_pool.hpp"
+#else
 #include "hip/hip_runtime.h"
 #include "hip/hip_fp16.h"
+#endif
 
 struct DeviceMem
 {
@@ -34,6 +41,37 @@ struct KernelTimer
     std::unique_ptr<KernelTimerImpl> impl;
 };
 
+#ifdef CK_CPU_TARGET
+// CPU target: "device" memory is host memory and kernels run on the host thread pool
+struct dim3
+{
+    dim3(unsigned x_ = 1, unsigned y_ = 1, unsigned z_ = 1) : x(x_), y(y_), z(z_) {}
+
+    unsigned x, y, z;
+};
+
+using device_stream_t = void*;
+
+// every workgroup is a task of the host thread pool, so idle threads steal workgroups from busy
+// ones, and its work-items are emulated by ck::CpuWorkGroup on the thread that runs it
+template <typename... Args, typename F>
+void launch_kernel(F kernel, dim3 grid_dim, dim3 block_dim, std::size_t, Args... args)
+{
+    if(grid_dim.y != 1 || grid_dim.z != 1 || block_dim.y != 1 || block_dim.z != 1)
+        throw std::runtime_error("wrong! only 1-D grid and workgroup are supported");
+
+    const ck::index_t grid_size  = grid_dim.x;
+    const ck::index_t block_size = block_dim.x;
+
+    auto run_kernel = [&] { kernel(args...); };
+
+    HostThreadPool::GetInstance().ParallelFor(
+        0, grid_size, grid_size, [&](std::size_t ib, std::size_t ie) {
+            for(std::size_t i = ib; i < ie; ++i)
+                ck::CpuWorkGroup::GetInstance().Run(i, block_size, grid_size, run_kernel);
+        });
+}
+#else
 using device_stream_t = hipStream_t;
 
 template <typename... Args, typename F>
@@ -43,6 +81,7 @@ void launch_kernel(F kernel, dim3 grid_dim, dim3 block_dim, std::size_t lds_byte
 
     hipLaunchKernelGGL(kernel, grid_dim, block_dim, lds_byte, stream_id, args...);
 }
+#endif
 
 template <typename... Args, typename F>
 float launch_and_time_kernel(
@@ -61,10 +100,8 @@ float launch_and_time_kernel(
 
     printf("Warm up\n");
 
-    hipStream_t stream_id = nullptr;
-
     // warm up
-    hipLaunchKernelGGL(kernel, grid_dim, block_dim, lds_byte, stream_id, args...);
+    launch_kernel(kernel, grid_dim, block_dim, lds_byte, args...);
 
     printf("Start running %d times...\n", nrepeat);
 
@@ -72,7 +109,7 @@ float launch_and_time_kernel(
 
     for(int i = 0; i < nrepeat; ++i)
     {
-        hipLaunchKernelGGL(kernel, grid_dim, block_dim, lds_byte, stream_id, args...);
+        launch_kernel(kernel, grid_dim, block_dim, lds_byte, args...);
     }
 
     timer.End();
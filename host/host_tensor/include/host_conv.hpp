@@ -1,16 +1,17 @@
 #pragma once
 #include "host_tensor.hpp"
 
-template <typename TIn,
-          typename TWei,
-          typename TOut,
+// in, wei and out can be Tensor or TensorView
+template <typename InTensor,
+          typename WeiTensor,
+          typename OutTensor,
           typename ConvStrides,
           typename ConvDilations,
           typename InLeftPads,
           typename InRightPads>
-void host_direct_convolution(const Tensor<TIn>& in,
-                             const Tensor<TWei>& wei,
-                             Tensor<TOut>& out,
+void host_direct_convolution(const InTensor& in,
+                             const WeiTensor& wei,
+                             OutTensor&& out,
                              const ConvStrides& conv_strides,
                              const ConvDilations& conv_dilations,
                              const InLeftPads& in_left_pads,
@@ -22,65 +23,155 @@ void host_direct_convolution(const Tensor<TIn>& in,
     constexpr auto I0 = Number<0>{};
     constexpr auto I1 = Number<1>{};
 
-    auto f_nchw = [&](auto n, auto k, auto ho, auto wo) {
-        double v = 0;
-        for(int c = 0; c < wei.mDesc.GetLengths()[1]; ++c)
+    // each run covers consecutive outputs along the last dimension, accumulated in blocks of
+    // AccBlock so the innermost loop is a unit-stride (or conv-stride) vectorizable loop
+    constexpr std::size_t AccBlock = 64;
+
+    // grouped convolution: wei holds C / G channels, output channel k reads input channels
+    // [g * C / G, (g + 1) * C / G) with g = k / (K / G)
+    const std::size_t c_dim = layout == ConvTensorLayout::NHWC ? 3 : 1;
+
+    const std::size_t CPerGroup = wei.mDesc.GetLengths()[c_dim];
+    const std::size_t G         = in.mDesc.GetLengths()[c_dim] / CPerGroup;
+    const std::size_t KPerGroup = wei.mDesc.GetLengths()[0] / G;
+
+    if(G * CPerGroup != in.mDesc.GetLengths()[c_dim] || G * KPerGroup != wei.mDesc.GetLengths()[0])
+        throw std::runtime_error("wrong! C and K must be multiples of the group count");
+
+    auto f_nchw = [&](const auto& idx, std::size_t run_length) {
+        const std::size_t n   = idx[0];
+        const std::size_t k   = idx[1];
+        const std::size_t ho  = idx[2];
+        const std::size_t wo0 = idx[3];
+
+        const int Hi = in.mDesc.GetLengths()[2];
+        const int Wi = in.mDesc.GetLengths()[3];
+
+        const int s_w = conv_strides[I1];
+
+        const std::size_t in_stride_w  = in.mDesc.GetStrides()[3];
+        const std::size_t out_stride_w = out.mDesc.GetStrides()[3];
+
+        for(std::size_t wob = wo0; wob < wo0 + run_length; wob += AccBlock)
         {
-            for(int y = 0; y < wei.mDesc.GetLengths()[2]; ++y)
+            const int wo_begin = wob;
+            const int wo_end   = std::min(wob + AccBlock, wo0 + run_length);
+
+            double v[AccBlock] = {0};
+
+            const std::size_t c_begin = k / KPerGroup * CPerGroup;
+
+            for(int c = 0; c < CPerGroup; ++c)
             {
-                int hi = ho * conv_strides[I0] + y * conv_dilations[I0] - in_left_pads[I0];
-                for(int x = 0; x < wei.mDesc.GetLengths()[3]; ++x)
+                for(int y = 0; y < wei.mDesc.GetLengths()[2]; ++y)
                 {
-                    int wi = wo * conv_strides[I1] + x * conv_dilations[I1] - in_left_pads[I1];
-                    if(hi >= 0 && hi < in.mDesc.GetLengths()[2] && wi >= 0 &&
-                       wi < in.mDesc.GetLengths()[3])
+                    int hi = ho * conv_strides[I0] + y * conv_dilations[I0] - in_left_pads[I0];
+
+                    if(hi < 0 || hi >= Hi)
+                        continue;
+
+                    const auto* p_in = &in(n, c_begin + c, hi, 0);
+
+                    for(int x = 0; x < wei.mDesc.GetLengths()[3]; ++x)
                     {
-                        v += static_cast<const double>(in(n, c, hi, wi)) *
-                             static_cast<const double>(wei(k, c, y, x));
+                        // wi = wo * s_w + wi_off, valid for wo in [wo_lo, wo_hi)
+                        const int wi_off = x * conv_dilations[I1] - in_left_pads[I1];
+
+                        const int wo_lo =
+                            std::max(wo_begin, wi_off >= 0 ? 0 : (s_w - 1 - wi_off) / s_w);
+                        const int wo_hi = std::min(
+                            wo_end, Wi - wi_off <= 0 ? 0 : (Wi - wi_off + s_w - 1) / s_w);
+
+                        const double w = static_cast<const double>(wei(k, c, y, x));
+
+                        for(int wo = wo_lo; wo < wo_hi; ++wo)
+                        {
+                            v[wo - wo_begin] += static_cast<const double>(
+                                                    p_in[(wo * s_w + wi_off) * in_stride_w]) *
+                                                w;
+                        }
                     }
                 }
             }
+
+            auto* p_out = &out(n, k, ho, 0);
+
+            for(int wo = wo_begin; wo < wo_end; ++wo)
+            {
+                p_out[wo * out_stride_w] = v[wo - wo_begin];
+            }
         }
-        out(n, k, ho, wo) = v;
     };
 
-    auto f_nhwc = [&](auto n, auto ho, auto wo, auto k) {
-        double v = 0;
-        for(int c = 0; c < wei.mDesc.GetLengths()[3]; ++c)
+    auto f_nhwc = [&](const auto& idx, std::size_t run_length) {
+        const std::size_t n  = idx[0];
+        const std::size_t ho = idx[1];
+        const std::size_t wo = idx[2];
+        const std::size_t k0 = idx[3];
+
+        const std::size_t wei_stride_k = wei.mDesc.GetStrides()[0];
+        const std::size_t out_stride_k = out.mDesc.GetStrides()[3];
+
+        // blocks don't cross a group boundary, so they share their input channels
+        for(std::size_t kb = k0, k_len = 0; kb < k0 + run_length; kb += k_len)
         {
-            for(int y = 0; y < wei.mDesc.GetLengths()[1]; ++y)
+            k_len = std::min({AccBlock, k0 + run_length - kb, KPerGroup - kb % KPerGroup});
+
+            const std::size_t c_begin = kb / KPerGroup * CPerGroup;
+
+            double v[AccBlock] = {0};
+
+            for(int c = 0; c < CPerGroup; ++c)
             {
-                int hi = ho * conv_strides[I0] + y * conv_dilations[I0] - in_left_pads[I0];
-                for(int x = 0; x < wei.mDesc.GetLengths()[2]; ++x)
+                for(int y = 0; y < wei.mDesc.GetLengths()[1]; ++y)
                 {
-                    int wi = wo * conv_strides[I1] + x * conv_dilations[I1] - in_left_pads[I1];
-                    if(hi >= 0 && hi < in.mDesc.GetLengths()[1] && wi >= 0 &&
-                       wi < in.mDesc.GetLengths()[2])
+                    int hi = ho * conv_strides[I0] + y * conv_dilations[I0] - in_left_pads[I0];
+                    for(int x = 0; x < wei.mDesc.GetLengths()[2]; ++x)
                     {
-                        v += static_cast<const double>(in(n, hi, wi, c)) *
-                             static_cast<const double>(wei(k, y, x, c));
+                        int wi = wo * conv_strides[I1] + x * conv_dilations[I1] - in_left_pads[I1];
+                        if(hi >= 0 && hi < in.mDesc.GetLengths()[1] && wi >= 0 &&
+                           wi < in.mDesc.GetLengths()[2])
+                        {
+                            const double a =
+                                static_cast<const double>(in(n, hi, wi, c_begin + c));
+
+                            const auto* p_wei = &wei(kb, y, x, c);
+
+                            for(std::size_t i = 0; i < k_len; ++i)
+                            {
+                                v[i] += a * static_cast<const double>(p_wei[i * wei_stride_k]);
+                            }
+                        }
                     }
                 }
             }
+
+            auto* p_out = &out(n, ho, wo, kb);
+
+            for(std::size_t i = 0; i < k_len; ++i)
+            {
+                p_out[i * out_stride_k] = v[i];
+            }
         }
-        out(n, ho, wo, k) = v;
     };
 
     if(layout == ConvTensorLayout::NCHW)
     {
-        make_ParallelTensorFunctor(f_nchw,
-                                   out.mDesc.GetLengths()[0],
-                                   out.mDesc.GetLengths()[1],
-                                   out.mDesc.GetLengths()[2],
-                                   out.mDesc.GetLengths()[3])(std::thread::hardware_concurrency());
+        make_ParallelTensorTileFunctor(f_nchw,
+                                       out.mDesc.GetLengths()[0],
+                                       out.mDesc.GetLengths()[1],
+                                       out.mDesc.GetLengths()[2],
+                                       out.mDesc.GetLengths()[3])(
+            std::thread::hardware_concurrency());
     }
     else if(layout == ConvTensorLayout::NHWC)
     {
-        make_ParallelTensorFunctor(f_nhwc,
-                                   out.mDesc.GetLengths()[0],
-                                   out.mDesc.GetLengths()[1],
-                                   out.mDesc.GetLengths()[2],
-                                   out.mDesc.GetLengths()[3])(std::thread::hardware_concurrency());
+        make_ParallelTensorTileFunctor(f_nhwc,
+                                       out.mDesc.GetLengths()[0],
+                                       out.mDesc.GetLengths()[1],
+                                       out.mDesc.GetLengths()[2],
+                                       out.mDesc.GetLengths()[3])(
+            std::thread::hardware_concurrency());
     }
     else
     {
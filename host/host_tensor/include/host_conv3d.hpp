@@ -0,0 +1,671 @@
+#pragma once
+#include "host_tensor.hpp"
+#include "host_tensor_layout.hpp"
+#include "host_gemm_packed.hpp"
+#include "host_conv_implicit_gemm.hpp"
+#include "conv_common.hpp"
+#include "transform_forward_convolution3d_into_gemm_v4r4_ncdhw_kczyx_nkdhw.hpp"
+#include "transform_forward_convolution3d_into_gemm_v4r4_ndhwc_kzyxc_ndhwk.hpp"
+
+// 3-D (NCDHW / NDHWC) convolutions on the CPU. Strides, dilations and pads are indexed D, H, W.
+
+namespace host_conv3d_detail {
+
+// dimension of C (K for wei and out) and of D, which H and W follow
+inline std::size_t get_c_dim(ConvTensorLayout layout)
+{
+    return layout == ConvTensorLayout::NCDHW ? 1 : 4;
+}
+
+inline std::size_t get_d_dim(ConvTensorLayout layout)
+{
+    return layout == ConvTensorLayout::NCDHW ? 2 : 1;
+}
+
+inline void check_layout(ConvTensorLayout layout)
+{
+    if(layout != ConvTensorLayout::NCDHW && layout != ConvTensorLayout::NDHWC)
+        throw std::runtime_error("wrong! not supported layout");
+}
+
+} // namespace host_conv3d_detail
+
+// Reference forward 3-D convolution, accumulated in double. One task per output row along W.
+// in, wei and out can be Tensor or TensorView
+template <typename InTensor,
+          typename WeiTensor,
+          typename OutTensor,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename InLeftPads,
+          typename InRightPads>
+void host_direct_convolution_3d(const InTensor& in_tensor,
+                                const WeiTensor& wei_tensor,
+                                OutTensor&& out_tensor,
+                                const ConvStrides& conv_strides,
+                                const ConvDilations& conv_dilations,
+                                const InLeftPads& in_left_pads,
+                                const InRightPads&,
+                                const ConvTensorLayout layout = ConvTensorLayout::NCDHW,
+                                std::size_t num_thread = std::thread::hardware_concurrency())
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+    constexpr auto I2 = Number<2>{};
+
+    const auto in  = make_tensor_view(in_tensor);
+    const auto wei = make_tensor_view(wei_tensor);
+    const auto out = make_tensor_view(out_tensor);
+
+    using OutT = typename decltype(out)::value_type;
+
+    host_conv3d_detail::check_layout(layout);
+
+    const std::size_t c_dim = host_conv3d_detail::get_c_dim(layout);
+    const std::size_t d_dim = host_conv3d_detail::get_d_dim(layout);
+
+    const auto& in_lens  = in.mDesc.GetLengths();
+    const auto& wei_lens = wei.mDesc.GetLengths();
+    const auto& out_lens = out.mDesc.GetLengths();
+
+    const std::size_t N  = out_lens[0];
+    const std::size_t K  = out_lens[c_dim];
+    const std::size_t Do = out_lens[d_dim];
+    const std::size_t Ho = out_lens[d_dim + 1];
+    const std::size_t Wo = out_lens[d_dim + 2];
+    const int Di         = in_lens[d_dim];
+    const int Hi         = in_lens[d_dim + 1];
+    const int Wi         = in_lens[d_dim + 2];
+    const std::size_t Z  = wei_lens[d_dim];
+    const std::size_t Y  = wei_lens[d_dim + 1];
+    const std::size_t X  = wei_lens[d_dim + 2];
+
+    const std::size_t CPerGroup = wei_lens[c_dim];
+    const std::size_t G         = in_lens[c_dim] / CPerGroup;
+    const std::size_t KPerGroup = K / G;
+
+    if(G * CPerGroup != in_lens[c_dim] || G * KPerGroup != K)
+        throw std::runtime_error("wrong! C and K must be multiples of the group count");
+
+    const auto& in_strides  = in.mDesc.GetStrides();
+    const auto& wei_strides = wei.mDesc.GetStrides();
+    const auto& out_strides = out.mDesc.GetStrides();
+
+    auto& pool = HostThreadPool::GetInstance();
+
+    const std::size_t num_chunk =
+        std::max<std::size_t>(num_thread, 1) * HostThreadPool::ChunkPerThread;
+
+    pool.ParallelFor(0, N * K * Do * Ho, num_chunk, [&](std::size_t ib, std::size_t ie) {
+        for(std::size_t i = ib; i < ie; ++i)
+        {
+            const std::size_t n  = i / (K * Do * Ho);
+            const std::size_t k  = i / (Do * Ho) % K;
+            const std::size_t d  = i / Ho % Do;
+            const std::size_t ho = i % Ho;
+
+            const std::size_t c_begin = k / KPerGroup * CPerGroup;
+
+            for(std::size_t wo = 0; wo < Wo; ++wo)
+            {
+                double v = 0;
+
+                for(std::size_t c = 0; c < CPerGroup; ++c)
+                {
+                    for(std::size_t z = 0; z < Z; ++z)
+                    {
+                        const int di = int(d * conv_strides[I0] + z * conv_dilations[I0]) -
+                                       int(in_left_pads[I0]);
+
+                        if(di < 0 || di >= Di)
+                            continue;
+
+                        for(std::size_t y = 0; y < Y; ++y)
+                        {
+                            const int hi = int(ho * conv_strides[I1] + y * conv_dilations[I1]) -
+                                           int(in_left_pads[I1]);
+
+                            if(hi < 0 || hi >= Hi)
+                                continue;
+
+                            for(std::size_t x = 0; x < X; ++x)
+                            {
+                                const int wi =
+                                    int(wo * conv_strides[I2] + x * conv_dilations[I2]) -
+                                    int(in_left_pads[I2]);
+
+                                if(wi < 0 || wi >= Wi)
+                                    continue;
+
+                                const std::size_t in_offset =
+                                    n * in_strides[0] + (c_begin + c) * in_strides[c_dim] +
+                                    di * in_strides[d_dim] + hi * in_strides[d_dim + 1] +
+                                    wi * in_strides[d_dim + 2];
+                                const std::size_t wei_offset =
+                                    k * wei_strides[0] + c * wei_strides[c_dim] +
+                                    z * wei_strides[d_dim] + y * wei_strides[d_dim + 1] +
+                                    x * wei_strides[d_dim + 2];
+
+                                v += static_cast<double>(in.mpData[in_offset]) *
+                                     static_cast<double>(wei.mpData[wei_offset]);
+                            }
+                        }
+                    }
+                }
+
+                out.mpData[n * out_strides[0] + k * out_strides[c_dim] + d * out_strides[d_dim] +
+                           ho * out_strides[d_dim + 1] + wo * out_strides[d_dim + 2]] =
+                    static_cast<OutT>(v);
+            }
+        }
+    });
+}
+
+// Forward 3-D convolution as an implicit GEMM, the 3-D counterpart of
+// host_conv_fwd_implicit_gemm: GemmM = K, GemmN = N * Do * Ho * Wo, GemmK = C * Z * Y * X, with
+// the offset tables taken from transform_forward_convolution3d_into_gemm_v4r4_{ncdhw_kczyx_nkdhw,
+// ndhwc_kzyxc_ndhwk}. Padding is applied to a copy of the input, and grouped convolutions are one
+// GEMM per group.
+// in can be Tensor or TensorView, wei and out must be packed
+template <typename InTensor,
+          typename WeiTensor,
+          typename OutTensor,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename InLeftPads,
+          typename InRightPads>
+void host_conv3d_fwd_implicit_gemm(const InTensor& in_tensor,
+                                   const WeiTensor& wei_tensor,
+                                   OutTensor&& out_tensor,
+                                   const ConvStrides& conv_strides,
+                                   const ConvDilations& conv_dilations,
+                                   const InLeftPads& in_left_pads,
+                                   const InRightPads& in_right_pads,
+                                   const ConvTensorLayout layout = ConvTensorLayout::NCDHW,
+                                   std::size_t num_thread = std::thread::hardware_concurrency())
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+    constexpr auto I2 = Number<2>{};
+
+    using InT  = std::remove_const_t<typename decltype(make_tensor_view(in_tensor))::value_type>;
+    using WeiT = std::remove_const_t<typename decltype(make_tensor_view(wei_tensor))::value_type>;
+    using OutT = typename decltype(make_tensor_view(out_tensor))::value_type;
+
+    const TensorView<const InT> in = make_tensor_view(in_tensor);
+    const auto wei                 = make_tensor_view(wei_tensor);
+    const auto out                 = make_tensor_view(out_tensor);
+
+    host_conv3d_detail::check_layout(layout);
+
+    if(!wei.mDesc.IsPacked() || !out.mDesc.IsPacked())
+        throw std::runtime_error("wrong! weight and output must be packed");
+
+    const bool is_ncdhw     = layout == ConvTensorLayout::NCDHW;
+    const std::size_t c_dim = host_conv3d_detail::get_c_dim(layout);
+    const std::size_t d_dim = host_conv3d_detail::get_d_dim(layout);
+
+    const auto& in_lens  = in.mDesc.GetLengths();
+    const auto& wei_lens = wei.mDesc.GetLengths();
+    const auto& out_lens = out.mDesc.GetLengths();
+
+    const index_t N  = in_lens[0];
+    const index_t C  = in_lens[c_dim];
+    const index_t K  = wei_lens[0];
+    const index_t Z  = wei_lens[d_dim];
+    const index_t Y  = wei_lens[d_dim + 1];
+    const index_t X  = wei_lens[d_dim + 2];
+    const index_t Do = out_lens[d_dim];
+    const index_t Ho = out_lens[d_dim + 1];
+    const index_t Wo = out_lens[d_dim + 2];
+
+    const index_t CPerGroup = wei_lens[c_dim];
+    const index_t G         = C / CPerGroup;
+    const index_t KPerGroup = K / G;
+
+    if(G * CPerGroup != C || G * KPerGroup != K)
+        throw std::runtime_error("wrong! C and K must be multiples of the group count");
+
+    const std::vector<std::size_t> pads_0 = {std::size_t(in_left_pads[I0]),
+                                             std::size_t(in_left_pads[I1]),
+                                             std::size_t(in_left_pads[I2])};
+    const std::vector<std::size_t> pads_1 = {std::size_t(in_right_pads[I0]),
+                                             std::size_t(in_right_pads[I1]),
+                                             std::size_t(in_right_pads[I2])};
+
+    const index_t Dip = in_lens[d_dim] + pads_0[0] + pads_1[0];
+    const index_t Hip = in_lens[d_dim + 1] + pads_0[1] + pads_1[1];
+    const index_t Wip = in_lens[d_dim + 2] + pads_0[2] + pads_1[2];
+
+    host_conv_detail::check_index_t_range({in.mDesc.GetElementSize(),
+                                           wei.mDesc.GetElementSize(),
+                                           out.mDesc.GetElementSize(),
+                                           std::size_t(N) * C * Dip * Hip * Wip});
+
+    // zero-padded, packed copy of the input, left empty when the input can be read directly
+    const bool use_padded = pads_0 != std::vector<std::size_t>(3, 0) ||
+                            pads_1 != std::vector<std::size_t>(3, 0) || !in.mDesc.IsPacked();
+
+    const Tensor<InT> in_padded =
+        use_padded ? host_conv_detail::get_zero_padded_tensor(in, d_dim, pads_0, pads_1, num_thread)
+                   : Tensor<InT>(std::vector<std::size_t>{});
+
+    const InT* p_in = use_padded ? in_padded.mData.data() : in.mpData;
+
+    const auto conv_strides_dev = make_tuple(
+        index_t(conv_strides[I0]), index_t(conv_strides[I1]), index_t(conv_strides[I2]));
+    const auto conv_dilations_dev = make_tuple(
+        index_t(conv_dilations[I0]), index_t(conv_dilations[I1]), index_t(conv_dilations[I2]));
+    const auto zero_pads_dev = make_tuple(index_t(0), index_t(0), index_t(0));
+
+    // offsets of the GEMM matrices, GemmK x GemmM for weight, GemmK x GemmN for input and
+    // GemmM x GemmN for output, with the input ones for the channels of group 0
+    std::vector<std::size_t> wei_offset_k, wei_offset_m;
+    std::vector<std::size_t> in_offset_k, in_offset_n;
+    std::vector<std::size_t> out_offset_m, out_offset_n;
+
+    auto f_get_offsets = [&](const auto& descs) {
+        host_conv_detail::get_separable_offsets(
+            descs[Number<0>{}], wei_offset_k, wei_offset_m, num_thread);
+        host_conv_detail::get_separable_offsets(
+            descs[Number<1>{}], in_offset_k, in_offset_n, num_thread);
+        host_conv_detail::get_separable_offsets(
+            descs[Number<2>{}], out_offset_m, out_offset_n, num_thread);
+    };
+
+    if(is_ncdhw)
+    {
+        f_get_offsets(transform_forward_convolution3d_into_gemm_v4r4_ncdhw_kczyx_nkdhw_pad(
+            make_naive_tensor_descriptor_packed(make_tuple(K, CPerGroup, Z, Y, X)),
+            make_naive_tensor_descriptor(
+                make_tuple(N, CPerGroup, Dip, Hip, Wip),
+                make_tuple(C * Dip * Hip * Wip, Dip * Hip * Wip, Hip * Wip, Wip, 1)),
+            make_naive_tensor_descriptor_packed(make_tuple(N, K, Do, Ho, Wo)),
+            conv_strides_dev,
+            conv_dilations_dev,
+            zero_pads_dev,
+            zero_pads_dev));
+    }
+    else
+    {
+        f_get_offsets(transform_forward_convolution3d_into_gemm_v4r4_ndhwc_kzyxc_ndhwk_pad(
+            make_naive_tensor_descriptor_packed(make_tuple(K, Z, Y, X, CPerGroup)),
+            make_naive_tensor_descriptor(
+                make_tuple(N, Dip, Hip, Wip, CPerGroup),
+                make_tuple(Dip * Hip * Wip * C, Hip * Wip * C, Wip * C, C, 1)),
+            make_naive_tensor_descriptor_packed(make_tuple(N, Do, Ho, Wo, K)),
+            conv_strides_dev,
+            conv_dilations_dev,
+            zero_pads_dev,
+            zero_pads_dev));
+    }
+
+    const std::size_t in_group_stride =
+        is_ncdhw ? std::size_t(CPerGroup) * Dip * Hip * Wip : CPerGroup;
+
+    for(index_t g = 0; g < G; ++g)
+    {
+        host_gemm_detail::gemm_packed_dispatch(
+            host_gemm_detail::GemmOperandSeparable<WeiT>{
+                wei.mpData, wei_offset_m.data() + g * KPerGroup, wei_offset_k.data()},
+            host_gemm_detail::GemmOperandSeparable<InT>{
+                p_in + g * in_group_stride, in_offset_n.data(), in_offset_k.data()},
+            host_gemm_detail::GemmOutputSeparable<OutT>{
+                out.mpData, out_offset_m.data() + g * KPerGroup, out_offset_n.data()},
+            KPerGroup,
+            out_offset_n.size(),
+            in_offset_k.size(),
+            num_thread);
+    }
+}
+
+// Backward-weight 3-D convolution as one GEMM with GemmM = K, GemmN = C * Z * Y * X
+// (Z * Y * X * C for NDHWC) and GemmK = N * Do * Ho * Wo. Ungrouped only.
+// out, in and wei can be Tensor or TensorView
+template <typename OutTensor,
+          typename InTensor,
+          typename WeiTensor,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename InLeftPads,
+          typename InRightPads>
+void host_conv3d_bwd_weight_implicit_gemm(
+    const OutTensor& out_tensor,
+    const InTensor& in_tensor,
+    WeiTensor&& wei_tensor,
+    const ConvStrides& conv_strides,
+    const ConvDilations& conv_dilations,
+    const InLeftPads& in_left_pads,
+    const InRightPads& in_right_pads,
+    const ConvTensorLayout layout = ConvTensorLayout::NCDHW,
+    std::size_t num_thread        = std::thread::hardware_concurrency())
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+    constexpr auto I2 = Number<2>{};
+
+    using OutT = std::remove_const_t<typename decltype(make_tensor_view(out_tensor))::value_type>;
+    using InT  = std::remove_const_t<typename decltype(make_tensor_view(in_tensor))::value_type>;
+    using WeiT = typename decltype(make_tensor_view(wei_tensor))::value_type;
+
+    const TensorView<const OutT> out = make_tensor_view(out_tensor);
+    const TensorView<const InT> in   = make_tensor_view(in_tensor);
+    const auto wei                   = make_tensor_view(wei_tensor);
+
+    host_conv3d_detail::check_layout(layout);
+
+    const bool is_ncdhw     = layout == ConvTensorLayout::NCDHW;
+    const std::size_t c_dim = host_conv3d_detail::get_c_dim(layout);
+    const std::size_t d_dim = host_conv3d_detail::get_d_dim(layout);
+
+    const std::size_t N  = in.mDesc.GetLengths()[0];
+    const std::size_t C  = in.mDesc.GetLengths()[c_dim];
+    const std::size_t K  = wei.mDesc.GetLengths()[0];
+    const std::size_t Z  = wei.mDesc.GetLengths()[d_dim];
+    const std::size_t Y  = wei.mDesc.GetLengths()[d_dim + 1];
+    const std::size_t X  = wei.mDesc.GetLengths()[d_dim + 2];
+    const std::size_t Do = out.mDesc.GetLengths()[d_dim];
+    const std::size_t Ho = out.mDesc.GetLengths()[d_dim + 1];
+    const std::size_t Wo = out.mDesc.GetLengths()[d_dim + 2];
+
+    if(wei.mDesc.GetLengths()[c_dim] != C)
+        throw std::runtime_error("wrong! grouped convolution not supported");
+
+    const std::size_t ConvStrideD   = conv_strides[I0];
+    const std::size_t ConvStrideH   = conv_strides[I1];
+    const std::size_t ConvStrideW   = conv_strides[I2];
+    const std::size_t ConvDilationD = conv_dilations[I0];
+    const std::size_t ConvDilationH = conv_dilations[I1];
+    const std::size_t ConvDilationW = conv_dilations[I2];
+
+    const std::vector<std::size_t> pads_0 = {std::size_t(in_left_pads[I0]),
+                                             std::size_t(in_left_pads[I1]),
+                                             std::size_t(in_left_pads[I2])};
+    const std::vector<std::size_t> pads_1 = {std::size_t(in_right_pads[I0]),
+                                             std::size_t(in_right_pads[I1]),
+                                             std::size_t(in_right_pads[I2])};
+
+    // the input is read directly unless it needs padding
+    const bool use_padded =
+        pads_0 != std::vector<std::size_t>(3, 0) || pads_1 != std::vector<std::size_t>(3, 0);
+
+    const Tensor<InT> in_padded =
+        use_padded ? host_conv_detail::get_zero_padded_tensor(in, d_dim, pads_0, pads_1, num_thread)
+                   : Tensor<InT>(std::vector<std::size_t>{});
+
+    const InT* p_in = use_padded ? in_padded.mData.data() : in.mpData;
+
+    const auto& in_strides  = use_padded ? in_padded.mDesc.GetStrides() : in.mDesc.GetStrides();
+    const auto& out_strides = out.mDesc.GetStrides();
+    const auto& wei_strides = wei.mDesc.GetStrides();
+
+    const std::size_t GemmM = K;
+    const std::size_t GemmN = C * Z * Y * X;
+    const std::size_t GemmK = N * Do * Ho * Wo;
+
+    std::vector<std::size_t> out_offset_m(GemmM), out_offset_k(GemmK);
+    std::vector<std::size_t> in_offset_n(GemmN), in_offset_k(GemmK);
+    std::vector<std::size_t> wei_offset_m(GemmM), wei_offset_n(GemmN);
+
+    for(std::size_t k = 0; k < K; ++k)
+    {
+        out_offset_m[k] = k * out_strides[c_dim];
+        wei_offset_m[k] = k * wei_strides[0];
+    }
+
+    for(std::size_t c = 0; c < C; ++c)
+    {
+        for(std::size_t z = 0; z < Z; ++z)
+        {
+            for(std::size_t y = 0; y < Y; ++y)
+            {
+                for(std::size_t x = 0; x < X; ++x)
+                {
+                    const std::size_t gemmn =
+                        is_ncdhw ? ((c * Z + z) * Y + y) * X + x : ((z * Y + y) * X + x) * C + c;
+
+                    in_offset_n[gemmn] = c * in_strides[c_dim] +
+                                         z * ConvDilationD * in_strides[d_dim] +
+                                         y * ConvDilationH * in_strides[d_dim + 1] +
+                                         x * ConvDilationW * in_strides[d_dim + 2];
+                    wei_offset_n[gemmn] = c * wei_strides[c_dim] + z * wei_strides[d_dim] +
+                                          y * wei_strides[d_dim + 1] + x * wei_strides[d_dim + 2];
+                }
+            }
+        }
+    }
+
+    for(std::size_t n = 0, gemmk = 0; n < N; ++n)
+    {
+        for(std::size_t d = 0; d < Do; ++d)
+        {
+            for(std::size_t ho = 0; ho < Ho; ++ho)
+            {
+                for(std::size_t wo = 0; wo < Wo; ++wo, ++gemmk)
+                {
+                    out_offset_k[gemmk] = n * out_strides[0] + d * out_strides[d_dim] +
+                                          ho * out_strides[d_dim + 1] + wo * out_strides[d_dim + 2];
+                    in_offset_k[gemmk] = n * in_strides[0] + d * ConvStrideD * in_strides[d_dim] +
+                                         ho * ConvStrideH * in_strides[d_dim + 1] +
+                                         wo * ConvStrideW * in_strides[d_dim + 2];
+                }
+            }
+        }
+    }
+
+    host_gemm_detail::gemm_packed_dispatch(
+        host_gemm_detail::GemmOperandSeparable<OutT>{
+            out.mpData, out_offset_m.data(), out_offset_k.data()},
+        host_gemm_detail::GemmOperandSeparable<InT>{p_in, in_offset_n.data(), in_offset_k.data()},
+        host_gemm_detail::GemmOutputSeparable<WeiT>{
+            wei.mpData, wei_offset_m.data(), wei_offset_n.data()},
+        GemmM,
+        GemmN,
+        GemmK,
+        num_thread);
+}
+
+// Backward-data 3-D convolution as a GEMM followed by a col2im: for a block of GemmN = N * Do *
+// Ho * Wo columns, col = wei^T * out is the GemmM = C * Z * Y * X by GemmN matrix of every filter
+// tap's contribution, which is then added into a zero-padded accumulator of the input. The
+// scatter is split by input channel, so no two threads write the same element. Ungrouped only.
+// in, wei and out can be Tensor or TensorView
+template <typename InTensor,
+          typename WeiTensor,
+          typename OutTensor,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename InLeftPads,
+          typename InRightPads>
+void host_conv3d_bwd_data_implicit_gemm(
+    InTensor&& in_tensor,
+    const WeiTensor& wei_tensor,
+    const OutTensor& out_tensor,
+    const ConvStrides& conv_strides,
+    const ConvDilations& conv_dilations,
+    const InLeftPads& in_left_pads,
+    const InRightPads& in_right_pads,
+    const ConvTensorLayout layout = ConvTensorLayout::NCDHW,
+    std::size_t num_thread        = std::thread::hardware_concurrency())
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+    constexpr auto I2 = Number<2>{};
+
+    // col holds at most ColSize elements
+    constexpr std::size_t ColSize = std::size_t(1) << 24;
+
+    using InT  = typename decltype(make_tensor_view(in_tensor))::value_type;
+    using WeiT = std::remove_const_t<typename decltype(make_tensor_view(wei_tensor))::value_type>;
+    using OutT = std::remove_const_t<typename decltype(make_tensor_view(out_tensor))::value_type>;
+    using AccT = typename HostGemmDataType<OutT>::AccType;
+
+    const auto in                    = make_tensor_view(in_tensor);
+    const TensorView<const WeiT> wei = make_tensor_view(wei_tensor);
+    const TensorView<const OutT> out = make_tensor_view(out_tensor);
+
+    host_conv3d_detail::check_layout(layout);
+
+    const std::size_t c_dim = host_conv3d_detail::get_c_dim(layout);
+    const std::size_t d_dim = host_conv3d_detail::get_d_dim(layout);
+
+    const std::size_t N  = in.mDesc.GetLengths()[0];
+    const std::size_t C  = in.mDesc.GetLengths()[c_dim];
+    const std::size_t Di = in.mDesc.GetLengths()[d_dim];
+    const std::size_t Hi = in.mDesc.GetLengths()[d_dim + 1];
+    const std::size_t Wi = in.mDesc.GetLengths()[d_dim + 2];
+    const std::size_t K  = wei.mDesc.GetLengths()[0];
+    const std::size_t Z  = wei.mDesc.GetLengths()[d_dim];
+    const std::size_t Y  = wei.mDesc.GetLengths()[d_dim + 1];
+    const std::size_t X  = wei.mDesc.GetLengths()[d_dim + 2];
+    const std::size_t Do = out.mDesc.GetLengths()[d_dim];
+    const std::size_t Ho = out.mDesc.GetLengths()[d_dim + 1];
+    const std::size_t Wo = out.mDesc.GetLengths()[d_dim + 2];
+
+    if(wei.mDesc.GetLengths()[c_dim] != C)
+        throw std::runtime_error("wrong! grouped convolution not supported");
+
+    const std::size_t ConvStrideD   = conv_strides[I0];
+    const std::size_t ConvStrideH   = conv_strides[I1];
+    const std::size_t ConvStrideW   = conv_strides[I2];
+    const std::size_t ConvDilationD = conv_dilations[I0];
+    const std::size_t ConvDilationH = conv_dilations[I1];
+    const std::size_t ConvDilationW = conv_dilations[I2];
+    const std::size_t InLeftPadD    = in_left_pads[I0];
+    const std::size_t InLeftPadH    = in_left_pads[I1];
+    const std::size_t InLeftPadW    = in_left_pads[I2];
+
+    const std::size_t Dip = Di + InLeftPadD + in_right_pads[I0];
+    const std::size_t Hip = Hi + InLeftPadH + in_right_pads[I1];
+    const std::size_t Wip = Wi + InLeftPadW + in_right_pads[I2];
+
+    // zero-padded N x C x Dip x Hip x Wip accumulator of the input
+    std::vector<AccT, HostTensorAllocator<AccT>> in_acc(N * C * Dip * Hip * Wip, AccT{0});
+
+    const auto& in_strides  = in.mDesc.GetStrides();
+    const auto& wei_strides = wei.mDesc.GetStrides();
+    const auto& out_strides = out.mDesc.GetStrides();
+
+    const std::size_t GemmM = C * Z * Y * X;
+    const std::size_t GemmN = N * Do * Ho * Wo;
+
+    // GemmM rows are (c, z, y, x) in that order for both layouts
+    std::vector<std::size_t> wei_offset_m(GemmM), wei_offset_k(K);
+    std::vector<std::size_t> out_offset_n(GemmN), out_offset_k(K);
+
+    for(std::size_t c = 0, gemmm = 0; c < C; ++c)
+        for(std::size_t z = 0; z < Z; ++z)
+            for(std::size_t y = 0; y < Y; ++y)
+                for(std::size_t x = 0; x < X; ++x, ++gemmm)
+                    wei_offset_m[gemmm] = c * wei_strides[c_dim] + z * wei_strides[d_dim] +
+                                          y * wei_strides[d_dim + 1] + x * wei_strides[d_dim + 2];
+
+    for(std::size_t k = 0; k < K; ++k)
+    {
+        wei_offset_k[k] = k * wei_strides[0];
+        out_offset_k[k] = k * out_strides[c_dim];
+    }
+
+    for(std::size_t n = 0, gemmn = 0; n < N; ++n)
+        for(std::size_t d = 0; d < Do; ++d)
+            for(std::size_t ho = 0; ho < Ho; ++ho)
+                for(std::size_t wo = 0; wo < Wo; ++wo, ++gemmn)
+                    out_offset_n[gemmn] = n * out_strides[0] + d * out_strides[d_dim] +
+                                          ho * out_strides[d_dim + 1] + wo * out_strides[d_dim + 2];
+
+    const std::size_t GemmNPerBlock =
+        std::max<std::size_t>(1, std::min(GemmN, ColSize / std::max<std::size_t>(GemmM, 1)));
+
+    std::vector<AccT, HostTensorAllocator<AccT>> col(
+        GemmM * GemmNPerBlock, HostTensorAllocator<AccT>(HostTensorMemoryPolicy::Uninitialized()));
+
+    auto& pool = HostThreadPool::GetInstance();
+
+    for(std::size_t gemmn_begin = 0; gemmn_begin < GemmN; gemmn_begin += GemmNPerBlock)
+    {
+        const std::size_t gemmn_len = std::min(GemmNPerBlock, GemmN - gemmn_begin);
+
+        host_gemm_detail::gemm_packed_dispatch(
+            host_gemm_detail::GemmOperandSeparable<WeiT>{
+                wei.mpData, wei_offset_m.data(), wei_offset_k.data()},
+            host_gemm_detail::GemmOperandSeparable<OutT>{
+                out.mpData, out_offset_n.data() + gemmn_begin, out_offset_k.data()},
+            host_gemm_detail::GemmOutputStrided<AccT>{col.data(), gemmn_len, 1},
+            GemmM,
+            gemmn_len,
+            K,
+            num_thread);
+
+        // col2im, one input channel per task
+        pool.ParallelFor(0, C, C, [&](std::size_t cb, std::size_t ce) {
+            for(std::size_t c = cb; c < ce; ++c)
+            {
+                for(std::size_t zyx = 0; zyx < Z * Y * X; ++zyx)
+                {
+                    const std::size_t z = zyx / (Y * X);
+                    const std::size_t y = zyx / X % Y;
+                    const std::size_t x = zyx % X;
+
+                    const AccT* p_col = col.data() + (c * Z * Y * X + zyx) * gemmn_len;
+
+                    // the block as runs along Wo, (n, d, ho) being fixed in a run
+                    for(std::size_t row = gemmn_begin / Wo; row * Wo < gemmn_begin + gemmn_len;
+                        ++row)
+                    {
+                        const std::size_t n  = row / (Do * Ho);
+                        const std::size_t d  = row / Ho % Do;
+                        const std::size_t ho = row % Ho;
+
+                        const std::size_t wo_begin = std::max(row * Wo, gemmn_begin) - row * Wo;
+                        const std::size_t wo_end =
+                            std::min((row + 1) * Wo, gemmn_begin + gemmn_len) - row * Wo;
+
+                        const std::size_t dip = d * ConvStrideD + z * ConvDilationD;
+                        const std::size_t hip = ho * ConvStrideH + y * ConvDilationH;
+
+                        AccT* p_acc = &in_acc[(((n * C + c) * Dip + dip) * Hip + hip) * Wip +
+                                              x * ConvDilationW];
+                        const AccT* p_row = p_col + (row * Wo + wo_begin - gemmn_begin);
+
+                        for(std::size_t wo = wo_begin; wo < wo_end; ++wo)
+                            p_acc[wo * ConvStrideW] += p_row[wo - wo_begin];
+                    }
+                }
+            }
+        });
+    }
+
+    // interior of the accumulator into in
+    const std::size_t num_chunk =
+        std::max<std::size_t>(num_thread, 1) * HostThreadPool::ChunkPerThread;
+
+    pool.ParallelFor(0, N * C * Di, num_chunk, [&](std::size_t ib, std::size_t ie) {
+        for(std::size_t i = ib; i < ie; ++i)
+        {
+            const std::size_t n  = i / (C * Di);
+            const std::size_t c  = i / Di % C;
+            const std::size_t di = i % Di;
+
+            for(std::size_t hi = 0; hi < Hi; ++hi)
+            {
+                const AccT* p_acc =
+                    &in_acc[(((n * C + c) * Dip + di + InLeftPadD) * Hip + hi + InLeftPadH) * Wip +
+                            InLeftPadW];
+
+                InT* p_in = in.mpData + n * in_strides[0] + c * in_strides[c_dim] +
+                            di * in_strides[d_dim] + hi * in_strides[d_dim + 1];
+
+                for(std::size_t wi = 0; wi < Wi; ++wi)
+                    p_in[wi * in_strides[d_dim + 2]] = HostGemmDataType<InT>::FromAcc(p_acc[wi]);
+            }
+        }
+    });
+}
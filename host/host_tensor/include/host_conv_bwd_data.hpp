@@ -1,16 +1,17 @@
 #pragma once
 #include "host_tensor.hpp"
 
-template <typename TIn,
-          typename TWei,
-          typename TOut,
+// in, wei and out can be Tensor or TensorView
+template <typename InTensor,
+          typename WeiTensor,
+          typename OutTensor,
           typename ConvStrides,
           typename ConvDilations,
           typename InLeftPads,
           typename InRightPads>
-void host_direct_convolution_backward_data(Tensor<TIn>& in,
-                                           const Tensor<TWei>& wei,
-                                           const Tensor<TOut>& out,
+void host_direct_convolution_backward_data(InTensor&& in,
+                                           const WeiTensor& wei,
+                                           const OutTensor& out,
                                            const ConvStrides& conv_strides,
                                            const ConvDilations& conv_dilations,
                                            const InLeftPads& in_left_pads,
@@ -24,8 +25,20 @@ void host_direct_convolution_backward_data(Tensor<TIn>& in,
     constexpr auto I2 = Number<2>{};
     constexpr auto I3 = Number<3>{};
 
+    // grouped convolution: wei holds C / G channels, input channel c receives from output
+    // channels [g * K / G, (g + 1) * K / G) with g = c / (C / G)
+    const std::size_t c_dim = layout == ConvTensorLayout::NHWC ? 3 : 1;
+
+    const std::size_t CPerGroup = wei.mDesc.GetLengths()[c_dim];
+    const std::size_t G         = in.mDesc.GetLengths()[c_dim] / CPerGroup;
+    const std::size_t KPerGroup = wei.mDesc.GetLengths()[0] / G;
+
+    if(G * CPerGroup != in.mDesc.GetLengths()[c_dim] || G * KPerGroup != wei.mDesc.GetLengths()[0])
+        throw std::runtime_error("wrong! C and K must be multiples of the group count");
+
     auto f_nchw = [&](auto n, auto c, auto hi, auto wi) {
-        std::size_t K = wei.mDesc.GetLengths()[I0];
+        const std::size_t k_begin = c / CPerGroup * KPerGroup;
+        const std::size_t c_group = c % CPerGroup;
         std::size_t Y = wei.mDesc.GetLengths()[I2];
         std::size_t X = wei.mDesc.GetLengths()[I3];
 
@@ -54,9 +67,9 @@ void host_direct_convolution_backward_data(Tensor<TIn>& in,
 
                             if(wo >= 0 && wo < Wo)
                             {
-                                for(int k = 0; k < K; ++k)
+                                for(int k = k_begin; k < k_begin + KPerGroup; ++k)
                                 {
-                                    v += out(n, k, ho, wo) * wei(k, c, y, x);
+                                    v += out(n, k, ho, wo) * wei(k, c_group, y, x);
                                 }
                             }
                         }
@@ -69,7 +82,8 @@ void host_direct_convolution_backward_data(Tensor<TIn>& in,
     };
 
     auto f_nhwc = [&](auto n, auto hi, auto wi, auto c) {
-        std::size_t K = wei.mDesc.GetLengths()[I0];
+        const std::size_t k_begin = c / CPerGroup * KPerGroup;
+        const std::size_t c_group = c % CPerGroup;
         std::size_t Y = wei.mDesc.GetLengths()[I1];
         std::size_t X = wei.mDesc.GetLengths()[I2];
 
@@ -98,9 +112,9 @@ void host_direct_convolution_backward_data(Tensor<TIn>& in,
 
                             if(wo >= 0 && wo < Wo)
                             {
-                                for(int k = 0; k < K; ++k)
+                                for(int k = k_begin; k < k_begin + KPerGroup; ++k)
                                 {
-                                    v += out(n, ho, wo, k) * wei(k, y, x, c);
+                                    v += out(n, ho, wo, k) * wei(k, y, x, c_group);
                                 }
                             }
                         }
@@ -1,17 +1,18 @@
 #pragma once
 #include "host_tensor.hpp"
 
-template <typename TOut,
-          typename TIn,
-          typename TWei,
+// out, in and wei can be Tensor or TensorView
+template <typename OutTensor,
+          typename InTensor,
+          typename WeiTensor,
           typename ConvStrides,
           typename ConvDilations,
           typename InLeftPads,
           typename InRightPads>
 void host_direct_convolution_backward_weights(
-    const Tensor<TOut>& out,
-    const Tensor<TIn>& in,
-    Tensor<TWei>& wei,
+    const OutTensor& out,
+    const InTensor& in,
+    WeiTensor&& wei,
     const ConvStrides& conv_strides,
     const ConvDilations& conv_dilations,
     const InLeftPads& in_left_pads,
@@ -22,7 +23,21 @@ void host_direct_convolution_backward_weights(
 
     constexpr auto I0 = Number<0>{};
     constexpr auto I1 = Number<1>{};
-    auto f_kcyx       = [&](auto k, auto c, auto y, auto x) {
+
+    // grouped convolution: wei holds C / G channels, output channel k reads input channels
+    // [g * C / G, (g + 1) * C / G) with g = k / (K / G)
+    const std::size_t c_dim = layout == ConvTensorLayout::NHWC ? 3 : 1;
+
+    const std::size_t CPerGroup = wei.mDesc.GetLengths()[c_dim];
+    const std::size_t G         = in.mDesc.GetLengths()[c_dim] / CPerGroup;
+    const std::size_t KPerGroup = wei.mDesc.GetLengths()[0] / G;
+
+    if(G * CPerGroup != in.mDesc.GetLengths()[c_dim] || G * KPerGroup != wei.mDesc.GetLengths()[0])
+        throw std::runtime_error("wrong! C and K must be multiples of the group count");
+
+    auto f_kcyx = [&](auto k, auto c, auto y, auto x) {
+        const std::size_t c_in = k / KPerGroup * CPerGroup + c;
+
         double v = 0;
         for(int n = 0; n < out.mDesc.GetLengths()[0]; ++n)
         {
@@ -35,7 +50,7 @@ void host_direct_convolution_backward_weights(
                     if(hi >= 0 && hi < in.mDesc.GetLengths()[2] && wi >= 0 &&
                        wi < in.mDesc.GetLengths()[3])
                     {
-                        v += static_cast<const double>(in(n, c, hi, wi)) *
+                        v += static_cast<const double>(in(n, c_in, hi, wi)) *
                              static_cast<const double>(out(n, k, ho, wo));
                     }
                 }
@@ -45,6 +60,8 @@ void host_direct_convolution_backward_weights(
     };
 
     auto f_kyxc = [&](auto k, auto y, auto x, auto c) {
+        const std::size_t c_in = k / KPerGroup * CPerGroup + c;
+
         double v = 0;
         for(int n = 0; n < out.mDesc.GetLengths()[0]; ++n)
         {
@@ -57,7 +74,7 @@ void host_direct_convolution_backward_weights(
                     if(hi >= 0 && hi < in.mDesc.GetLengths()[1] && wi >= 0 &&
                        wi < in.mDesc.GetLengths()[2])
                     {
-                        v += static_cast<const double>(in(n, hi, wi, c)) *
+                        v += static_cast<const double>(in(n, hi, wi, c_in)) *
                              static_cast<const double>(out(n, ho, wo, k));
                     }
                 }
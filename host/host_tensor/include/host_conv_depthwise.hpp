@@ -0,0 +1,186 @@
+#pragma once
+#include "host_tensor.hpp"
+#include "host_tensor_layout.hpp"
+#include "host_gemm_packed.hpp"
+#include "host_conv_implicit_gemm.hpp"
+#include "conv_common.hpp"
+
+// Depthwise forward convolution on the CPU, with the same interface as host_direct_convolution:
+// one group per input channel, wei is K x 1 x Y x X (K x Y x X x 1 for NHWC) and output channel k
+// reads input channel k / (K / C). As a grouped GEMM every group would be a GEMM with one row, so
+// instead the channels are the vector dimension: the input is read as a zero-padded NHWC copy, the
+// filter is repacked to Y x X x K, and each output pixel accumulates all K channels at once with
+// unit-stride loops over k.
+// in, wei and out can be Tensor or TensorView
+template <typename InTensor,
+          typename WeiTensor,
+          typename OutTensor,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename InLeftPads,
+          typename InRightPads>
+void host_conv_fwd_depthwise(const InTensor& in_tensor,
+                             const WeiTensor& wei_tensor,
+                             OutTensor&& out_tensor,
+                             const ConvStrides& conv_strides,
+                             const ConvDilations& conv_dilations,
+                             const InLeftPads& in_left_pads,
+                             const InRightPads& in_right_pads,
+                             const ConvTensorLayout layout = ConvTensorLayout::NCHW,
+                             std::size_t num_thread = std::thread::hardware_concurrency())
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+
+    using InT  = std::remove_const_t<typename decltype(make_tensor_view(in_tensor))::value_type>;
+    using WeiT = std::remove_const_t<typename decltype(make_tensor_view(wei_tensor))::value_type>;
+    using OutT = typename decltype(make_tensor_view(out_tensor))::value_type;
+    using AccT = typename HostGemmDataType<InT>::AccType;
+
+    const TensorView<const InT> in   = make_tensor_view(in_tensor);
+    const TensorView<const WeiT> wei = make_tensor_view(wei_tensor);
+    const auto out                   = make_tensor_view(out_tensor);
+
+    if(layout != ConvTensorLayout::NCHW && layout != ConvTensorLayout::NHWC)
+        throw std::runtime_error("wrong! not supported layout");
+
+    const bool is_nchw = layout == ConvTensorLayout::NCHW;
+
+    // NHWC views of all three tensors, for the weight that is K x Y x X x 1
+    const std::vector<std::size_t> to_nhwc = {0, 2, 3, 1};
+
+    const auto in_nhwc  = is_nchw ? in.Permute(to_nhwc) : in;
+    const auto wei_kyxc = is_nchw ? wei.Permute(to_nhwc) : wei;
+    const auto out_nhwk = is_nchw ? out.Permute(to_nhwc) : out;
+
+    const std::size_t N  = in_nhwc.mDesc.GetLengths()[0];
+    const std::size_t C  = in_nhwc.mDesc.GetLengths()[3];
+    const std::size_t K  = wei_kyxc.mDesc.GetLengths()[0];
+    const std::size_t Y  = wei_kyxc.mDesc.GetLengths()[1];
+    const std::size_t X  = wei_kyxc.mDesc.GetLengths()[2];
+    const std::size_t Ho = out_nhwk.mDesc.GetLengths()[1];
+    const std::size_t Wo = out_nhwk.mDesc.GetLengths()[2];
+
+    if(wei_kyxc.mDesc.GetLengths()[3] != 1 || K % C != 0)
+        throw std::runtime_error("wrong! not a depthwise convolution");
+
+    // output channels per input channel
+    const std::size_t M = K / C;
+
+    const std::size_t ConvStrideH   = conv_strides[I0];
+    const std::size_t ConvStrideW   = conv_strides[I1];
+    const std::size_t ConvDilationH = conv_dilations[I0];
+    const std::size_t ConvDilationW = conv_dilations[I1];
+
+    const Tensor<InT> in_padded = host_conv_detail::get_zero_padded_tensor(in_nhwc,
+                                                                           1,
+                                                                           in_left_pads[I0],
+                                                                           in_right_pads[I0],
+                                                                           in_left_pads[I1],
+                                                                           in_right_pads[I1],
+                                                                           num_thread);
+
+    const std::size_t Hip = in_padded.mDesc.GetLengths()[1];
+    const std::size_t Wip = in_padded.mDesc.GetLengths()[2];
+
+    // padded input converted to AccT once, instead of at every multiply
+    std::vector<AccT> in_padded_acc;
+
+    const AccT* p_in_padded = nullptr;
+
+    if constexpr(std::is_same<InT, AccT>::value)
+    {
+        p_in_padded = in_padded.mData.data();
+    }
+    else
+    {
+        in_padded_acc.resize(in_padded.mData.size());
+        host_convert_to_acc(in_padded.mData.data(), in_padded_acc.data(), in_padded_acc.size());
+        p_in_padded = in_padded_acc.data();
+    }
+
+    // filter as Y x X x K
+    std::vector<AccT> wei_yxk(Y * X * K);
+
+    const auto& wei_strides = wei_kyxc.mDesc.GetStrides();
+
+    for(std::size_t k = 0; k < K; ++k)
+        for(std::size_t y = 0; y < Y; ++y)
+            for(std::size_t x = 0; x < X; ++x)
+                wei_yxk[(y * X + x) * K + k] = HostGemmDataType<WeiT>::ToAcc(
+                    wei_kyxc.mpData[k * wei_strides[0] + y * wei_strides[1] + x * wei_strides[2]]);
+
+    const auto& out_strides = out_nhwk.mDesc.GetStrides();
+
+    auto& pool = HostThreadPool::GetInstance();
+
+    const std::size_t num_chunk =
+        std::max<std::size_t>(num_thread, 1) * HostThreadPool::ChunkPerThread;
+
+    // one output row of all channels per task
+    pool.ParallelFor(0, N * Ho, num_chunk, [&](std::size_t ib, std::size_t ie) {
+        std::vector<AccT> acc(Wo * K);
+
+        for(std::size_t i = ib; i < ie; ++i)
+        {
+            const std::size_t n  = i / Ho;
+            const std::size_t ho = i % Ho;
+
+            std::fill(acc.begin(), acc.end(), AccT{0});
+
+            for(std::size_t wo = 0; wo < Wo; ++wo)
+            {
+                AccT* p_acc = acc.data() + wo * K;
+
+                for(std::size_t y = 0; y < Y; ++y)
+                {
+                    const std::size_t hi = ho * ConvStrideH + y * ConvDilationH;
+
+                    for(std::size_t x = 0; x < X; ++x)
+                    {
+                        const std::size_t wi = wo * ConvStrideW + x * ConvDilationW;
+
+                        const AccT* p_in  = p_in_padded + ((n * Hip + hi) * Wip + wi) * C;
+                        const AccT* p_wei = &wei_yxk[(y * X + x) * K];
+
+                        if(M == 1)
+                        {
+                            for(std::size_t k = 0; k < K; ++k)
+                                p_acc[k] += p_in[k] * p_wei[k];
+                        }
+                        else
+                        {
+                            for(std::size_t c = 0; c < C; ++c)
+                            {
+                                const AccT a = p_in[c];
+
+                                for(std::size_t m = 0; m < M; ++m)
+                                    p_acc[c * M + m] += a * p_wei[c * M + m];
+                            }
+                        }
+                    }
+                }
+            }
+
+            OutT* p_out = out_nhwk.mpData + n * out_strides[0] + ho * out_strides[1];
+
+            // along the unit-stride dimension of the output
+            if(out_strides[3] == 1)
+            {
+                for(std::size_t wo = 0; wo < Wo; ++wo)
+                    for(std::size_t k = 0; k < K; ++k)
+                        p_out[wo * out_strides[2] + k] =
+                            HostGemmDataType<OutT>::FromAcc(acc[wo * K + k]);
+            }
+            else
+            {
+                for(std::size_t k = 0; k < K; ++k)
+                    for(std::size_t wo = 0; wo < Wo; ++wo)
+                        p_out[wo * out_strides[2] + k * out_strides[3]] =
+                            HostGemmDataType<OutT>::FromAcc(acc[wo * K + k]);
+            }
+        }
+    });
+}
@@ -0,0 +1,476 @@
+#pragma once
+#include <cmath>
+#include <complex>
+#include "host_tensor.hpp"
+#include "host_gemm_packed.hpp"
+#include "conv_common.hpp"
+
+// host_conv_fwd_fft computes the whole stride-1 output in tiles of about twice the filter, and its
+// per-frequency C x K products are slower than the packed GEMM. Measured single-thread at -O3, it
+// only beats host_conv_fwd_implicit_gemm at stride 1 for large filters, few channels and large
+// outputs: 2.7x at 21x21, C = K = 16, 128x128 and 1.3x at 13x13, but 0.6x at 7x7, C = K = 64,
+// 56x56, 0.12x at 9x9, C = 256, 28x28 and 0.6x at stride 2
+constexpr std::size_t HostConvFftMinFilterSize     = 13 * 13;
+constexpr std::size_t HostConvFftMaxChannelProduct = 32 * 32;
+constexpr std::size_t HostConvFftMinOutputSize     = 96 * 96;
+
+namespace host_fft_detail {
+
+template <typename T>
+std::complex<T> complex_mul(const std::complex<T>& a, const std::complex<T>& b)
+{
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+// radix-2 complex FFT of a power-of-two size, in place on contiguous data.
+// forward: X[j] = sum_t x[t] * exp(-2 pi i j t / n), inverse is not normalized
+template <typename T>
+struct FftPlan
+{
+    std::size_t mSize;
+    std::vector<std::complex<T>> mTwiddle;
+
+    explicit FftPlan(std::size_t n) : mSize(n), mTwiddle(n / 2)
+    {
+        if(n == 0 || (n & (n - 1)) != 0)
+            throw std::runtime_error("wrong! FFT size must be a power of 2");
+
+        const double pi = std::acos(-1.0);
+
+        for(std::size_t j = 0; j < n / 2; ++j)
+        {
+            const double a = -2 * pi * j / n;
+
+            mTwiddle[j] = {static_cast<T>(std::cos(a)), static_cast<T>(std::sin(a))};
+        }
+    }
+
+    void Run(std::complex<T>* p, bool inverse) const
+    {
+        const std::size_t n = mSize;
+
+        for(std::size_t i = 1, j = 0; i < n; ++i)
+        {
+            std::size_t bit = n >> 1;
+
+            for(; j & bit; bit >>= 1)
+                j ^= bit;
+
+            j ^= bit;
+
+            if(i < j)
+                std::swap(p[i], p[j]);
+        }
+
+        for(std::size_t len = 2; len <= n; len <<= 1)
+        {
+            const std::size_t half = len / 2;
+            const std::size_t step = n / len;
+
+            for(std::size_t i = 0; i < n; i += len)
+            {
+                for(std::size_t j = 0; j < half; ++j)
+                {
+                    const std::complex<T> w =
+                        inverse ? std::conj(mTwiddle[j * step]) : mTwiddle[j * step];
+
+                    const std::complex<T> u = p[i + j];
+                    const std::complex<T> v = complex_mul(p[i + j + half], w);
+
+                    p[i + j]        = u + v;
+                    p[i + j + half] = u - v;
+                }
+            }
+        }
+    }
+};
+
+// 2-D FFT of a real FH x FW tile, of which only the FH x (FW / 2 + 1) non-redundant half is kept
+template <typename T>
+struct RealFft2d
+{
+    FftPlan<T> mPlanH;
+    FftPlan<T> mPlanW;
+
+    RealFft2d(std::size_t fh, std::size_t fw) : mPlanH(fh), mPlanW(fw) {}
+
+    std::size_t GetNumFreqH() const { return mPlanH.mSize; }
+    std::size_t GetNumFreqW() const { return mPlanW.mSize / 2 + 1; }
+    std::size_t GetNumFreq() const { return GetNumFreqH() * GetNumFreqW(); }
+
+    // p_dst[i * GetNumFreqW() + j] = X[i][j]; buf holds max(FH, FW) elements
+    void Forward(const T* p_src, std::complex<T>* p_dst, std::complex<T>* buf) const
+    {
+        const std::size_t fh = mPlanH.mSize, fw = mPlanW.mSize, nw = GetNumFreqW();
+
+        for(std::size_t i = 0; i < fh; ++i)
+        {
+            for(std::size_t j = 0; j < fw; ++j)
+                buf[j] = p_src[i * fw + j];
+
+            mPlanW.Run(buf, false);
+
+            std::copy(buf, buf + nw, p_dst + i * nw);
+        }
+
+        for(std::size_t j = 0; j < nw; ++j)
+        {
+            for(std::size_t i = 0; i < fh; ++i)
+                buf[i] = p_dst[i * nw + j];
+
+            mPlanH.Run(buf, false);
+
+            for(std::size_t i = 0; i < fh; ++i)
+                p_dst[i * nw + j] = buf[i];
+        }
+    }
+
+    // inverse of Forward, normalized; p_src is overwritten
+    void Inverse(std::complex<T>* p_src, T* p_dst, std::complex<T>* buf) const
+    {
+        const std::size_t fh = mPlanH.mSize, fw = mPlanW.mSize, nw = GetNumFreqW();
+
+        const T scale = T(1) / static_cast<T>(fh * fw);
+
+        for(std::size_t j = 0; j < nw; ++j)
+        {
+            for(std::size_t i = 0; i < fh; ++i)
+                buf[i] = p_src[i * nw + j];
+
+            mPlanH.Run(buf, true);
+
+            for(std::size_t i = 0; i < fh; ++i)
+                p_src[i * nw + j] = buf[i];
+        }
+
+        // every row is now the 1-D FFT of a real row, its upper half is the conjugate mirror
+        for(std::size_t i = 0; i < fh; ++i)
+        {
+            for(std::size_t j = 0; j < nw; ++j)
+                buf[j] = p_src[i * nw + j];
+
+            for(std::size_t j = nw; j < fw; ++j)
+                buf[j] = std::conj(p_src[i * nw + fw - j]);
+
+            mPlanW.Run(buf, true);
+
+            for(std::size_t j = 0; j < fw; ++j)
+                p_dst[i * fw + j] = buf[j].real() * scale;
+        }
+    }
+};
+
+// smallest power of two not less than n
+inline std::size_t next_pow2(std::size_t n)
+{
+    std::size_t p = 1;
+
+    while(p < n)
+        p <<= 1;
+
+    return p;
+}
+
+} // namespace host_fft_detail
+
+// FFT forward convolution on the CPU, with the same interface as host_direct_convolution, for
+// large and dilated filters whose cost in the direct and implicit GEMM engines grows with Y * X.
+// The stride-1 output is cut into tiles; each tile reads an FH x FW input window that includes
+// its halo (overlap-save, so output tiles are disjoint and need no accumulation), whose 2-D real
+// FFT is multiplied with the conjugate FFT of every filter. The sum over C for each frequency is
+// a complex GEMM, run as two real packed GEMMs on (re, im) interleaved data: one against X for
+// the real part, one against -iX for the imaginary part. The inverse FFT of each (tile, k) gives
+// the output tile, which is subsampled for strided convolutions. FH and FW are the powers of two
+// of about twice the dilated filter size. Arithmetic is in the accumulation type of the packed
+// GEMM, the filter transform takes K * C * FH * (FW / 2 + 1) complex values.
+// in, wei and out can be Tensor or TensorView
+template <typename InTensor,
+          typename WeiTensor,
+          typename OutTensor,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename InLeftPads,
+          typename InRightPads>
+void host_conv_fwd_fft(const InTensor& in_tensor,
+                       const WeiTensor& wei_tensor,
+                       OutTensor&& out_tensor,
+                       const ConvStrides& conv_strides,
+                       const ConvDilations& conv_dilations,
+                       const InLeftPads& in_left_pads,
+                       const InRightPads&,
+                       const ConvTensorLayout layout = ConvTensorLayout::NCHW,
+                       std::size_t num_thread        = std::thread::hardware_concurrency())
+{
+    using namespace ck;
+    using namespace host_fft_detail;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+
+    // size of the per-block workspace, in complex values
+    constexpr std::size_t WorkspaceSize = std::size_t(1) << 22;
+
+    using InT  = std::remove_const_t<typename decltype(make_tensor_view(in_tensor))::value_type>;
+    using WeiT = std::remove_const_t<typename decltype(make_tensor_view(wei_tensor))::value_type>;
+    using OutT = typename decltype(make_tensor_view(out_tensor))::value_type;
+    using AccT = typename HostGemmDataType<InT>::AccType;
+
+    using Complex = std::complex<AccT>;
+
+    const TensorView<const InT> in   = make_tensor_view(in_tensor);
+    const TensorView<const WeiT> wei = make_tensor_view(wei_tensor);
+    const auto out                   = make_tensor_view(out_tensor);
+
+    if(layout != ConvTensorLayout::NCHW && layout != ConvTensorLayout::NHWC)
+        throw std::runtime_error("wrong! not supported layout");
+
+    if(!std::is_floating_point<AccT>::value)
+        throw std::runtime_error("wrong! FFT convolution needs a floating point accumulation type");
+
+    const bool is_nchw = layout == ConvTensorLayout::NCHW;
+
+    // dimensions of C (K for wei and out), H and W
+    const std::size_t c_dim = is_nchw ? 1 : 3;
+    const std::size_t h_dim = is_nchw ? 2 : 1;
+    const std::size_t w_dim = h_dim + 1;
+
+    const std::size_t N  = in.mDesc.GetLengths()[0];
+    const std::size_t C  = in.mDesc.GetLengths()[c_dim];
+    const index_t Hi     = in.mDesc.GetLengths()[h_dim];
+    const index_t Wi     = in.mDesc.GetLengths()[w_dim];
+    const std::size_t K  = wei.mDesc.GetLengths()[0];
+    const std::size_t Y  = wei.mDesc.GetLengths()[h_dim];
+    const std::size_t X  = wei.mDesc.GetLengths()[w_dim];
+    const std::size_t Ho = out.mDesc.GetLengths()[h_dim];
+    const std::size_t Wo = out.mDesc.GetLengths()[w_dim];
+
+    const std::size_t ConvStrideH   = conv_strides[I0];
+    const std::size_t ConvStrideW   = conv_strides[I1];
+    const std::size_t ConvDilationH = conv_dilations[I0];
+    const std::size_t ConvDilationW = conv_dilations[I1];
+    const index_t InLeftPadH        = in_left_pads[I0];
+    const index_t InLeftPadW        = in_left_pads[I1];
+
+    const std::size_t YEff = (Y - 1) * ConvDilationH + 1;
+    const std::size_t XEff = (X - 1) * ConvDilationW + 1;
+
+    // rows and columns of the stride-1 output that are needed
+    const std::size_t HoFull = (Ho - 1) * ConvStrideH + 1;
+    const std::size_t WoFull = (Wo - 1) * ConvStrideW + 1;
+
+    const std::size_t FH =
+        std::min(next_pow2(std::max<std::size_t>(8, 2 * YEff - 1)), next_pow2(HoFull + YEff - 1));
+    const std::size_t FW =
+        std::min(next_pow2(std::max<std::size_t>(8, 2 * XEff - 1)), next_pow2(WoFull + XEff - 1));
+
+    // output rows and columns per tile
+    const std::size_t HoPerTile = FH - YEff + 1;
+    const std::size_t WoPerTile = FW - XEff + 1;
+
+    const std::size_t HTile = (HoFull + HoPerTile - 1) / HoPerTile;
+    const std::size_t WTile = (WoFull + WoPerTile - 1) / WoPerTile;
+    const std::size_t NTile = N * HTile * WTile;
+
+    const RealFft2d<AccT> fft(FH, FW);
+
+    const std::size_t NumFreq = fft.GetNumFreq();
+
+    const std::size_t TileBlock =
+        std::max<std::size_t>(1, std::min(NTile, WorkspaceSize / (NumFreq * (2 * C + K))));
+
+    const auto& in_strides  = in.mDesc.GetStrides();
+    const auto& wei_strides = wei.mDesc.GetStrides();
+    const auto& out_strides = out.mDesc.GetStrides();
+
+    auto& pool = HostThreadPool::GetInstance();
+
+    const std::size_t num_chunk =
+        std::max<std::size_t>(num_thread, 1) * HostThreadPool::ChunkPerThread;
+
+    const HostTensorAllocator<Complex> allocator(HostTensorMemoryPolicy::Uninitialized());
+
+    // filter spectra, NumFreq matrices of K x C
+    std::vector<Complex, HostTensorAllocator<Complex>> wei_freq(NumFreq * K * C, allocator);
+
+    pool.ParallelFor(0, K * C, num_chunk, [&](std::size_t ib, std::size_t ie) {
+        std::vector<AccT> tile(FH * FW);
+        std::vector<Complex> freq(NumFreq), buf(std::max(FH, FW));
+
+        for(std::size_t i = ib; i < ie; ++i)
+        {
+            const std::size_t k = i / C;
+            const std::size_t c = i % C;
+
+            std::fill(tile.begin(), tile.end(), AccT{0});
+
+            for(std::size_t y = 0; y < Y; ++y)
+                for(std::size_t x = 0; x < X; ++x)
+                    tile[y * ConvDilationH * FW + x * ConvDilationW] =
+                        HostGemmDataType<WeiT>::ToAcc(
+                            wei.mpData[k * wei_strides[0] + c * wei_strides[c_dim] +
+                                       y * wei_strides[h_dim] + x * wei_strides[w_dim]]);
+
+            fft.Forward(tile.data(), freq.data(), buf.data());
+
+            for(std::size_t f = 0; f < NumFreq; ++f)
+                wei_freq[(f * K + k) * C + c] = freq[f];
+        }
+    });
+
+    // per tile block: input spectra X and -iX, NumFreq matrices of TileBlock x C, and output
+    // spectra, NumFreq matrices of TileBlock x K
+    std::vector<Complex, HostTensorAllocator<Complex>> in_freq(NumFreq * TileBlock * C, allocator);
+    std::vector<Complex, HostTensorAllocator<Complex>> in_freq_rot(NumFreq * TileBlock * C,
+                                                                   allocator);
+    std::vector<Complex, HostTensorAllocator<Complex>> out_freq(NumFreq * TileBlock * K,
+                                                                allocator);
+
+    auto f_tile_origin = [&](std::size_t itile, std::size_t& n, index_t& h, index_t& w) {
+        n = itile / (HTile * WTile);
+        h = itile / WTile % HTile * HoPerTile;
+        w = itile % WTile * WoPerTile;
+    };
+
+    for(std::size_t tile_begin = 0; tile_begin < NTile; tile_begin += TileBlock)
+    {
+        const std::size_t num_tile = std::min(TileBlock, NTile - tile_begin);
+
+        // gather the FH x FW input windows, zero outside the input, and transform them
+        pool.ParallelFor(0, num_tile * C, num_chunk, [&](std::size_t ib, std::size_t ie) {
+            std::vector<AccT> window(FH * FW);
+            std::vector<Complex> freq(NumFreq), buf(std::max(FH, FW));
+
+            for(std::size_t i = ib; i < ie; ++i)
+            {
+                const std::size_t t = i / C;
+                const std::size_t c = i % C;
+
+                std::size_t n;
+                index_t h0, w0;
+                f_tile_origin(tile_begin + t, n, h0, w0);
+
+                for(std::size_t ih = 0; ih < FH; ++ih)
+                {
+                    const index_t hi = h0 + index_t(ih) - InLeftPadH;
+
+                    for(std::size_t iw = 0; iw < FW; ++iw)
+                    {
+                        const index_t wi = w0 + index_t(iw) - InLeftPadW;
+
+                        window[ih * FW + iw] =
+                            hi >= 0 && hi < Hi && wi >= 0 && wi < Wi
+                                ? HostGemmDataType<InT>::ToAcc(
+                                      in.mpData[n * in_strides[0] + c * in_strides[c_dim] +
+                                                hi * in_strides[h_dim] + wi * in_strides[w_dim]])
+                                : AccT{0};
+                    }
+                }
+
+                fft.Forward(window.data(), freq.data(), buf.data());
+
+                for(std::size_t f = 0; f < NumFreq; ++f)
+                {
+                    in_freq[(f * TileBlock + t) * C + c]     = freq[f];
+                    in_freq_rot[(f * TileBlock + t) * C + c] = {freq[f].imag(), -freq[f].real()};
+                }
+            }
+        });
+
+        // per frequency, Y = X * conj(W)^T over C:
+        //   Re(Y) = Re(X) Re(W) + Im(X) Im(W), Im(Y) = Im(X) Re(W) - Re(X) Im(W)
+        // both are real GEMMs over 2C with W as is, against X and -iX respectively
+        pool.ParallelFor(0, NumFreq, NumFreq, [&](std::size_t fb, std::size_t fe) {
+            for(std::size_t f = fb; f < fe; ++f)
+            {
+                const auto a = host_gemm_detail::GemmOperandStrided<AccT>{
+                    reinterpret_cast<const AccT*>(wei_freq.data() + f * K * C), 2 * C, 1};
+
+                AccT* p_out = reinterpret_cast<AccT*>(out_freq.data() + f * TileBlock * K);
+
+                host_gemm_detail::gemm_packed_dispatch(
+                    a,
+                    host_gemm_detail::GemmOperandStrided<AccT>{
+                        reinterpret_cast<const AccT*>(in_freq.data() + f * TileBlock * C),
+                        2 * C,
+                        1},
+                    host_gemm_detail::GemmOutputStrided<AccT>{p_out, 2, 2 * K},
+                    K,
+                    num_tile,
+                    2 * C,
+                    num_thread);
+
+                host_gemm_detail::gemm_packed_dispatch(
+                    a,
+                    host_gemm_detail::GemmOperandStrided<AccT>{
+                        reinterpret_cast<const AccT*>(in_freq_rot.data() + f * TileBlock * C),
+                        2 * C,
+                        1},
+                    host_gemm_detail::GemmOutputStrided<AccT>{p_out + 1, 2, 2 * K},
+                    K,
+                    num_tile,
+                    2 * C,
+                    num_thread);
+            }
+        });
+
+        // transform back, keep the valid part of every window, subsample by the conv strides
+        pool.ParallelFor(0, num_tile * K, num_chunk, [&](std::size_t ib, std::size_t ie) {
+            std::vector<AccT> window(FH * FW);
+            std::vector<Complex> freq(NumFreq), buf(std::max(FH, FW));
+
+            for(std::size_t i = ib; i < ie; ++i)
+            {
+                const std::size_t t = i / K;
+                const std::size_t k = i % K;
+
+                std::size_t n;
+                index_t h0, w0;
+                f_tile_origin(tile_begin + t, n, h0, w0);
+
+                for(std::size_t f = 0; f < NumFreq; ++f)
+                    freq[f] = out_freq[(f * TileBlock + t) * K + k];
+
+                fft.Inverse(freq.data(), window.data(), buf.data());
+
+                for(std::size_t ih = 0; ih < HoPerTile; ++ih)
+                {
+                    const std::size_t h = h0 + ih;
+
+                    if(h >= HoFull || h % ConvStrideH != 0)
+                        continue;
+
+                    for(std::size_t iw = 0; iw < WoPerTile; ++iw)
+                    {
+                        const std::size_t w = w0 + iw;
+
+                        if(w >= WoFull || w % ConvStrideW != 0)
+                            continue;
+
+                        out.mpData[n * out_strides[0] + k * out_strides[c_dim] +
+                                   h / ConvStrideH * out_strides[h_dim] +
+                                   w / ConvStrideW * out_strides[w_dim]] =
+                            HostGemmDataType<OutT>::FromAcc(window[ih * FW + iw]);
+                    }
+                }
+            }
+        });
+    }
+}
+
+// whether host_conv_fwd_fft is faster than host_conv_fwd_implicit_gemm for a layer, C and K are
+// the channels of one group
+inline bool is_host_conv_fft_preferred(std::size_t C,
+                                       std::size_t K,
+                                       std::size_t Y,
+                                       std::size_t X,
+                                       std::size_t Ho,
+                                       std::size_t Wo,
+                                       std::size_t conv_stride_h,
+                                       std::size_t conv_stride_w,
+                                       std::size_t conv_dilation_h,
+                                       std::size_t conv_dilation_w)
+{
+    return conv_stride_h == 1 && conv_stride_w == 1 && conv_dilation_h == 1 &&
+           conv_dilation_w == 1 && Y * X >= HostConvFftMinFilterSize &&
+           C * K <= HostConvFftMaxChannelProduct && Ho * Wo >= HostConvFftMinOutputSize;
+}
@@ -0,0 +1,698 @@
+#pragma once
+#include <initializer_list>
+#include <limits>
+#include <numeric>
+#include "host_tensor.hpp"
+#include "host_tensor_layout.hpp"
+#include "host_gemm_packed.hpp"
+#include "conv_common.hpp"
+#include "transform_forward_convolution_into_gemm_v4r4_nchw_kcyx_nkhw.hpp"
+#include "transform_forward_convolution_into_gemm_v4r4_nhwc_kyxc_nhwk.hpp"
+
+namespace host_conv_detail {
+
+// The GEMM views are CK descriptors, whose lengths and offsets are index_t. Throws if a tensor,
+// given by its element count, is too large for them
+inline void check_index_t_range(std::initializer_list<std::size_t> element_sizes)
+{
+    for(auto size : element_sizes)
+    {
+        if(size > static_cast<std::size_t>(std::numeric_limits<ck::index_t>::max()))
+            throw std::runtime_error("wrong! tensor too large for index_t offsets");
+    }
+}
+
+// For a 2-D descriptor whose offset is the sum of a row and a column term, as are all the GEMM
+// views of a convolution without padding: offset(i, j) = offset_0[i] + offset_1[j]
+template <typename Desc>
+void get_separable_offsets(const Desc& desc,
+                           std::vector<std::size_t>& offset_0,
+                           std::vector<std::size_t>& offset_1,
+                           std::size_t num_thread)
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+
+    offset_0.resize(desc.GetLength(I0));
+    offset_1.resize(desc.GetLength(I1));
+
+    const index_t offset_00 = desc.CalculateOffset(make_multi_index(0, 0));
+
+    auto& pool = HostThreadPool::GetInstance();
+
+    const std::size_t num_chunk =
+        std::max<std::size_t>(num_thread, 1) * HostThreadPool::ChunkPerThread;
+
+    pool.ParallelFor(0, offset_0.size(), num_chunk, [&](std::size_t ib, std::size_t ie) {
+        for(std::size_t i = ib; i < ie; ++i)
+            offset_0[i] =
+                desc.CalculateOffset(make_multi_index(static_cast<index_t>(i), 0)) - offset_00;
+    });
+
+    pool.ParallelFor(0, offset_1.size(), num_chunk, [&](std::size_t jb, std::size_t je) {
+        for(std::size_t j = jb; j < je; ++j)
+            offset_1[j] = desc.CalculateOffset(make_multi_index(0, static_cast<index_t>(j)));
+    });
+}
+
+// packed copy of a convolution tensor with zeros added before and after its spatial dimensions,
+// which are the pads_0.size() dimensions from first_dim on
+template <typename T>
+Tensor<T> get_zero_padded_tensor(const TensorView<const T>& src,
+                                 std::size_t first_dim,
+                                 const std::vector<std::size_t>& pads_0,
+                                 const std::vector<std::size_t>& pads_1,
+                                 std::size_t num_thread)
+{
+    std::vector<std::size_t> lens = src.mDesc.GetLengths();
+
+    for(std::size_t i = 0; i < pads_0.size(); ++i)
+        lens[first_dim + i] += pads_0[i] + pads_1[i];
+
+    HostTensorMemoryPolicy policy = HostTensorMemoryPolicy::GetDefault();
+    policy.mZeroFill              = true;
+
+    Tensor<T> dst(HostTensorDescriptor(lens), policy);
+
+    TensorView<T> interior = dst.View();
+
+    for(std::size_t i = 0; i < pads_0.size(); ++i)
+        interior = interior.Slice(first_dim + i, pads_0[i], lens[first_dim + i] - pads_1[i]);
+
+    host_tensor_copy(src, interior, num_thread);
+
+    return dst;
+}
+
+// packed copy of a 4-D convolution tensor with zeros added before and after its H and W
+// dimensions, which are dimensions h_dim and h_dim + 1
+template <typename T>
+Tensor<T> get_zero_padded_tensor(const TensorView<const T>& src,
+                                 std::size_t h_dim,
+                                 std::size_t h_pad_0,
+                                 std::size_t h_pad_1,
+                                 std::size_t w_pad_0,
+                                 std::size_t w_pad_1,
+                                 std::size_t num_thread)
+{
+    return get_zero_padded_tensor(src, h_dim, {h_pad_0, w_pad_0}, {h_pad_1, w_pad_1}, num_thread);
+}
+
+} // namespace host_conv_detail
+
+// Forward convolution on the CPU as an implicit GEMM, with the same interface as
+// host_direct_convolution (which stays as the simple reference). The GEMM is the one CK maps the
+// convolution onto in transform_forward_convolution_into_gemm_v4r4_{nchw_kcyx_nkhw,
+// nhwc_kyxc_nhwk}: GemmM = K, GemmN = N * Ho * Wo, GemmK = C * Y * X. Its B matrix is never
+// materialized; the panels of it the blocked GEMM works on are gathered straight from the input,
+// using row and column offset tables computed from the CK descriptors.
+// Padding would break the row/column split of the offsets, so a padded copy of the input is made
+// when there is any.
+// Grouped convolutions, whose weight has C / G channels, are one GEMM per group.
+// in can be Tensor or TensorView, wei and out must be packed
+template <typename InTensor,
+          typename WeiTensor,
+          typename OutTensor,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename InLeftPads,
+          typename InRightPads>
+void host_conv_fwd_implicit_gemm(const InTensor& in_tensor,
+                                 const WeiTensor& wei_tensor,
+                                 OutTensor&& out_tensor,
+                                 const ConvStrides& conv_strides,
+                                 const ConvDilations& conv_dilations,
+                                 const InLeftPads& in_left_pads,
+                                 const InRightPads& in_right_pads,
+                                 const ConvTensorLayout layout = ConvTensorLayout::NCHW,
+                                 std::size_t num_thread = std::thread::hardware_concurrency())
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+
+    using InT = std::remove_const_t<typename decltype(make_tensor_view(in_tensor))::value_type>;
+
+    const TensorView<const InT> in = make_tensor_view(in_tensor);
+    const auto wei                 = make_tensor_view(wei_tensor);
+    const auto out                 = make_tensor_view(out_tensor);
+
+    if(layout != ConvTensorLayout::NCHW && layout != ConvTensorLayout::NHWC)
+        throw std::runtime_error("wrong! not supported layout");
+
+    if(!wei.mDesc.IsPacked() || !out.mDesc.IsPacked())
+        throw std::runtime_error("wrong! weight and output must be packed");
+
+    const bool is_nchw = layout == ConvTensorLayout::NCHW;
+
+    const auto& in_lens  = in.mDesc.GetLengths();
+    const auto& wei_lens = wei.mDesc.GetLengths();
+    const auto& out_lens = out.mDesc.GetLengths();
+
+    const index_t N  = in_lens[0];
+    const index_t C  = is_nchw ? in_lens[1] : in_lens[3];
+    const index_t Hi = is_nchw ? in_lens[2] : in_lens[1];
+    const index_t Wi = is_nchw ? in_lens[3] : in_lens[2];
+    const index_t K  = wei_lens[0];
+    const index_t Y  = is_nchw ? wei_lens[2] : wei_lens[1];
+    const index_t X  = is_nchw ? wei_lens[3] : wei_lens[2];
+    const index_t Ho = is_nchw ? out_lens[2] : out_lens[1];
+    const index_t Wo = is_nchw ? out_lens[3] : out_lens[2];
+
+    const index_t CPerGroup = is_nchw ? wei_lens[1] : wei_lens[3];
+    const index_t G         = C / CPerGroup;
+    const index_t KPerGroup = K / G;
+
+    if(G * CPerGroup != C || G * KPerGroup != K)
+        throw std::runtime_error("wrong! C and K must be multiples of the group count");
+
+    const index_t Hip = Hi + in_left_pads[I0] + in_right_pads[I0];
+    const index_t Wip = Wi + in_left_pads[I1] + in_right_pads[I1];
+
+    host_conv_detail::check_index_t_range({in.mDesc.GetElementSize(),
+                                           wei.mDesc.GetElementSize(),
+                                           out.mDesc.GetElementSize(),
+                                           std::size_t(N) * C * Hip * Wip});
+
+    // zero-padded, packed copy of the input, left empty when the input can be read directly
+    const bool use_padded = Hip != Hi || Wip != Wi || !in.mDesc.IsPacked();
+
+    const Tensor<InT> in_padded =
+        use_padded ? host_conv_detail::get_zero_padded_tensor(in,
+                                                              is_nchw ? 2 : 1,
+                                                              in_left_pads[I0],
+                                                              in_right_pads[I0],
+                                                              in_left_pads[I1],
+                                                              in_right_pads[I1],
+                                                              num_thread)
+                   : Tensor<InT>(std::vector<std::size_t>{});
+
+    const InT* p_in = use_padded ? in_padded.mData.data() : in.mpData;
+
+    const auto conv_strides_dev = make_tuple(index_t(conv_strides[I0]), index_t(conv_strides[I1]));
+    const auto conv_dilations_dev =
+        make_tuple(index_t(conv_dilations[I0]), index_t(conv_dilations[I1]));
+    const auto zero_pads_dev = make_tuple(index_t(0), index_t(0));
+
+    // offsets of the GEMM matrices, GemmK x GemmM for weight, GemmK x GemmN for input and
+    // GemmM x GemmN for output. The input ones are for the channels of group 0, the other groups
+    // are the same GEMM on M rows and input channels further on
+    std::vector<std::size_t> wei_offset_k, wei_offset_m;
+    std::vector<std::size_t> in_offset_k, in_offset_n;
+    std::vector<std::size_t> out_offset_m, out_offset_n;
+
+    auto f_get_offsets = [&](const auto& descs) {
+        host_conv_detail::get_separable_offsets(
+            descs[Number<0>{}], wei_offset_k, wei_offset_m, num_thread);
+        host_conv_detail::get_separable_offsets(
+            descs[Number<1>{}], in_offset_k, in_offset_n, num_thread);
+        host_conv_detail::get_separable_offsets(
+            descs[Number<2>{}], out_offset_m, out_offset_n, num_thread);
+    };
+
+    if(is_nchw)
+    {
+        f_get_offsets(transform_forward_convolution_into_gemm_v4r4_nchw_kcyx_nkhw_no_pad(
+            make_naive_tensor_descriptor_packed(make_tuple(K, CPerGroup, Y, X)),
+            make_naive_tensor_descriptor(make_tuple(N, CPerGroup, Hip, Wip),
+                                         make_tuple(C * Hip * Wip, Hip * Wip, Wip, 1)),
+            make_naive_tensor_descriptor_packed(make_tuple(N, K, Ho, Wo)),
+            conv_strides_dev,
+            conv_dilations_dev,
+            zero_pads_dev,
+            zero_pads_dev));
+    }
+    else
+    {
+        f_get_offsets(transform_forward_convolution_into_gemm_v4r4_nhwc_kyxc_nhwk_pad(
+            make_naive_tensor_descriptor_packed(make_tuple(K, Y, X, CPerGroup)),
+            make_naive_tensor_descriptor(make_tuple(N, Hip, Wip, CPerGroup),
+                                         make_tuple(Hip * Wip * C, Wip * C, C, 1)),
+            make_naive_tensor_descriptor_packed(make_tuple(N, Ho, Wo, K)),
+            conv_strides_dev,
+            conv_dilations_dev,
+            zero_pads_dev,
+            zero_pads_dev));
+    }
+
+    using WeiT = std::remove_const_t<typename decltype(make_tensor_view(wei_tensor))::value_type>;
+    using OutT = typename decltype(make_tensor_view(out_tensor))::value_type;
+
+    const std::size_t in_group_stride = is_nchw ? std::size_t(CPerGroup) * Hip * Wip : CPerGroup;
+
+    for(index_t g = 0; g < G; ++g)
+    {
+        host_gemm_detail::gemm_packed_dispatch(
+            host_gemm_detail::GemmOperandSeparable<WeiT>{
+                wei.mpData, wei_offset_m.data() + g * KPerGroup, wei_offset_k.data()},
+            host_gemm_detail::GemmOperandSeparable<InT>{
+                p_in + g * in_group_stride, in_offset_n.data(), in_offset_k.data()},
+            host_gemm_detail::GemmOutputSeparable<OutT>{
+                out.mpData, out_offset_m.data() + g * KPerGroup, out_offset_n.data()},
+            KPerGroup,
+            out_offset_n.size(),
+            in_offset_k.size(),
+            num_thread);
+    }
+}
+
+// Backward-data convolution on the CPU as a set of dense GEMMs, with the same interface as
+// host_direct_convolution_backward_data (which stays as the simple reference). The problem is
+// split the way transform_backward_data_convolution_into_gemm_v4r1_nhwc_kyxc_nhwk does it: with
+// YTilda = ConvStrideH / gcd(ConvStrideH, ConvDilationH), the filter taps
+// y = ydot * YTilda + ytilda of one ytilda only reach the input rows
+// hi = htilda * ConvStrideH + ytilda * ConvDilationH - InLeftPadH, from output rows
+// ho = htilda - ydot * ConvDilationH / gcd(ConvStrideH, ConvDilationH), and likewise along W.
+// Each (ytilda, xtilda) is then a GEMM with GemmM = C, GemmN = N * HTilda * WTilda and
+// GemmK = YDot * XDot * K, which writes its own set of input pixels and never multiplies by a
+// tap that does not apply. Output rows reached past the ends of out are read as zero from a
+// padded copy of it. Input pixels no filter tap reaches (possible when gcd > 1) are zero.
+// in, wei and out can be Tensor or TensorView
+template <typename InTensor,
+          typename WeiTensor,
+          typename OutTensor,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename InLeftPads,
+          typename InRightPads>
+void host_conv_bwd_data_implicit_gemm(InTensor&& in_tensor,
+                                      const WeiTensor& wei_tensor,
+                                      const OutTensor& out_tensor,
+                                      const ConvStrides& conv_strides,
+                                      const ConvDilations& conv_dilations,
+                                      const InLeftPads& in_left_pads,
+                                      const InRightPads&,
+                                      const ConvTensorLayout layout = ConvTensorLayout::NCHW,
+                                      std::size_t num_thread = std::thread::hardware_concurrency())
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+
+    using InT  = typename decltype(make_tensor_view(in_tensor))::value_type;
+    using WeiT = std::remove_const_t<typename decltype(make_tensor_view(wei_tensor))::value_type>;
+    using OutT = std::remove_const_t<typename decltype(make_tensor_view(out_tensor))::value_type>;
+
+    const auto in                    = make_tensor_view(in_tensor);
+    const TensorView<const WeiT> wei = make_tensor_view(wei_tensor);
+    const TensorView<const OutT> out = make_tensor_view(out_tensor);
+
+    if(layout != ConvTensorLayout::NCHW && layout != ConvTensorLayout::NHWC)
+        throw std::runtime_error("wrong! not supported layout");
+
+    // dimensions of C (K for wei and out), H and W
+    const std::size_t c_dim = layout == ConvTensorLayout::NCHW ? 1 : 3;
+    const std::size_t h_dim = layout == ConvTensorLayout::NCHW ? 2 : 1;
+    const std::size_t w_dim = h_dim + 1;
+
+    const index_t N  = in.mDesc.GetLengths()[0];
+    const index_t C  = in.mDesc.GetLengths()[c_dim];
+    const index_t Hi = in.mDesc.GetLengths()[h_dim];
+    const index_t Wi = in.mDesc.GetLengths()[w_dim];
+    const index_t K  = wei.mDesc.GetLengths()[0];
+    const index_t Y  = wei.mDesc.GetLengths()[h_dim];
+    const index_t X  = wei.mDesc.GetLengths()[w_dim];
+    const index_t Ho = out.mDesc.GetLengths()[h_dim];
+    const index_t Wo = out.mDesc.GetLengths()[w_dim];
+
+    const index_t ConvStrideH   = conv_strides[I0];
+    const index_t ConvStrideW   = conv_strides[I1];
+    const index_t ConvDilationH = conv_dilations[I0];
+    const index_t ConvDilationW = conv_dilations[I1];
+    const index_t InLeftPadH    = in_left_pads[I0];
+    const index_t InLeftPadW    = in_left_pads[I1];
+
+    const index_t GcdStrideDilationH = std::gcd(ConvStrideH, ConvDilationH);
+    const index_t GcdStrideDilationW = std::gcd(ConvStrideW, ConvDilationW);
+
+    const index_t YTilda = ConvStrideH / GcdStrideDilationH;
+    const index_t XTilda = ConvStrideW / GcdStrideDilationW;
+
+    const index_t DotStepH = ConvDilationH / GcdStrideDilationH;
+    const index_t DotStepW = ConvDilationW / GcdStrideDilationW;
+
+    auto f_floor_div = [](index_t a, index_t b) { return a >= 0 ? a / b : -((-a + b - 1) / b); };
+
+    // for tap ytilda: the htilda that reach [0, Hi), and the taps ydot < YDotSlice that exist
+    struct SubProblem
+    {
+        index_t mBegin, mEnd, mDotSlice;
+    };
+
+    auto f_sub_problem = [&](index_t itilda,
+                             index_t Tilda,
+                             index_t Len,
+                             index_t Filter,
+                             index_t ConvStride,
+                             index_t ConvDilation,
+                             index_t InLeftPad) {
+        SubProblem sub;
+
+        sub.mBegin    = -f_floor_div(itilda * ConvDilation - InLeftPad, ConvStride);
+        sub.mEnd      = f_floor_div(Len - 1 + InLeftPad - itilda * ConvDilation, ConvStride) + 1;
+        sub.mDotSlice = std::max(0, (Filter - itilda + Tilda - 1) / Tilda);
+
+        return sub;
+    };
+
+    std::vector<SubProblem> sub_h(YTilda), sub_w(XTilda);
+
+    for(index_t i = 0; i < YTilda; ++i)
+        sub_h[i] = f_sub_problem(i, YTilda, Hi, Y, ConvStrideH, ConvDilationH, InLeftPadH);
+
+    for(index_t i = 0; i < XTilda; ++i)
+        sub_w[i] = f_sub_problem(i, XTilda, Wi, X, ConvStrideW, ConvDilationW, InLeftPadW);
+
+    // padding of out covering every ho = htilda - ydot * DotStepH the sub-problems read
+    auto f_get_pads = [](const std::vector<SubProblem>& subs, index_t DotStep, index_t Len) {
+        index_t pad_0 = 0, pad_1 = 0;
+
+        for(const auto& sub : subs)
+        {
+            if(sub.mBegin >= sub.mEnd || sub.mDotSlice == 0)
+                continue;
+
+            pad_0 = std::max(pad_0, (sub.mDotSlice - 1) * DotStep - sub.mBegin);
+            pad_1 = std::max(pad_1, sub.mEnd - Len);
+        }
+
+        return std::make_pair(pad_0, pad_1);
+    };
+
+    const auto pads_h = f_get_pads(sub_h, DotStepH, Ho);
+    const auto pads_w = f_get_pads(sub_w, DotStepW, Wo);
+
+    const Tensor<OutT> out_padded = host_conv_detail::get_zero_padded_tensor(
+        out, h_dim, pads_h.first, pads_h.second, pads_w.first, pads_w.second, num_thread);
+
+    if(GcdStrideDilationH > 1 || GcdStrideDilationW > 1)
+    {
+        in.ForEach([](auto& v, auto...) { v = InT{0}; }, num_thread);
+    }
+
+    const auto& in_strides  = in.mDesc.GetStrides();
+    const auto& wei_strides = wei.mDesc.GetStrides();
+    const auto& out_strides = out_padded.mDesc.GetStrides();
+
+    std::vector<std::size_t> in_offset_m(C), wei_offset_m(C);
+
+    for(index_t c = 0; c < C; ++c)
+    {
+        in_offset_m[c]  = c * in_strides[c_dim];
+        wei_offset_m[c] = c * wei_strides[c_dim];
+    }
+
+    std::vector<std::size_t> in_offset_n, out_offset_n;
+    std::vector<std::size_t> wei_offset_k, out_offset_k;
+
+    for(index_t ytilda = 0; ytilda < YTilda; ++ytilda)
+    {
+        for(index_t xtilda = 0; xtilda < XTilda; ++xtilda)
+        {
+            const auto& sh = sub_h[ytilda];
+            const auto& sw = sub_w[xtilda];
+
+            if(sh.mBegin >= sh.mEnd || sw.mBegin >= sw.mEnd)
+                continue;
+
+            const index_t HTildaSlice = sh.mEnd - sh.mBegin;
+            const index_t WTildaSlice = sw.mEnd - sw.mBegin;
+
+            // GemmN = N * HTildaSlice * WTildaSlice
+            in_offset_n.resize(N * HTildaSlice * WTildaSlice);
+            out_offset_n.resize(N * HTildaSlice * WTildaSlice);
+
+            // row of out_padded read by the last ydot, the others are DotStepH rows up from it
+            const index_t ho_0 =
+                sh.mBegin + pads_h.first - std::max(0, sh.mDotSlice - 1) * DotStepH;
+            const index_t wo_0 =
+                sw.mBegin + pads_w.first - std::max(0, sw.mDotSlice - 1) * DotStepW;
+
+            for(index_t n = 0, gemmn = 0; n < N; ++n)
+            {
+                for(index_t i = 0; i < HTildaSlice; ++i)
+                {
+                    for(index_t j = 0; j < WTildaSlice; ++j, ++gemmn)
+                    {
+                        const index_t hi =
+                            (sh.mBegin + i) * ConvStrideH + ytilda * ConvDilationH - InLeftPadH;
+                        const index_t wi =
+                            (sw.mBegin + j) * ConvStrideW + xtilda * ConvDilationW - InLeftPadW;
+
+                        in_offset_n[gemmn] = n * in_strides[0] + hi * in_strides[h_dim] +
+                                             wi * in_strides[w_dim];
+                        out_offset_n[gemmn] = n * out_strides[0] +
+                                              (ho_0 + i) * out_strides[h_dim] +
+                                              (wo_0 + j) * out_strides[w_dim];
+                    }
+                }
+            }
+
+            // GemmK = YDotSlice * XDotSlice * K
+            wei_offset_k.resize(sh.mDotSlice * sw.mDotSlice * K);
+            out_offset_k.resize(sh.mDotSlice * sw.mDotSlice * K);
+
+            for(index_t ydot = 0, gemmk = 0; ydot < sh.mDotSlice; ++ydot)
+            {
+                for(index_t xdot = 0; xdot < sw.mDotSlice; ++xdot)
+                {
+                    for(index_t k = 0; k < K; ++k, ++gemmk)
+                    {
+                        const index_t y = ydot * YTilda + ytilda;
+                        const index_t x = xdot * XTilda + xtilda;
+
+                        wei_offset_k[gemmk] =
+                            k * wei_strides[0] + y * wei_strides[h_dim] + x * wei_strides[w_dim];
+                        out_offset_k[gemmk] =
+                            k * out_strides[c_dim] +
+                            (sh.mDotSlice - 1 - ydot) * DotStepH * out_strides[h_dim] +
+                            (sw.mDotSlice - 1 - xdot) * DotStepW * out_strides[w_dim];
+                    }
+                }
+            }
+
+            host_gemm_detail::gemm_packed_dispatch(
+                host_gemm_detail::GemmOperandSeparable<WeiT>{
+                    wei.mpData, wei_offset_m.data(), wei_offset_k.data()},
+                host_gemm_detail::GemmOperandSeparable<OutT>{
+                    out_padded.mData.data(), out_offset_n.data(), out_offset_k.data()},
+                host_gemm_detail::GemmOutputSeparable<InT>{
+                    in.mpData, in_offset_m.data(), in_offset_n.data()},
+                in_offset_m.size(),
+                in_offset_n.size(),
+                wei_offset_k.size(),
+                num_thread);
+        }
+    }
+}
+
+// Backward-weight convolution on the CPU as a GEMM with GemmM = K, GemmN = C * Y * X (Y * X * C
+// for NHWC) and GemmK = N * Ho * Wo, with the same interface as
+// host_direct_convolution_backward_weights (which stays as the simple reference). Like the GemmK
+// split into GemmKBatch in transform_backward_weight_convolution_into_gemm_v4r4r4_atomic_nhwc_
+// kyxc_nhwk, the N * Ho * Wo reduction is split into batches whose partial GEMMs run
+// concurrently, so small K * C layers still keep every thread busy. Instead of atomics the
+// partial results are summed in a fixed pairwise tree; the number of batches only depends on the
+// problem shape, so the result is the same for any number of threads.
+// out, in and wei can be Tensor or TensorView
+template <typename OutTensor,
+          typename InTensor,
+          typename WeiTensor,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename InLeftPads,
+          typename InRightPads>
+void host_conv_bwd_weight_implicit_gemm(
+    const OutTensor& out_tensor,
+    const InTensor& in_tensor,
+    WeiTensor&& wei_tensor,
+    const ConvStrides& conv_strides,
+    const ConvDilations& conv_dilations,
+    const InLeftPads& in_left_pads,
+    const InRightPads& in_right_pads,
+    const ConvTensorLayout layout = ConvTensorLayout::NCHW,
+    std::size_t num_thread        = std::thread::hardware_concurrency())
+{
+    using namespace ck;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+
+    // GemmK of a batch is at least GemmKPerBatch, and all partial results together take at most
+    // WorkspaceSize elements
+    constexpr std::size_t GemmKPerBatch = 1024;
+    constexpr std::size_t MaxKBatch     = 64;
+    constexpr std::size_t WorkspaceSize = std::size_t(1) << 26;
+
+    using OutT = std::remove_const_t<typename decltype(make_tensor_view(out_tensor))::value_type>;
+    using InT  = std::remove_const_t<typename decltype(make_tensor_view(in_tensor))::value_type>;
+    using WeiT = typename decltype(make_tensor_view(wei_tensor))::value_type;
+    using AccT = typename HostGemmDataType<OutT>::AccType;
+
+    const TensorView<const OutT> out = make_tensor_view(out_tensor);
+    const TensorView<const InT> in   = make_tensor_view(in_tensor);
+    const auto wei                   = make_tensor_view(wei_tensor);
+
+    if(layout != ConvTensorLayout::NCHW && layout != ConvTensorLayout::NHWC)
+        throw std::runtime_error("wrong! not supported layout");
+
+    const bool is_nchw = layout == ConvTensorLayout::NCHW;
+
+    // dimensions of C (K for wei and out), H and W
+    const std::size_t c_dim = is_nchw ? 1 : 3;
+    const std::size_t h_dim = is_nchw ? 2 : 1;
+    const std::size_t w_dim = h_dim + 1;
+
+    const std::size_t N  = in.mDesc.GetLengths()[0];
+    const std::size_t C  = in.mDesc.GetLengths()[c_dim];
+    const std::size_t K  = wei.mDesc.GetLengths()[0];
+    const std::size_t Y  = wei.mDesc.GetLengths()[h_dim];
+    const std::size_t X  = wei.mDesc.GetLengths()[w_dim];
+    const std::size_t Ho = out.mDesc.GetLengths()[h_dim];
+    const std::size_t Wo = out.mDesc.GetLengths()[w_dim];
+
+    const std::size_t ConvStrideH   = conv_strides[I0];
+    const std::size_t ConvStrideW   = conv_strides[I1];
+    const std::size_t ConvDilationH = conv_dilations[I0];
+    const std::size_t ConvDilationW = conv_dilations[I1];
+
+    // the input is read directly unless it needs padding
+    const bool use_padded = in_left_pads[I0] != 0 || in_right_pads[I0] != 0 ||
+                            in_left_pads[I1] != 0 || in_right_pads[I1] != 0;
+
+    const Tensor<InT> in_padded =
+        use_padded ? host_conv_detail::get_zero_padded_tensor(in,
+                                                              h_dim,
+                                                              in_left_pads[I0],
+                                                              in_right_pads[I0],
+                                                              in_left_pads[I1],
+                                                              in_right_pads[I1],
+                                                              num_thread)
+                   : Tensor<InT>(std::vector<std::size_t>{});
+
+    const InT* p_in = use_padded ? in_padded.mData.data() : in.mpData;
+
+    const auto& in_strides  = use_padded ? in_padded.mDesc.GetStrides() : in.mDesc.GetStrides();
+    const auto& out_strides = out.mDesc.GetStrides();
+    const auto& wei_strides = wei.mDesc.GetStrides();
+
+    const std::size_t GemmM = K;
+    const std::size_t GemmN = C * Y * X;
+    const std::size_t GemmK = N * Ho * Wo;
+
+    std::vector<std::size_t> out_offset_m(GemmM), out_offset_k(GemmK);
+    std::vector<std::size_t> in_offset_n(GemmN), in_offset_k(GemmK);
+    std::vector<std::size_t> wei_offset_m(GemmM), wei_offset_n(GemmN);
+
+    for(std::size_t k = 0; k < K; ++k)
+    {
+        out_offset_m[k] = k * out_strides[c_dim];
+        wei_offset_m[k] = k * wei_strides[0];
+    }
+
+    for(std::size_t c = 0; c < C; ++c)
+    {
+        for(std::size_t y = 0; y < Y; ++y)
+        {
+            for(std::size_t x = 0; x < X; ++x)
+            {
+                const std::size_t gemmn = is_nchw ? (c * Y + y) * X + x : (y * X + x) * C + c;
+
+                in_offset_n[gemmn] = c * in_strides[c_dim] + y * ConvDilationH * in_strides[h_dim] +
+                                     x * ConvDilationW * in_strides[w_dim];
+                wei_offset_n[gemmn] =
+                    c * wei_strides[c_dim] + y * wei_strides[h_dim] + x * wei_strides[w_dim];
+            }
+        }
+    }
+
+    for(std::size_t n = 0, gemmk = 0; n < N; ++n)
+    {
+        for(std::size_t ho = 0; ho < Ho; ++ho)
+        {
+            for(std::size_t wo = 0; wo < Wo; ++wo, ++gemmk)
+            {
+                out_offset_k[gemmk] =
+                    n * out_strides[0] + ho * out_strides[h_dim] + wo * out_strides[w_dim];
+                in_offset_k[gemmk] = n * in_strides[0] + ho * ConvStrideH * in_strides[h_dim] +
+                                     wo * ConvStrideW * in_strides[w_dim];
+            }
+        }
+    }
+
+    const std::size_t KBatch = std::max<std::size_t>(
+        1,
+        std::min({(GemmK + GemmKPerBatch - 1) / GemmKPerBatch,
+                  WorkspaceSize / std::max<std::size_t>(GemmM * GemmN, 1),
+                  MaxKBatch}));
+
+    if(KBatch == 1)
+    {
+        host_gemm_detail::gemm_packed_dispatch(
+            host_gemm_detail::GemmOperandSeparable<OutT>{
+                out.mpData, out_offset_m.data(), out_offset_k.data()},
+            host_gemm_detail::GemmOperandSeparable<InT>{
+                p_in, in_offset_n.data(), in_offset_k.data()},
+            host_gemm_detail::GemmOutputSeparable<WeiT>{
+                wei.mpData, wei_offset_m.data(), wei_offset_n.data()},
+            GemmM,
+            GemmN,
+            GemmK,
+            num_thread);
+
+        return;
+    }
+
+    // one row-major GemmM x GemmN partial result per batch
+    std::vector<AccT, HostTensorAllocator<AccT>> workspace(
+        KBatch * GemmM * GemmN, HostTensorAllocator<AccT>(HostTensorMemoryPolicy::Uninitialized()));
+
+    auto& pool = HostThreadPool::GetInstance();
+
+    pool.ParallelFor(0, KBatch, KBatch, [&](std::size_t ib, std::size_t ie) {
+        for(std::size_t ibatch = ib; ibatch < ie; ++ibatch)
+        {
+            const std::size_t gemmk_begin = GemmK * ibatch / KBatch;
+            const std::size_t gemmk_end   = GemmK * (ibatch + 1) / KBatch;
+
+            host_gemm_detail::gemm_packed_dispatch(
+                host_gemm_detail::GemmOperandSeparable<OutT>{
+                    out.mpData, out_offset_m.data(), out_offset_k.data() + gemmk_begin},
+                host_gemm_detail::GemmOperandSeparable<InT>{
+                    p_in, in_offset_n.data(), in_offset_k.data() + gemmk_begin},
+                host_gemm_detail::GemmOutputStrided<AccT>{
+                    workspace.data() + ibatch * GemmM * GemmN, GemmN, 1},
+                GemmM,
+                GemmN,
+                gemmk_end - gemmk_begin,
+                num_thread);
+        }
+    });
+
+    // pairwise tree over the batches, element by element, then into wei
+    const std::size_t num_chunk =
+        std::max<std::size_t>(num_thread, 1) * HostThreadPool::ChunkPerThread;
+
+    pool.ParallelFor(0, GemmM, num_chunk, [&](std::size_t mb, std::size_t me) {
+        for(std::size_t step = 1; step < KBatch; step *= 2)
+        {
+            for(std::size_t ibatch = 0; ibatch + step < KBatch; ibatch += 2 * step)
+            {
+                AccT* p_dst       = workspace.data() + ibatch * GemmM * GemmN;
+                const AccT* p_src = workspace.data() + (ibatch + step) * GemmM * GemmN;
+
+                for(std::size_t i = mb * GemmN; i < me * GemmN; ++i)
+                    p_dst[i] += p_src[i];
+            }
+        }
+
+        for(std::size_t m = mb; m < me; ++m)
+            for(std::size_t n = 0; n < GemmN; ++n)
+                wei.mpData[wei_offset_m[m] + wei_offset_n[n]] =
+                    HostGemmDataType<WeiT>::FromAcc(workspace[m * GemmN + n]);
+    });
+}
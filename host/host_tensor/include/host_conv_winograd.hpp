@@ -0,0 +1,387 @@
+#pragma once
+#include "host_tensor.hpp"
+#include "host_gemm_packed.hpp"
+#include "conv_common.hpp"
+
+// Transform matrices of Winograd F(m x m, 3 x 3): out tile = AT * [(G g GT) .* (BT d B)] * A
+// for an Alpha x Alpha input tile d, Alpha = m + 2. F(2, 3) and F(4, 3) are Lavin's, F(6, 3)
+// uses the interpolation points 0, +-1, +-2, +-1/2.
+template <std::size_t OutTileSize>
+struct HostWinogradTransform3x3;
+
+template <>
+struct HostWinogradTransform3x3<2>
+{
+    static constexpr std::size_t Alpha = 4;
+
+    static constexpr double BT[4][4] = {
+        {1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}};
+
+    static constexpr double G[4][3] = {{1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}};
+
+    static constexpr double AT[2][4] = {{1, 1, 1, 0}, {0, 1, -1, -1}};
+};
+
+template <>
+struct HostWinogradTransform3x3<4>
+{
+    static constexpr std::size_t Alpha = 6;
+
+    static constexpr double BT[6][6] = {{4, 0, -5, 0, 1, 0},
+                                        {0, -4, -4, 1, 1, 0},
+                                        {0, 4, -4, -1, 1, 0},
+                                        {0, -2, -1, 2, 1, 0},
+                                        {0, 2, -1, -2, 1, 0},
+                                        {0, 4, 0, -5, 0, 1}};
+
+    static constexpr double G[6][3] = {{1. / 4, 0, 0},
+                                       {-1. / 6, -1. / 6, -1. / 6},
+                                       {-1. / 6, 1. / 6, -1. / 6},
+                                       {1. / 24, 1. / 12, 1. / 6},
+                                       {1. / 24, -1. / 12, 1. / 6},
+                                       {0, 0, 1}};
+
+    static constexpr double AT[4][6] = {
+        {1, 1, 1, 1, 1, 0}, {0, 1, -1, 2, -2, 0}, {0, 1, 1, 4, 4, 0}, {0, 1, -1, 8, -8, 1}};
+};
+
+template <>
+struct HostWinogradTransform3x3<6>
+{
+    static constexpr std::size_t Alpha = 8;
+
+    static constexpr double BT[8][8] = {{1, 0, -21. / 4, 0, 21. / 4, 0, -1, 0},
+                                        {0, 1, 1, -17. / 4, -17. / 4, 1, 1, 0},
+                                        {0, -1, 1, 17. / 4, -17. / 4, -1, 1, 0},
+                                        {0, 1. / 2, 1. / 4, -5. / 2, -5. / 4, 2, 1, 0},
+                                        {0, -1. / 2, 1. / 4, 5. / 2, -5. / 4, -2, 1, 0},
+                                        {0, 2, 4, -5. / 2, -5, 1. / 2, 1, 0},
+                                        {0, -2, 4, 5. / 2, -5, -1. / 2, 1, 0},
+                                        {0, -1, 0, 21. / 4, 0, -21. / 4, 0, 1}};
+
+    static constexpr double G[8][3] = {{1, 0, 0},
+                                       {-2. / 9, -2. / 9, -2. / 9},
+                                       {-2. / 9, 2. / 9, -2. / 9},
+                                       {1. / 90, 1. / 45, 2. / 45},
+                                       {1. / 90, -1. / 45, 2. / 45},
+                                       {32. / 45, 16. / 45, 8. / 45},
+                                       {32. / 45, -16. / 45, 8. / 45},
+                                       {0, 0, 1}};
+
+    static constexpr double AT[6][8] = {{1, 1, 1, 1, 1, 1, 1, 0},
+                                        {0, 1, -1, 2, -2, 1. / 2, -1. / 2, 0},
+                                        {0, 1, 1, 4, 4, 1. / 4, 1. / 4, 0},
+                                        {0, 1, -1, 8, -8, 1. / 8, -1. / 8, 0},
+                                        {0, 1, 1, 16, 16, 1. / 16, 1. / 16, 0},
+                                        {0, 1, -1, 32, -32, 1. / 32, -1. / 32, 1}};
+};
+
+namespace host_winograd_detail {
+
+// dst[i][j][v] = sum_{p, q} L[i][p] * src[p][q][v] * L[j][q] for an R x P matrix L and
+// P x P tiles of VecSize lanes (independent channels, the vectorized dimension)
+template <std::size_t R, std::size_t P, std::size_t VecSize, typename T>
+void transform_tile(const double (&l)[R][P], const T* p_src, T* p_dst)
+{
+    T tmp[R][P][VecSize];
+
+    for(std::size_t i = 0; i < R; ++i)
+    {
+        for(std::size_t q = 0; q < P; ++q)
+        {
+            for(std::size_t v = 0; v < VecSize; ++v)
+                tmp[i][q][v] = 0;
+
+            for(std::size_t p = 0; p < P; ++p)
+            {
+                if(l[i][p] == 0)
+                    continue;
+
+                const T lip = static_cast<T>(l[i][p]);
+
+                for(std::size_t v = 0; v < VecSize; ++v)
+                    tmp[i][q][v] += lip * p_src[(p * P + q) * VecSize + v];
+            }
+        }
+    }
+
+    for(std::size_t i = 0; i < R; ++i)
+    {
+        for(std::size_t j = 0; j < R; ++j)
+        {
+            T* p = p_dst + (i * R + j) * VecSize;
+
+            for(std::size_t v = 0; v < VecSize; ++v)
+                p[v] = 0;
+
+            for(std::size_t q = 0; q < P; ++q)
+            {
+                if(l[j][q] == 0)
+                    continue;
+
+                const T ljq = static_cast<T>(l[j][q]);
+
+                for(std::size_t v = 0; v < VecSize; ++v)
+                    p[v] += ljq * tmp[i][q][v];
+            }
+        }
+    }
+}
+
+} // namespace host_winograd_detail
+
+// Winograd F(m x m, 3 x 3) forward convolution on the CPU for stride-1, dilation-1 3x3 filters,
+// m = OutTileSize = 2, 4 or 6. The input is streamed in blocks of tiles: a block is transformed
+// into Alpha * Alpha matrices of TileBlock x C (fused with the gather of the tiles and their
+// padding), multiplied with the transformed filter by Alpha * Alpha packed GEMMs, and transformed
+// back into the output, so no full-size intermediate tensor is allocated. Arithmetic is in the
+// accumulation type of the packed GEMM (fp32 for fp32/fp16/bf16, fp64 for fp64). Larger tiles
+// do less work but lose more precision: F(6, 3) in fp32 is only good to about 1e-4 relative.
+// in, wei and out can be Tensor or TensorView
+template <std::size_t OutTileSize = 4,
+          typename InTensor,
+          typename WeiTensor,
+          typename OutTensor,
+          typename ConvStrides,
+          typename ConvDilations,
+          typename InLeftPads,
+          typename InRightPads>
+void host_conv_fwd_winograd(const InTensor& in_tensor,
+                            const WeiTensor& wei_tensor,
+                            OutTensor&& out_tensor,
+                            const ConvStrides& conv_strides,
+                            const ConvDilations& conv_dilations,
+                            const InLeftPads& in_left_pads,
+                            const InRightPads&,
+                            const ConvTensorLayout layout = ConvTensorLayout::NCHW,
+                            std::size_t num_thread = std::thread::hardware_concurrency())
+{
+    using namespace ck;
+    using Transform = HostWinogradTransform3x3<OutTileSize>;
+
+    constexpr auto I0 = Number<0>{};
+    constexpr auto I1 = Number<1>{};
+
+    constexpr std::size_t M     = OutTileSize;
+    constexpr std::size_t Alpha = Transform::Alpha;
+
+    // channels transformed together, and the size of the per-block workspace
+    constexpr std::size_t VecSize       = 16;
+    constexpr std::size_t WorkspaceSize = std::size_t(1) << 22;
+
+    using InT  = std::remove_const_t<typename decltype(make_tensor_view(in_tensor))::value_type>;
+    using WeiT = std::remove_const_t<typename decltype(make_tensor_view(wei_tensor))::value_type>;
+    using OutT = typename decltype(make_tensor_view(out_tensor))::value_type;
+    using AccT = typename HostGemmDataType<InT>::AccType;
+
+    static_assert(std::is_floating_point<AccT>::value,
+                  "wrong! Winograd needs a floating point accumulation type");
+
+    const TensorView<const InT> in   = make_tensor_view(in_tensor);
+    const TensorView<const WeiT> wei = make_tensor_view(wei_tensor);
+    const auto out                   = make_tensor_view(out_tensor);
+
+    if(layout != ConvTensorLayout::NCHW && layout != ConvTensorLayout::NHWC)
+        throw std::runtime_error("wrong! not supported layout");
+
+    const bool is_nchw = layout == ConvTensorLayout::NCHW;
+
+    // dimensions of C (K for wei and out), H and W
+    const std::size_t c_dim = is_nchw ? 1 : 3;
+    const std::size_t h_dim = is_nchw ? 2 : 1;
+    const std::size_t w_dim = h_dim + 1;
+
+    const std::size_t N  = in.mDesc.GetLengths()[0];
+    const std::size_t C  = in.mDesc.GetLengths()[c_dim];
+    const index_t Hi     = in.mDesc.GetLengths()[h_dim];
+    const index_t Wi     = in.mDesc.GetLengths()[w_dim];
+    const std::size_t K  = wei.mDesc.GetLengths()[0];
+    const std::size_t Ho = out.mDesc.GetLengths()[h_dim];
+    const std::size_t Wo = out.mDesc.GetLengths()[w_dim];
+
+    if(wei.mDesc.GetLengths()[h_dim] != 3 || wei.mDesc.GetLengths()[w_dim] != 3 ||
+       conv_strides[I0] != 1 || conv_strides[I1] != 1 || conv_dilations[I0] != 1 ||
+       conv_dilations[I1] != 1)
+        throw std::runtime_error("wrong! Winograd only supports 3x3 filters with stride 1 "
+                                 "and dilation 1");
+
+    const index_t InLeftPadH = in_left_pads[I0];
+    const index_t InLeftPadW = in_left_pads[I1];
+
+    const std::size_t HTile = (Ho + M - 1) / M;
+    const std::size_t WTile = (Wo + M - 1) / M;
+    const std::size_t NTile = N * HTile * WTile;
+
+    const std::size_t CPad = (C + VecSize - 1) / VecSize * VecSize;
+    const std::size_t KPad = (K + VecSize - 1) / VecSize * VecSize;
+
+    const std::size_t TileBlock = std::max<std::size_t>(
+        1, std::min(NTile, WorkspaceSize / (Alpha * Alpha * (CPad + KPad))));
+
+    const auto& in_strides  = in.mDesc.GetStrides();
+    const auto& wei_strides = wei.mDesc.GetStrides();
+    const auto& out_strides = out.mDesc.GetStrides();
+
+    auto& pool = HostThreadPool::GetInstance();
+
+    const std::size_t num_chunk =
+        std::max<std::size_t>(num_thread, 1) * HostThreadPool::ChunkPerThread;
+
+    const HostTensorAllocator<AccT> allocator(HostTensorMemoryPolicy::Uninitialized());
+
+    // transformed filter, Alpha * Alpha matrices of K x CPad
+    std::vector<AccT, HostTensorAllocator<AccT>> wei_transform(Alpha * Alpha * K * CPad,
+                                                               allocator);
+
+    pool.ParallelFor(0, K, num_chunk, [&](std::size_t kb, std::size_t ke) {
+        AccT g[3][3][VecSize];
+        AccT u[Alpha][Alpha][VecSize];
+
+        for(std::size_t k = kb; k < ke; ++k)
+        {
+            for(std::size_t c0 = 0; c0 < CPad; c0 += VecSize)
+            {
+                for(std::size_t y = 0; y < 3; ++y)
+                    for(std::size_t x = 0; x < 3; ++x)
+                        for(std::size_t v = 0; v < VecSize; ++v)
+                            g[y][x][v] = c0 + v < C
+                                             ? HostGemmDataType<WeiT>::ToAcc(
+                                                   wei.mpData[k * wei_strides[0] +
+                                                              (c0 + v) * wei_strides[c_dim] +
+                                                              y * wei_strides[h_dim] +
+                                                              x * wei_strides[w_dim]])
+                                             : AccT{0};
+
+                host_winograd_detail::transform_tile<Alpha, 3, VecSize>(
+                    Transform::G, &g[0][0][0], &u[0][0][0]);
+
+                for(std::size_t e = 0; e < Alpha * Alpha; ++e)
+                    for(std::size_t v = 0; v < VecSize; ++v)
+                        wei_transform[(e * K + k) * CPad + c0 + v] = u[e / Alpha][e % Alpha][v];
+            }
+        }
+    });
+
+    // per tile block: transformed input, Alpha * Alpha matrices of TileBlock x CPad, and the
+    // GEMM results, Alpha * Alpha matrices of TileBlock x KPad
+    std::vector<AccT, HostTensorAllocator<AccT>> in_transform(Alpha * Alpha * TileBlock * CPad,
+                                                              allocator);
+    std::vector<AccT, HostTensorAllocator<AccT>> out_transform(Alpha * Alpha * TileBlock * KPad,
+                                                               allocator);
+
+    // rows of K past K are never written by the GEMMs but go through the output transform
+    std::fill(out_transform.begin(), out_transform.end(), AccT{0});
+
+    auto f_tile_origin = [&](std::size_t itile, std::size_t& n, index_t& h, index_t& w) {
+        n = itile / (HTile * WTile);
+        h = itile / WTile % HTile * M;
+        w = itile % WTile * M;
+    };
+
+    for(std::size_t tile_begin = 0; tile_begin < NTile; tile_begin += TileBlock)
+    {
+        const std::size_t num_tile = std::min(TileBlock, NTile - tile_begin);
+
+        // gather the Alpha x Alpha input tiles, zero outside the input, and transform them
+        pool.ParallelFor(0, num_tile, num_chunk, [&](std::size_t tb, std::size_t te) {
+            AccT d[Alpha][Alpha][VecSize];
+            AccT v_tile[Alpha][Alpha][VecSize];
+
+            for(std::size_t t = tb; t < te; ++t)
+            {
+                std::size_t n;
+                index_t ho, wo;
+                f_tile_origin(tile_begin + t, n, ho, wo);
+
+                for(std::size_t c0 = 0; c0 < CPad; c0 += VecSize)
+                {
+                    for(std::size_t i = 0; i < Alpha; ++i)
+                    {
+                        const index_t hi = ho + index_t(i) - InLeftPadH;
+
+                        for(std::size_t j = 0; j < Alpha; ++j)
+                        {
+                            const index_t wi = wo + index_t(j) - InLeftPadW;
+
+                            const bool in_bound = hi >= 0 && hi < Hi && wi >= 0 && wi < Wi;
+
+                            const InT* p = in.mpData + n * in_strides[0] +
+                                           (in_bound ? hi * in_strides[h_dim] : 0) +
+                                           (in_bound ? wi * in_strides[w_dim] : 0);
+
+                            for(std::size_t v = 0; v < VecSize; ++v)
+                                d[i][j][v] = in_bound && c0 + v < C
+                                                 ? HostGemmDataType<InT>::ToAcc(
+                                                       p[(c0 + v) * in_strides[c_dim]])
+                                                 : AccT{0};
+                        }
+                    }
+
+                    host_winograd_detail::transform_tile<Alpha, Alpha, VecSize>(
+                        Transform::BT, &d[0][0][0], &v_tile[0][0][0]);
+
+                    for(std::size_t e = 0; e < Alpha * Alpha; ++e)
+                        for(std::size_t v = 0; v < VecSize; ++v)
+                            in_transform[(e * TileBlock + t) * CPad + c0 + v] =
+                                v_tile[e / Alpha][e % Alpha][v];
+                }
+            }
+        });
+
+        // Alpha * Alpha independent GEMMs: (K x CPad) * (CPad x num_tile)
+        pool.ParallelFor(0, Alpha * Alpha, Alpha * Alpha, [&](std::size_t eb, std::size_t ee) {
+            for(std::size_t e = eb; e < ee; ++e)
+            {
+                host_gemm_detail::gemm_packed_dispatch(
+                    host_gemm_detail::GemmOperandStrided<AccT>{
+                        wei_transform.data() + e * K * CPad, CPad, 1},
+                    host_gemm_detail::GemmOperandStrided<AccT>{
+                        in_transform.data() + e * TileBlock * CPad, CPad, 1},
+                    host_gemm_detail::GemmOutputStrided<AccT>{
+                        out_transform.data() + e * TileBlock * KPad, 1, KPad},
+                    K,
+                    num_tile,
+                    CPad,
+                    num_thread);
+            }
+        });
+
+        // transform back and scatter the M x M output tiles
+        pool.ParallelFor(0, num_tile, num_chunk, [&](std::size_t tb, std::size_t te) {
+            AccT m_tile[Alpha][Alpha][VecSize];
+            AccT y_tile[M][M][VecSize];
+
+            for(std::size_t t = tb; t < te; ++t)
+            {
+                std::size_t n;
+                index_t ho0, wo0;
+                f_tile_origin(tile_begin + t, n, ho0, wo0);
+
+                for(std::size_t k0 = 0; k0 < K; k0 += VecSize)
+                {
+                    for(std::size_t e = 0; e < Alpha * Alpha; ++e)
+                        for(std::size_t v = 0; v < VecSize; ++v)
+                            m_tile[e / Alpha][e % Alpha][v] =
+                                out_transform[(e * TileBlock + t) * KPad + k0 + v];
+
+                    host_winograd_detail::transform_tile<M, Alpha, VecSize>(
+                        Transform::AT, &m_tile[0][0][0], &y_tile[0][0][0]);
+
+                    for(std::size_t i = 0; i < M && ho0 + i < Ho; ++i)
+                    {
+                        for(std::size_t j = 0; j < M && wo0 + j < Wo; ++j)
+                        {
+                            OutT* p = out.mpData + n * out_strides[0] +
+                                      (ho0 + i) * out_strides[h_dim] +
+                                      (wo0 + j) * out_strides[w_dim];
+
+                            for(std::size_t v = 0; v < VecSize && k0 + v < K; ++v)
+                                p[(k0 + v) * out_strides[c_dim]] =
+                                    HostGemmDataType<OutT>::FromAcc(y_tile[i][j][v]);
+                        }
+                    }
+                }
+            }
+        });
+    }
+}
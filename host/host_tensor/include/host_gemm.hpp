@@ -2,10 +2,11 @@
 #include "host_tensor.hpp"
 #include "gemm_common.hpp"
 
-template <typename AType, typename BType, typename CType>
-void host_gemm(const Tensor<AType>& a,
-               const Tensor<BType>& b,
-               Tensor<CType>& c,
+// a, b and c can be Tensor or TensorView
+template <typename ATensor, typename BTensor, typename CTensor>
+void host_gemm(const ATensor& a,
+               const BTensor& b,
+               CTensor&& c,
                const GemmMatrixLayout layout)
 {
     if(layout == GemmMatrixLayout::MK_KN_MN)
@@ -0,0 +1,999 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HOST_GEMM_X86_DISPATCH 1
+#else
+#define HOST_GEMM_X86_DISPATCH 0
+#endif
+
+#include "host_tensor.hpp"
+#include "gemm_common.hpp"
+
+// Element type of A, B and C as seen by the packed GEMM: the accumulation type, and conversions
+// to and from it. fp16/bf16 accumulate in fp32, int8 in int32.
+template <typename T, typename Enable = void>
+struct HostGemmDataType;
+
+template <typename T>
+struct HostGemmDataType<T,
+                        std::enable_if_t<std::is_same<T, float>::value ||
+                                         std::is_same<T, double>::value ||
+                                         std::is_same<T, std::int32_t>::value>>
+{
+    using AccType = T;
+
+    static AccType ToAcc(T x) { return x; }
+
+    template <typename AccT>
+    static T FromAcc(AccT x)
+    {
+        return static_cast<T>(x);
+    }
+};
+
+template <>
+struct HostGemmDataType<std::int8_t>
+{
+    using AccType = std::int32_t;
+
+    static AccType ToAcc(std::int8_t x) { return x; }
+
+    template <typename AccT>
+    static std::int8_t FromAcc(AccT x)
+    {
+        return static_cast<std::int8_t>(x);
+    }
+};
+
+#if defined(__FLT16_MAX__)
+template <>
+struct HostGemmDataType<_Float16>
+{
+    using AccType = float;
+
+    static AccType ToAcc(_Float16 x) { return x; }
+
+    template <typename AccT>
+    static _Float16 FromAcc(AccT x)
+    {
+        return static_cast<_Float16>(x);
+    }
+};
+#endif
+
+// bfloat16 is stored as ushort on the host
+template <>
+struct HostGemmDataType<unsigned short>
+{
+    using AccType = float;
+
+    static AccType ToAcc(unsigned short x)
+    {
+        const std::uint32_t bits = static_cast<std::uint32_t>(x) << 16;
+
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    // round to nearest even, NaN stays NaN
+    template <typename AccT>
+    static unsigned short FromAcc(AccT x)
+    {
+        const float f = static_cast<float>(x);
+
+        std::uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+
+        if((bits & 0x7fffffff) > 0x7f800000)
+            return static_cast<unsigned short>((bits >> 16) | 0x40);
+
+        bits += 0x7fff + ((bits >> 16) & 1);
+
+        return static_cast<unsigned short>(bits >> 16);
+    }
+};
+
+namespace host_convert_detail {
+
+#if HOST_GEMM_X86_DISPATCH
+#if defined(__FLT16_MAX__)
+__attribute__((target("f16c"))) inline void
+convert_f16c(const _Float16* p_src, float* p_dst, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for(; i + 8 <= n; i += 8)
+    {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_src + i));
+
+        _mm256_storeu_ps(p_dst + i, _mm256_cvtph_ps(h));
+    }
+
+    for(; i < n; ++i)
+        p_dst[i] = p_src[i];
+}
+
+__attribute__((target("f16c"))) inline void
+convert_f16c(const float* p_src, _Float16* p_dst, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for(; i + 8 <= n; i += 8)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p_dst + i),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(p_src + i), _MM_FROUND_TO_NEAREST_INT));
+
+    for(; i < n; ++i)
+        p_dst[i] = static_cast<_Float16>(p_src[i]);
+}
+#endif
+
+__attribute__((target("avx2"))) inline void
+convert_bf16_avx2(const unsigned short* p_src, float* p_dst, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for(; i + 8 <= n; i += 8)
+    {
+        const __m256i bits = _mm256_slli_epi32(
+            _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p_src + i))),
+            16);
+
+        _mm256_storeu_ps(p_dst + i, _mm256_castsi256_ps(bits));
+    }
+
+    for(; i < n; ++i)
+        p_dst[i] = HostGemmDataType<unsigned short>::ToAcc(p_src[i]);
+}
+
+// vcvtneps2bf16 rounds to nearest even and quiets NaN like FromAcc, but reads denormals as zero,
+// so vectors holding any are converted one element at a time
+__attribute__((target("avx512f,avx512bf16"))) inline void
+convert_bf16_avx512(const float* p_src, unsigned short* p_dst, std::size_t n)
+{
+    const __m512 min_normal = _mm512_set1_ps(std::numeric_limits<float>::min());
+
+    std::size_t i = 0;
+
+    for(; i + 16 <= n; i += 16)
+    {
+        const __m512 x = _mm512_loadu_ps(p_src + i);
+
+        const __mmask16 is_denorm =
+            _mm512_cmp_ps_mask(_mm512_abs_ps(x), min_normal, _CMP_LT_OQ) &
+            _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_NEQ_UQ);
+
+        if(is_denorm == 0)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p_dst + i),
+                                reinterpret_cast<__m256i>(_mm512_cvtneps_pbh(x)));
+        }
+        else
+        {
+            for(std::size_t j = i; j < i + 16; ++j)
+                p_dst[j] = HostGemmDataType<unsigned short>::FromAcc(p_src[j]);
+        }
+    }
+
+    for(; i < n; ++i)
+        p_dst[i] = HostGemmDataType<unsigned short>::FromAcc(p_src[i]);
+}
+#endif
+
+} // namespace host_convert_detail
+
+// Bulk conversions of n elements between T and the accumulation type (or any type it converts
+// into, like the packed types of the GEMM micro-kernels), with the same results as ToAcc and
+// FromAcc. fp16 goes through F16C and bf16 through AVX2 / AVX-512 BF16 when the host has them.
+template <typename T, typename AccT>
+void host_convert_to_acc(const T* p_src, AccT* p_dst, std::size_t n)
+{
+#if HOST_GEMM_X86_DISPATCH
+#if defined(__FLT16_MAX__)
+    if constexpr(std::is_same<T, _Float16>::value && std::is_same<AccT, float>::value)
+    {
+        if(__builtin_cpu_supports("f16c"))
+            return host_convert_detail::convert_f16c(p_src, p_dst, n);
+    }
+#endif
+    if constexpr(std::is_same<T, unsigned short>::value && std::is_same<AccT, float>::value)
+    {
+        if(__builtin_cpu_supports("avx2"))
+            return host_convert_detail::convert_bf16_avx2(p_src, p_dst, n);
+    }
+#endif
+    for(std::size_t i = 0; i < n; ++i)
+        p_dst[i] = static_cast<AccT>(HostGemmDataType<T>::ToAcc(p_src[i]));
+}
+
+template <typename AccT, typename T>
+void host_convert_from_acc(const AccT* p_src, T* p_dst, std::size_t n)
+{
+#if HOST_GEMM_X86_DISPATCH
+#if defined(__FLT16_MAX__)
+    if constexpr(std::is_same<T, _Float16>::value && std::is_same<AccT, float>::value)
+    {
+        if(__builtin_cpu_supports("f16c"))
+            return host_convert_detail::convert_f16c(p_src, p_dst, n);
+    }
+#endif
+    if constexpr(std::is_same<T, unsigned short>::value && std::is_same<AccT, float>::value)
+    {
+        if(__builtin_cpu_supports("avx512bf16"))
+            return host_convert_detail::convert_bf16_avx512(p_src, p_dst, n);
+    }
+#endif
+    for(std::size_t i = 0; i < n; ++i)
+        p_dst[i] = HostGemmDataType<T>::FromAcc(p_src[i]);
+}
+
+namespace host_gemm_detail {
+
+// Register-blocked micro-kernels. A kernel computes an MR x NR tile of C from a packed A
+// micro-panel (kc x MR, MR contiguous) and a packed B micro-panel (kc x NR, NR contiguous), and
+// stores it row-major to tile. Blocking sizes: KC rows of a B micro-panel stay in L1, an MC x KC
+// block of A in L2, and a KC x NC panel of B in L3.
+// Panels hold PackType, with KPack consecutive k of a row next to each other (kc / KPack x MR x
+// KPack); kc is then a multiple of KPack, zero-padded.
+template <typename AccT, std::size_t MR_, std::size_t NR_>
+struct MicroKernelGeneric
+{
+    using AccType  = AccT;
+    using PackType = AccT;
+
+    static constexpr std::size_t KPack = 1;
+
+    static constexpr std::size_t MR = MR_;
+    static constexpr std::size_t NR = NR_;
+    static constexpr std::size_t MC = MR * 16;
+    static constexpr std::size_t KC = 256;
+    static constexpr std::size_t NC = NR * 256;
+
+    static void Run(std::size_t kc, const AccT* p_a, const AccT* p_b, AccT* p_tile)
+    {
+        AccT acc[MR][NR] = {};
+
+        for(std::size_t k = 0; k < kc; ++k)
+        {
+            for(std::size_t i = 0; i < MR; ++i)
+            {
+                for(std::size_t j = 0; j < NR; ++j)
+                {
+                    acc[i][j] += p_a[i] * p_b[j];
+                }
+            }
+
+            p_a += MR;
+            p_b += NR;
+        }
+
+        for(std::size_t i = 0; i < MR; ++i)
+        {
+            for(std::size_t j = 0; j < NR; ++j)
+            {
+                p_tile[i * NR + j] = acc[i][j];
+            }
+        }
+    }
+};
+
+#if HOST_GEMM_X86_DISPATCH
+struct MicroKernelAvx2Fp32
+{
+    using AccType  = float;
+    using PackType = float;
+
+    static constexpr std::size_t KPack = 1;
+
+    static constexpr std::size_t MR = 6;
+    static constexpr std::size_t NR = 16;
+    static constexpr std::size_t MC = 72;
+    static constexpr std::size_t KC = 256;
+    static constexpr std::size_t NC = 4080;
+
+    __attribute__((target("avx2,fma"))) static void
+    Run(std::size_t kc, const float* p_a, const float* p_b, float* p_tile)
+    {
+        __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+        __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+        __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+        __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+        __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+        __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+        for(std::size_t k = 0; k < kc; ++k)
+        {
+            const __m256 b0 = _mm256_loadu_ps(p_b);
+            const __m256 b1 = _mm256_loadu_ps(p_b + 8);
+
+            __m256 a = _mm256_broadcast_ss(p_a);
+            c00      = _mm256_fmadd_ps(a, b0, c00);
+            c01      = _mm256_fmadd_ps(a, b1, c01);
+            a        = _mm256_broadcast_ss(p_a + 1);
+            c10      = _mm256_fmadd_ps(a, b0, c10);
+            c11      = _mm256_fmadd_ps(a, b1, c11);
+            a        = _mm256_broadcast_ss(p_a + 2);
+            c20      = _mm256_fmadd_ps(a, b0, c20);
+            c21      = _mm256_fmadd_ps(a, b1, c21);
+            a        = _mm256_broadcast_ss(p_a + 3);
+            c30      = _mm256_fmadd_ps(a, b0, c30);
+            c31      = _mm256_fmadd_ps(a, b1, c31);
+            a        = _mm256_broadcast_ss(p_a + 4);
+            c40      = _mm256_fmadd_ps(a, b0, c40);
+            c41      = _mm256_fmadd_ps(a, b1, c41);
+            a        = _mm256_broadcast_ss(p_a + 5);
+            c50      = _mm256_fmadd_ps(a, b0, c50);
+            c51      = _mm256_fmadd_ps(a, b1, c51);
+
+            p_a += MR;
+            p_b += NR;
+        }
+
+        _mm256_storeu_ps(p_tile + 0 * NR, c00);
+        _mm256_storeu_ps(p_tile + 0 * NR + 8, c01);
+        _mm256_storeu_ps(p_tile + 1 * NR, c10);
+        _mm256_storeu_ps(p_tile + 1 * NR + 8, c11);
+        _mm256_storeu_ps(p_tile + 2 * NR, c20);
+        _mm256_storeu_ps(p_tile + 2 * NR + 8, c21);
+        _mm256_storeu_ps(p_tile + 3 * NR, c30);
+        _mm256_storeu_ps(p_tile + 3 * NR + 8, c31);
+        _mm256_storeu_ps(p_tile + 4 * NR, c40);
+        _mm256_storeu_ps(p_tile + 4 * NR + 8, c41);
+        _mm256_storeu_ps(p_tile + 5 * NR, c50);
+        _mm256_storeu_ps(p_tile + 5 * NR + 8, c51);
+    }
+};
+
+struct MicroKernelAvx512Fp32
+{
+    using AccType  = float;
+    using PackType = float;
+
+    static constexpr std::size_t KPack = 1;
+
+    static constexpr std::size_t MR = 8;
+    static constexpr std::size_t NR = 32;
+    static constexpr std::size_t MC = 96;
+    static constexpr std::size_t KC = 256;
+    static constexpr std::size_t NC = 4096;
+
+    __attribute__((target("avx512f"))) static void
+    Run(std::size_t kc, const float* p_a, const float* p_b, float* p_tile)
+    {
+        __m512 c0[MR];
+        __m512 c1[MR];
+
+        for(std::size_t i = 0; i < MR; ++i)
+        {
+            c0[i] = _mm512_setzero_ps();
+            c1[i] = _mm512_setzero_ps();
+        }
+
+        for(std::size_t k = 0; k < kc; ++k)
+        {
+            const __m512 b0 = _mm512_loadu_ps(p_b);
+            const __m512 b1 = _mm512_loadu_ps(p_b + 16);
+
+            for(std::size_t i = 0; i < MR; ++i)
+            {
+                const __m512 a = _mm512_set1_ps(p_a[i]);
+
+                c0[i] = _mm512_fmadd_ps(a, b0, c0[i]);
+                c1[i] = _mm512_fmadd_ps(a, b1, c1[i]);
+            }
+
+            p_a += MR;
+            p_b += NR;
+        }
+
+        for(std::size_t i = 0; i < MR; ++i)
+        {
+            _mm512_storeu_ps(p_tile + i * NR, c0[i]);
+            _mm512_storeu_ps(p_tile + i * NR + 16, c1[i]);
+        }
+    }
+};
+
+// int8 x int8 with exact int32 accumulation, on the Int8x4 grouping of the device kernels: a
+// panel is kc / 4 x MR x 4 int8. vpdpbusd multiplies unsigned by signed bytes, so A is made
+// unsigned by flipping its sign bits (a + 128) and 128 * sum_k B(n, k), accumulated alongside,
+// is subtracted at the end.
+struct MicroKernelAvx512VnniInt8
+{
+    using AccType  = std::int32_t;
+    using PackType = std::int8_t;
+
+    static constexpr std::size_t KPack = 4;
+
+    static constexpr std::size_t MR = 8;
+    static constexpr std::size_t NR = 32;
+    static constexpr std::size_t MC = 96;
+    static constexpr std::size_t KC = 512;
+    static constexpr std::size_t NC = 4096;
+
+    __attribute__((target("avx512f,avx512vnni"))) static void
+    Run(std::size_t kc, const std::int8_t* p_a, const std::int8_t* p_b, std::int32_t* p_tile)
+    {
+        const __m512i sign = _mm512_set1_epi32(static_cast<int>(0x80808080));
+
+        __m512i c0[MR];
+        __m512i c1[MR];
+
+        for(std::size_t i = 0; i < MR; ++i)
+        {
+            c0[i] = _mm512_setzero_si512();
+            c1[i] = _mm512_setzero_si512();
+        }
+
+        __m512i bias0 = _mm512_setzero_si512();
+        __m512i bias1 = _mm512_setzero_si512();
+
+        for(std::size_t k = 0; k < kc; k += KPack)
+        {
+            const __m512i b0 = _mm512_loadu_si512(p_b);
+            const __m512i b1 = _mm512_loadu_si512(p_b + 64);
+
+            bias0 = _mm512_dpbusd_epi32(bias0, sign, b0);
+            bias1 = _mm512_dpbusd_epi32(bias1, sign, b1);
+
+            for(std::size_t i = 0; i < MR; ++i)
+            {
+                std::int32_t a4;
+                std::memcpy(&a4, p_a + i * KPack, sizeof(a4));
+
+                const __m512i a = _mm512_xor_si512(_mm512_set1_epi32(a4), sign);
+
+                c0[i] = _mm512_dpbusd_epi32(c0[i], a, b0);
+                c1[i] = _mm512_dpbusd_epi32(c1[i], a, b1);
+            }
+
+            p_a += MR * KPack;
+            p_b += NR * KPack;
+        }
+
+        for(std::size_t i = 0; i < MR; ++i)
+        {
+            _mm512_storeu_si512(p_tile + i * NR, _mm512_sub_epi32(c0[i], bias0));
+            _mm512_storeu_si512(p_tile + i * NR + 16, _mm512_sub_epi32(c1[i], bias1));
+        }
+    }
+};
+
+// int8 x int8 with exact int32 accumulation on AVX2. pmaddubsw would saturate its int16 pair
+// sums, so the int8 values are packed as int16 pairs (kc / 2 x MR x 2) for pmaddwd instead.
+struct MicroKernelAvx2Int8
+{
+    using AccType  = std::int32_t;
+    using PackType = std::int16_t;
+
+    static constexpr std::size_t KPack = 2;
+
+    static constexpr std::size_t MR = 6;
+    static constexpr std::size_t NR = 16;
+    static constexpr std::size_t MC = 72;
+    static constexpr std::size_t KC = 256;
+    static constexpr std::size_t NC = 4080;
+
+    __attribute__((target("avx2"))) static void
+    Run(std::size_t kc, const std::int16_t* p_a, const std::int16_t* p_b, std::int32_t* p_tile)
+    {
+        __m256i c0[MR];
+        __m256i c1[MR];
+
+        for(std::size_t i = 0; i < MR; ++i)
+        {
+            c0[i] = _mm256_setzero_si256();
+            c1[i] = _mm256_setzero_si256();
+        }
+
+        for(std::size_t k = 0; k < kc; k += KPack)
+        {
+            const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_b));
+            const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_b + 16));
+
+            for(std::size_t i = 0; i < MR; ++i)
+            {
+                std::int32_t a2;
+                std::memcpy(&a2, p_a + i * KPack, sizeof(a2));
+
+                const __m256i a = _mm256_set1_epi32(a2);
+
+                c0[i] = _mm256_add_epi32(c0[i], _mm256_madd_epi16(a, b0));
+                c1[i] = _mm256_add_epi32(c1[i], _mm256_madd_epi16(a, b1));
+            }
+
+            p_a += MR * KPack;
+            p_b += NR * KPack;
+        }
+
+        for(std::size_t i = 0; i < MR; ++i)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p_tile + i * NR), c0[i]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p_tile + i * NR + 8), c1[i]);
+        }
+    }
+};
+#endif
+
+// dst[ip][k][i] = src(i0 + ip * MR + i, k0 + k) for the MR-wide micro-panels of an m x kc block,
+// rows past m are zero. Elements are gathered as T and converted to AccT in bulk.
+template <std::size_t MR, typename AccT, typename T>
+void pack_panel(AccT* p_dst,
+                const T* p_src,
+                std::size_t stride_i,
+                std::size_t stride_k,
+                std::size_t m,
+                std::size_t kc)
+{
+    if constexpr(!std::is_same<AccT, T>::value)
+    {
+        std::vector<T> raw((m + MR - 1) / MR * MR * kc);
+
+        pack_panel<MR>(raw.data(), p_src, stride_i, stride_k, m, kc);
+        host_convert_to_acc(raw.data(), p_dst, raw.size());
+    }
+    else
+    {
+        for(std::size_t ip = 0; ip < m; ip += MR)
+        {
+            const std::size_t mr = std::min(MR, m - ip);
+
+            const T* p = p_src + ip * stride_i;
+
+            // read along the contiguous dimension of the source
+            if(stride_k == 1)
+            {
+                for(std::size_t i = 0; i < mr; ++i)
+                {
+                    for(std::size_t k = 0; k < kc; ++k)
+                    {
+                        p_dst[k * MR + i] = p[i * stride_i + k];
+                    }
+                }
+            }
+            else
+            {
+                for(std::size_t k = 0; k < kc; ++k)
+                {
+                    for(std::size_t i = 0; i < mr; ++i)
+                    {
+                        p_dst[k * MR + i] = p[i * stride_i + k * stride_k];
+                    }
+                }
+            }
+
+            for(std::size_t k = 0; k < kc; ++k)
+            {
+                for(std::size_t i = mr; i < MR; ++i)
+                {
+                    p_dst[k * MR + i] = AccT{0};
+                }
+            }
+
+            p_dst += kc * MR;
+        }
+    }
+}
+
+// Operands of gemm_packed. A is read as an M x K matrix and B as an N x K matrix (B transposed),
+// so both are packed by the same Pack(p_dst, i0, k0, m, kc), which packs rows [i0, i0 + m) and
+// columns [k0, k0 + kc) into MR-wide micro-panels.
+
+// element (i, k) at mpData[i * mStrideI + k * mStrideK]
+template <typename T>
+struct GemmOperandStrided
+{
+    using DataType = T;
+
+    const T* mpData;
+    std::size_t mStrideI;
+    std::size_t mStrideK;
+
+    template <std::size_t MR, typename AccT>
+    void Pack(AccT* p_dst, std::size_t i0, std::size_t k0, std::size_t m, std::size_t kc) const
+    {
+        pack_panel<MR>(p_dst, mpData + i0 * mStrideI + k0 * mStrideK, mStrideI, mStrideK, m, kc);
+    }
+};
+
+// element (i, k) at mpData[mpOffsetI[i] + mpOffsetK[k]], for matrices that are not strided views
+// of memory but whose offset still splits into a row and a column term, like the implicit im2col
+// matrix of a convolution
+template <typename T>
+struct GemmOperandSeparable
+{
+    using DataType = T;
+
+    const T* mpData;
+    const std::size_t* mpOffsetI;
+    const std::size_t* mpOffsetK;
+
+    template <std::size_t MR, typename AccT>
+    void Pack(AccT* p_dst, std::size_t i0, std::size_t k0, std::size_t m, std::size_t kc) const
+    {
+        // gathered as T and converted to AccT in bulk
+        if constexpr(!std::is_same<AccT, T>::value)
+        {
+            std::vector<T> raw((m + MR - 1) / MR * MR * kc);
+
+            Pack<MR>(raw.data(), i0, k0, m, kc);
+            host_convert_to_acc(raw.data(), p_dst, raw.size());
+        }
+        else
+        {
+            for(std::size_t ip = 0; ip < m; ip += MR)
+            {
+                const std::size_t mr = std::min(MR, m - ip);
+
+                const std::size_t* p_offset_i = mpOffsetI + i0 + ip;
+
+                for(std::size_t k = 0; k < kc; ++k)
+                {
+                    const T* p = mpData + mpOffsetK[k0 + k];
+
+                    for(std::size_t i = 0; i < mr; ++i)
+                    {
+                        p_dst[k * MR + i] = p[p_offset_i[i]];
+                    }
+
+                    for(std::size_t i = mr; i < MR; ++i)
+                    {
+                        p_dst[k * MR + i] = AccT{0};
+                    }
+                }
+
+                p_dst += kc * MR;
+            }
+        }
+    }
+};
+
+// C of gemm_packed: element (m, n) at mpData[Offset(m, n)]
+template <typename T>
+struct GemmOutputStrided
+{
+    using DataType = T;
+
+    T* mpData;
+    std::size_t mStrideM;
+    std::size_t mStrideN;
+
+    std::size_t Offset(std::size_t m, std::size_t n) const { return m * mStrideM + n * mStrideN; }
+};
+
+template <typename T>
+struct GemmOutputSeparable
+{
+    using DataType = T;
+
+    T* mpData;
+    const std::size_t* mpOffsetM;
+    const std::size_t* mpOffsetN;
+
+    std::size_t Offset(std::size_t m, std::size_t n) const { return mpOffsetM[m] + mpOffsetN[n]; }
+};
+
+template <typename T>
+GemmOperandStrided<T> make_gemm_operand(const TensorView<const T>& view)
+{
+    return {view.mpData, view.mDesc.GetStrides()[0], view.mDesc.GetStrides()[1]};
+}
+
+template <typename T>
+GemmOutputStrided<T> make_gemm_output(const TensorView<T>& view)
+{
+    return {view.mpData, view.mDesc.GetStrides()[0], view.mDesc.GetStrides()[1]};
+}
+
+// packs rows [i0, i0 + m) and columns [k0, k0 + kc) of an operand into the R-wide micro-panels
+// of Kernel, grouping Kernel::KPack consecutive k, with kc rounded up to a multiple of KPack
+template <typename Kernel, std::size_t R, typename Operand>
+void pack_for_kernel(typename Kernel::PackType* p_dst,
+                     const Operand& op,
+                     std::size_t i0,
+                     std::size_t k0,
+                     std::size_t m,
+                     std::size_t kc)
+{
+    using PackT = typename Kernel::PackType;
+
+    constexpr std::size_t KPack = Kernel::KPack;
+
+    if constexpr(KPack == 1)
+    {
+        op.template Pack<R>(p_dst, i0, k0, m, kc);
+    }
+    else
+    {
+        const std::size_t kcp = (kc + KPack - 1) / KPack * KPack;
+
+        std::vector<PackT> panel(kc * R);
+
+        for(std::size_t ip = 0; ip < m; ip += R)
+        {
+            op.template Pack<R>(panel.data(), i0 + ip, k0, std::min(R, m - ip), kc);
+
+            for(std::size_t k = 0; k < kcp; ++k)
+            {
+                for(std::size_t i = 0; i < R; ++i)
+                {
+                    p_dst[(k / KPack * R + i) * KPack + k % KPack] =
+                        k < kc ? panel[k * R + i] : PackT{0};
+                }
+            }
+
+            p_dst += kcp * R;
+        }
+    }
+}
+
+// C(m, n) = sum_k A(m, k) * B(n, k)
+template <typename Kernel, typename AOperand, typename BOperand, typename COutput>
+void gemm_packed(const AOperand& a,
+                 const BOperand& b,
+                 const COutput& c,
+                 std::size_t M,
+                 std::size_t N,
+                 std::size_t K,
+                 std::size_t num_thread)
+{
+    using AccT  = typename Kernel::AccType;
+    using PackT = typename Kernel::PackType;
+    using CT    = typename COutput::DataType;
+
+    constexpr std::size_t MR    = Kernel::MR;
+    constexpr std::size_t NR    = Kernel::NR;
+    constexpr std::size_t MC    = Kernel::MC;
+    constexpr std::size_t KC    = Kernel::KC;
+    constexpr std::size_t NC    = Kernel::NC;
+    constexpr std::size_t KPack = Kernel::KPack;
+
+    // partial sums over K blocks are kept in AccT: in C itself if it has that type, otherwise in
+    // a row-major workspace converted into C at the end
+    constexpr bool use_workspace = !std::is_same<CT, AccT>::value;
+
+    const HostTensorAllocator<AccT> allocator(HostTensorMemoryPolicy::Uninitialized());
+
+    std::vector<AccT, HostTensorAllocator<AccT>> workspace(use_workspace ? M * N : 0, allocator);
+
+    AccT* p_acc = nullptr;
+
+    if constexpr(use_workspace)
+    {
+        p_acc = workspace.data();
+    }
+    else
+    {
+        p_acc = c.mpData;
+    }
+
+    auto acc_offset = [&](std::size_t m, std::size_t n) {
+        if constexpr(use_workspace)
+            return m * N + n;
+        else
+            return c.Offset(m, n);
+    };
+
+    auto& pool = HostThreadPool::GetInstance();
+
+    const std::size_t num_chunk =
+        std::max<std::size_t>(num_thread, 1) * HostThreadPool::ChunkPerThread;
+
+    std::vector<PackT, HostTensorAllocator<PackT>> b_packed(
+        KC * ((std::min(NC, N) + NR - 1) / NR * NR),
+        HostTensorAllocator<PackT>(HostTensorMemoryPolicy::Uninitialized()));
+
+    if(K == 0)
+    {
+        for(std::size_t m = 0; m < M; ++m)
+            for(std::size_t n = 0; n < N; ++n)
+                p_acc[acc_offset(m, n)] = 0;
+    }
+
+    for(std::size_t jc = 0; jc < N; jc += NC)
+    {
+        const std::size_t nc = std::min(NC, N - jc);
+
+        // a task is an MC x TaskN block of C, enough of them to keep every thread busy
+        const std::size_t num_block_m = (M + MC - 1) / MC;
+        const std::size_t num_panel_n = (nc + NR - 1) / NR;
+        const std::size_t panel_per_task =
+            std::max<std::size_t>(1, std::min(num_panel_n, num_block_m * num_panel_n / num_chunk));
+        const std::size_t num_task_n = (num_panel_n + panel_per_task - 1) / panel_per_task;
+
+        for(std::size_t pc = 0; pc < K; pc += KC)
+        {
+            const std::size_t kc  = std::min(KC, K - pc);
+            const std::size_t kcp = (kc + KPack - 1) / KPack * KPack;
+
+            const bool first = pc == 0;
+
+            // B panel, shared by all tasks
+            pool.ParallelFor(0, num_panel_n, num_chunk, [&](std::size_t ib, std::size_t ie) {
+                pack_for_kernel<Kernel, NR>(b_packed.data() + ib * kcp * NR,
+                                            b,
+                                            jc + ib * NR,
+                                            pc,
+                                            std::min(ie * NR, nc) - ib * NR,
+                                            kc);
+            });
+
+            auto f_tasks = [&](std::size_t itask_begin, std::size_t itask_end) {
+                std::vector<PackT> a_packed(MC * kcp);
+                alignas(64) AccT tile[MR * NR];
+
+                std::size_t packed_ic = M;
+
+                for(std::size_t itask = itask_begin; itask < itask_end; ++itask)
+                {
+                    const std::size_t ic = itask / num_task_n * MC;
+                    const std::size_t mc = std::min(MC, M - ic);
+
+                    // consecutive tasks of a chunk mostly share the A block
+                    if(ic != packed_ic)
+                    {
+                        pack_for_kernel<Kernel, MR>(a_packed.data(), a, ic, pc, mc, kc);
+                        packed_ic = ic;
+                    }
+
+                    const std::size_t jp_begin = itask % num_task_n * panel_per_task;
+                    const std::size_t jp_end   = std::min(jp_begin + panel_per_task, num_panel_n);
+
+                    for(std::size_t jp = jp_begin; jp < jp_end; ++jp)
+                    {
+                        const std::size_t jr = jp * NR;
+                        const std::size_t nr = std::min(NR, nc - jr);
+
+                        for(std::size_t ir = 0; ir < mc; ir += MR)
+                        {
+                            const std::size_t mr = std::min(MR, mc - ir);
+
+                            Kernel::Run(
+                                kcp, a_packed.data() + ir * kcp, b_packed.data() + jr * kcp, tile);
+
+                            for(std::size_t i = 0; i < mr; ++i)
+                            {
+                                for(std::size_t j = 0; j < nr; ++j)
+                                {
+                                    AccT& v = p_acc[acc_offset(ic + ir + i, jc + jr + j)];
+
+                                    v = first ? tile[i * NR + j] : v + tile[i * NR + j];
+                                }
+                            }
+                        }
+                    }
+                }
+            };
+
+            pool.ParallelFor(0, num_block_m * num_task_n, num_chunk, f_tasks);
+        }
+    }
+
+    if constexpr(use_workspace)
+    {
+        pool.ParallelFor(0, M, num_chunk, [&](std::size_t mb, std::size_t me) {
+            std::vector<CT> row(N);
+
+            for(std::size_t m = mb; m < me; ++m)
+            {
+                host_convert_from_acc(workspace.data() + m * N, row.data(), N);
+
+                for(std::size_t n = 0; n < N; ++n)
+                    c.mpData[c.Offset(m, n)] = row[n];
+            }
+        });
+    }
+}
+
+// picks the micro-kernel for the accumulation type and the host CPU
+template <typename AOperand, typename BOperand, typename COutput>
+void gemm_packed_dispatch(const AOperand& a,
+                          const BOperand& b,
+                          const COutput& c,
+                          std::size_t M,
+                          std::size_t N,
+                          std::size_t K,
+                          std::size_t num_thread)
+{
+    using AccT = typename HostGemmDataType<typename AOperand::DataType>::AccType;
+
+    static_assert(
+        std::is_same<AccT,
+                     typename HostGemmDataType<typename BOperand::DataType>::AccType>::value,
+        "wrong! A and B accumulate in different types");
+
+    if constexpr(std::is_same<AccT, float>::value)
+    {
+#if HOST_GEMM_X86_DISPATCH
+        if(__builtin_cpu_supports("avx512f"))
+            return gemm_packed<MicroKernelAvx512Fp32>(a, b, c, M, N, K, num_thread);
+
+        if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return gemm_packed<MicroKernelAvx2Fp32>(a, b, c, M, N, K, num_thread);
+#endif
+        gemm_packed<MicroKernelGeneric<float, 4, 16>>(a, b, c, M, N, K, num_thread);
+    }
+    else if constexpr(std::is_same<AccT, double>::value)
+    {
+        gemm_packed<MicroKernelGeneric<double, 4, 8>>(a, b, c, M, N, K, num_thread);
+    }
+    else
+    {
+#if HOST_GEMM_X86_DISPATCH
+        constexpr bool is_int8 =
+            std::is_same<typename AOperand::DataType, std::int8_t>::value &&
+            std::is_same<typename BOperand::DataType, std::int8_t>::value;
+
+        if constexpr(is_int8)
+        {
+            if(__builtin_cpu_supports("avx512vnni"))
+                return gemm_packed<MicroKernelAvx512VnniInt8>(a, b, c, M, N, K, num_thread);
+
+            if(__builtin_cpu_supports("avx2"))
+                return gemm_packed<MicroKernelAvx2Int8>(a, b, c, M, N, K, num_thread);
+        }
+#endif
+        gemm_packed<MicroKernelGeneric<AccT, 4, 16>>(a, b, c, M, N, K, num_thread);
+    }
+}
+
+} // namespace host_gemm_detail
+
+// Fast CPU GEMM for any GemmMatrixLayout, with the same interface as host_gemm (which stays as
+// the simple reference for checking this one). A and B are packed panel by panel into the layout
+// of a register-blocked micro-kernel, picked at run time for the host CPU (AVX-512, AVX2/FMA, or
+// portable C++). fp32/fp16/bf16 accumulate in fp32, int8 in int32 (exactly, with AVX-512 VNNI or
+// AVX2 dot products).
+// a, b and c can be Tensor or TensorView
+template <typename ATensor, typename BTensor, typename CTensor>
+void host_gemm_packed(const ATensor& a_tensor,
+                      const BTensor& b_tensor,
+                      CTensor&& c_tensor,
+                      const GemmMatrixLayout layout,
+                      std::size_t num_thread = std::thread::hardware_concurrency())
+{
+    using AT = std::remove_const_t<typename decltype(make_tensor_view(a_tensor))::value_type>;
+    using BT = std::remove_const_t<typename decltype(make_tensor_view(b_tensor))::value_type>;
+
+    const TensorView<const AT> a = make_tensor_view(a_tensor);
+    const TensorView<const BT> b = make_tensor_view(b_tensor);
+    const auto c                 = make_tensor_view(c_tensor);
+
+    const std::vector<std::size_t> transposed{1, 0};
+
+    if(layout < GemmMatrixLayout::MK_KN_MN || layout > GemmMatrixLayout::KM_NK_NM)
+        throw std::runtime_error("wrong! not supported layout");
+
+    const bool a_km =
+        layout == GemmMatrixLayout::KM_KN_MN || layout == GemmMatrixLayout::KM_NK_MN ||
+        layout == GemmMatrixLayout::KM_KN_NM || layout == GemmMatrixLayout::KM_NK_NM;
+    const bool b_nk =
+        layout == GemmMatrixLayout::MK_NK_MN || layout == GemmMatrixLayout::KM_NK_MN ||
+        layout == GemmMatrixLayout::MK_NK_NM || layout == GemmMatrixLayout::KM_NK_NM;
+    const bool c_nm =
+        layout == GemmMatrixLayout::MK_KN_NM || layout == GemmMatrixLayout::MK_NK_NM ||
+        layout == GemmMatrixLayout::KM_KN_NM || layout == GemmMatrixLayout::KM_NK_NM;
+
+    // every layout is the M x K by K x N product, on transposed views where needed
+    const auto a_mk = a_km ? a.Permute(transposed) : a;
+    const auto b_kn = b_nk ? b.Permute(transposed) : b;
+    const auto c_mn = c_nm ? c.Permute(transposed) : c;
+
+    if(a_mk.mDesc.GetLengths()[0] != c_mn.mDesc.GetLengths()[0] ||
+       b_kn.mDesc.GetLengths()[1] != c_mn.mDesc.GetLengths()[1] ||
+       a_mk.mDesc.GetLengths()[1] != b_kn.mDesc.GetLengths()[0])
+        throw std::runtime_error("wrong! gemm lengths mismatch");
+
+    // B is read as N x K
+    host_gemm_detail::gemm_packed_dispatch(host_gemm_detail::make_gemm_operand(a_mk),
+                                           host_gemm_detail::make_gemm_operand(
+                                               b_kn.Permute(transposed)),
+                                           host_gemm_detail::make_gemm_output(c_mn),
+                                           c_mn.mDesc.GetLengths()[0],
+                                           c_mn.mDesc.GetLengths()[1],
+                                           a_mk.mDesc.GetLengths()[1],
+                                           num_thread);
+}
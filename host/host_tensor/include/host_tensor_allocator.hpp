@@ -0,0 +1,131 @@
+#ifndef HOST_TENSOR_ALLOCATOR_HPP
+#define HOST_TENSOR_ALLOCATOR_HPP
+
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <sys/mman.h>
+
+// How the storage of a Tensor is allocated and initialized
+struct HostTensorMemoryPolicy
+{
+    static constexpr std::size_t CacheLineSize = 64;
+    static constexpr std::size_t HugePageSize  = std::size_t(2) << 20;
+
+    // base alignment of the buffer, CacheLineSize or HugePageSize
+    std::size_t mAlignment = CacheLineSize;
+
+    // buffers of at least HugePageSize are 2 MB aligned and advised for transparent huge pages
+    bool mUseHugePage = true;
+
+    // false: leave the elements uninitialized, nothing touches the pages until first use
+    bool mZeroFill = true;
+
+    // zero-fill on the thread pool, for the bandwidth of several threads. The pool steals work, so
+    // this does not place a page near the thread that later uses it
+    bool mParallelZeroFill = true;
+
+    // process-wide policy used by the Tensor constructors that don't take one
+    static HostTensorMemoryPolicy& GetDefault()
+    {
+        static HostTensorMemoryPolicy policy;
+
+        return policy;
+    }
+
+    static HostTensorMemoryPolicy Uninitialized()
+    {
+        HostTensorMemoryPolicy policy = GetDefault();
+
+        policy.mZeroFill = false;
+
+        return policy;
+    }
+};
+
+// Allocator for Tensor::mData. construct() without arguments default-initializes, so
+// std::vector<T, HostTensorAllocator<T>>(n) neither writes nor touches the allocated pages, and
+// initialization is left to Tensor according to the policy.
+template <typename T>
+struct HostTensorAllocator
+{
+    using value_type      = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = HostTensorAllocator<U>;
+    };
+
+    HostTensorAllocator() : mPolicy(HostTensorMemoryPolicy::GetDefault()) {}
+
+    HostTensorAllocator(const HostTensorMemoryPolicy& policy) : mPolicy(policy) {}
+
+    template <typename U>
+    HostTensorAllocator(const HostTensorAllocator<U>& other) : mPolicy(other.mPolicy)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        std::size_t alignment = std::max(mPolicy.mAlignment, alignof(T));
+        std::size_t num_byte  = std::max<std::size_t>(n * sizeof(T), 1);
+
+        const bool use_huge_page =
+            mPolicy.mUseHugePage && num_byte >= HostTensorMemoryPolicy::HugePageSize;
+
+        if(use_huge_page)
+            alignment = std::max(alignment, HostTensorMemoryPolicy::HugePageSize);
+
+        // aligned_alloc requires the size to be a multiple of the alignment
+        num_byte = (num_byte + alignment - 1) / alignment * alignment;
+
+        void* p = std::aligned_alloc(alignment, num_byte);
+
+        if(p == nullptr)
+            throw std::bad_alloc();
+
+#ifdef MADV_HUGEPAGE
+        // only a hint, THP may be disabled on the host
+        if(use_huge_page)
+            madvise(p, num_byte, MADV_HUGEPAGE);
+#endif
+
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t) noexcept { std::free(p); }
+
+    template <typename U>
+    void construct(U* p) noexcept(noexcept(::new(static_cast<void*>(p)) U))
+    {
+        ::new(static_cast<void*>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    // all instances allocate with aligned_alloc and release with free, so any of them can free
+    // memory obtained from any other
+    template <typename U>
+    bool operator==(const HostTensorAllocator<U>&) const
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const HostTensorAllocator<U>&) const
+    {
+        return false;
+    }
+
+    HostTensorMemoryPolicy mPolicy;
+};
+
+#endif
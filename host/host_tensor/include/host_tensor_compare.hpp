@@ -0,0 +1,584 @@
+#ifndef HOST_TENSOR_COMPARE_HPP
+#define HOST_TENSOR_COMPARE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "host_tensor.hpp"
+
+// An element passes if |result - ref| <= mAbs + mRel * |ref| + mScale * scale, or if ref and
+// result are at most mUlp units in the last place apart (floating point types only). scale is the
+// element of an optional scale tensor given to compare_host_tensor, 0 without one.
+struct HostTensorTolerance
+{
+    double mAbs        = 0;
+    double mRel        = 0;
+    std::uint64_t mUlp = 0;
+    double mScale      = 0;
+};
+
+// How to read elements of type T: value as double, and for floating point types the bit pattern
+// mapped to an integer that is monotonic in the value, so ULP distance is a subtraction.
+template <typename T, typename Enable = void>
+struct HostTensorCompareTraits
+{
+    static constexpr bool IsFloatingPoint = false;
+
+    static double ToDouble(T x) { return static_cast<double>(x); }
+
+    static std::int64_t ToOrderedBits(T) { return 0; }
+
+    static HostTensorTolerance GetDefaultTolerance() { return {0, 0, 0}; }
+
+    static double GetEpsilon() { return 0; }
+};
+
+template <typename Bits>
+std::int64_t host_tensor_ordered_bits(Bits bits)
+{
+    using SBits = std::make_signed_t<Bits>;
+
+    constexpr Bits sign_mask = Bits(1) << (8 * sizeof(Bits) - 1);
+
+    // negative values count down from zero, so -0 and +0 are both 0
+    return (bits & sign_mask) ? -static_cast<std::int64_t>(static_cast<SBits>(bits & ~sign_mask))
+                              : static_cast<std::int64_t>(bits);
+}
+
+template <typename T>
+struct HostTensorCompareTraits<T,
+                               std::enable_if_t<std::is_same<T, float>::value ||
+                                                std::is_same<T, double>::value>>
+{
+    using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+    static constexpr bool IsFloatingPoint = true;
+
+    static double ToDouble(T x) { return static_cast<double>(x); }
+
+    static std::int64_t ToOrderedBits(T x)
+    {
+        Bits bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return host_tensor_ordered_bits(bits);
+    }
+
+    static HostTensorTolerance GetDefaultTolerance()
+    {
+        return sizeof(T) == 4 ? HostTensorTolerance{1e-5, 1e-4, 0}
+                              : HostTensorTolerance{1e-12, 1e-10, 0};
+    }
+
+    static double GetEpsilon() { return std::numeric_limits<T>::epsilon(); }
+};
+
+#if defined(__FLT16_MAX__)
+template <>
+struct HostTensorCompareTraits<_Float16>
+{
+    static constexpr bool IsFloatingPoint = true;
+
+    static double ToDouble(_Float16 x) { return static_cast<double>(x); }
+
+    static std::int64_t ToOrderedBits(_Float16 x)
+    {
+        std::uint16_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return host_tensor_ordered_bits(bits);
+    }
+
+    static HostTensorTolerance GetDefaultTolerance() { return {1e-3, 1e-3, 2}; }
+
+    static double GetEpsilon() { return 1.0 / 1024; }
+};
+#endif
+
+// bfloat16 is stored as ushort on the host
+template <>
+struct HostTensorCompareTraits<unsigned short>
+{
+    static constexpr bool IsFloatingPoint = true;
+
+    static double ToDouble(unsigned short x)
+    {
+        const std::uint32_t bits = static_cast<std::uint32_t>(x) << 16;
+
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    static std::int64_t ToOrderedBits(unsigned short x) { return host_tensor_ordered_bits(x); }
+
+    static HostTensorTolerance GetDefaultTolerance() { return {1e-2, 1e-2, 2}; }
+
+    static double GetEpsilon() { return 1.0 / 128; }
+};
+
+// Tolerance for elements that are sums of reduction_length products in T, as GEMM and convolution
+// outputs, with the sums of |a * b| as the scale tensor. The default tolerance of T doesn't grow
+// with the length: the rounding error of a sum in any order grows about as
+// sqrt(reduction_length) * eps * sum |a * b|, which is also how much cancellation can amplify it
+// relative to |ref|.
+template <typename T>
+HostTensorTolerance get_reduction_tolerance(std::size_t reduction_length)
+{
+    auto tol = HostTensorCompareTraits<T>::GetDefaultTolerance();
+
+    tol.mScale = std::sqrt(static_cast<double>(reduction_length)) *
+                 HostTensorCompareTraits<T>::GetEpsilon();
+
+    return tol;
+}
+
+struct HostTensorCompareOptions
+{
+    HostTensorTolerance mTolerance;
+
+    // record the coordinates of the first mMaxNumReportedMismatch mismatches
+    std::size_t mMaxNumReportedMismatch = 10;
+
+    // stop as soon as a mismatch is found, mNumMismatch is then a lower bound
+    bool mStopAtFirstMismatch = false;
+
+    std::size_t mNumThread = std::thread::hardware_concurrency();
+};
+
+struct HostTensorMismatch
+{
+    std::vector<std::size_t> mIndex;
+    double mRef;
+    double mResult;
+};
+
+struct HostTensorCompareResult
+{
+    // bin 0: exact match, bin 1: |diff| <= 10^-10, bin i (2 <= i < NumBin - 1): |diff| in
+    // (10^(i - 12), 10^(i - 11)], last bin: |diff| > 10, or NaN
+    static constexpr std::size_t NumBin = 14;
+
+    bool mPass               = true;
+    std::size_t mNumElement  = 0;
+    std::size_t mNumChecked  = 0;
+    std::size_t mNumMismatch = 0;
+
+    double mSumAbsDiff  = 0;
+    double mMaxAbsDiff  = 0;
+    double mRefAtMax    = 0;
+    double mResultAtMax = 0;
+    std::vector<std::size_t> mIndexAtMax;
+
+    std::vector<HostTensorMismatch> mMismatches;
+    std::array<std::size_t, NumBin> mHistogram{};
+};
+
+namespace host_tensor_compare_detail {
+
+// elements are processed in blocks, the per-block loops have no control flow so they vectorize
+constexpr std::size_t BlockSize = 256;
+
+struct ChunkResult
+{
+    std::size_t mNumChecked  = 0;
+    std::size_t mNumMismatch = 0;
+    double mSumAbsDiff       = 0;
+    double mMaxAbsDiff       = -1;
+    std::size_t mLinearAtMax = 0;
+    double mRefAtMax         = 0;
+    double mResultAtMax      = 0;
+    std::vector<std::size_t> mMismatchLinear;
+    std::vector<std::pair<double, double>> mMismatchValue;
+    std::array<std::size_t, HostTensorCompareResult::NumBin> mHistogram{};
+};
+
+// upper edges of the bins 1 to NumBin - 2. Compared as literals, a diff on an edge can't be moved
+// to the next bin by the rounding of log10
+constexpr std::array<double, HostTensorCompareResult::NumBin - 2> BinUpperEdges = {
+    1e-10, 1e-9, 1e-8, 1e-7, 1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1};
+
+inline std::size_t get_bin(double diff)
+{
+    if(diff == 0)
+        return 0;
+
+    if(!(diff <= BinUpperEdges.back()))
+        return HostTensorCompareResult::NumBin - 1;
+
+    return 1 + (std::lower_bound(BinUpperEdges.begin(), BinUpperEdges.end(), diff) -
+                BinUpperEdges.begin());
+}
+
+// stands for the scale tensor when there is none, every scale is then 0
+struct NoScale
+{
+};
+
+inline NoScale make_scale_view(const NoScale& scale) { return scale; }
+
+template <typename ScaleTensor>
+auto make_scale_view(const ScaleTensor& scale)
+{
+    return make_tensor_view(scale);
+}
+
+} // namespace host_tensor_compare_detail
+
+// Compares ref and result (Tensor or TensorView of the same lengths) element by element, in
+// parallel over the thread pool, with scale (Tensor or TensorView of the same lengths) giving the
+// per-element scale of options.mTolerance. Mismatches are reported in row-major order of the
+// logical index.
+template <typename RefTensor, typename ResultTensor, typename ScaleTensor>
+HostTensorCompareResult compare_host_tensor(const RefTensor& ref_tensor,
+                                            const ResultTensor& result_tensor,
+                                            const ScaleTensor& scale_tensor,
+                                            const HostTensorCompareOptions& options)
+{
+    using namespace host_tensor_compare_detail;
+
+    constexpr bool has_scale = !std::is_same<ScaleTensor, NoScale>::value;
+
+    const auto ref    = make_tensor_view(ref_tensor);
+    const auto result = make_tensor_view(result_tensor);
+    const auto scale  = make_scale_view(scale_tensor);
+
+    using RefType    = std::remove_const_t<std::remove_pointer_t<decltype(ref.mpData)>>;
+    using ResultType = std::remove_const_t<std::remove_pointer_t<decltype(result.mpData)>>;
+
+    using RefTraits    = HostTensorCompareTraits<RefType>;
+    using ResultTraits = HostTensorCompareTraits<ResultType>;
+
+    constexpr bool use_ulp = std::is_same<RefType, ResultType>::value && RefTraits::IsFloatingPoint;
+
+    const auto& lens = ref.mDesc.GetLengths();
+
+    if(!std::equal(lens.begin(),
+                   lens.end(),
+                   result.mDesc.GetLengths().begin(),
+                   result.mDesc.GetLengths().end()))
+        throw std::runtime_error("wrong! compare lengths mismatch");
+
+    if constexpr(has_scale)
+    {
+        if(!std::equal(lens.begin(),
+                       lens.end(),
+                       scale.mDesc.GetLengths().begin(),
+                       scale.mDesc.GetLengths().end()))
+            throw std::runtime_error("wrong! compare scale lengths mismatch");
+    }
+
+    const std::size_t ndim = lens.size();
+    const std::size_t size = ref.mDesc.GetElementSize();
+
+    const auto& tol = options.mTolerance;
+
+    // all packed row-major: the logical index is the offset, no index arithmetic at all
+    bool packed = ref.mDesc.IsPacked() && result.mDesc.IsPacked();
+
+    if constexpr(has_scale)
+        packed = packed && scale.mDesc.IsPacked();
+
+    std::atomic<bool> stop{false};
+
+    const std::size_t num_chunk =
+        options.mNumThread <= 1 ? 1 : options.mNumThread * HostThreadPool::ChunkPerThread;
+
+    const std::size_t work_per_chunk = std::max<std::size_t>((size + num_chunk - 1) / num_chunk, 1);
+
+    std::vector<ChunkResult> chunk_results((size + work_per_chunk - 1) / work_per_chunk);
+
+    auto f_chunk = [&](ChunkResult& cr, std::size_t ib, std::size_t ie) {
+        std::vector<std::size_t> idx(ndim, 0);
+        std::size_t ref_offset = ib, result_offset = ib, scale_offset = ib;
+
+        if(!packed)
+        {
+            ref_offset    = 0;
+            result_offset = 0;
+            scale_offset  = 0;
+
+            for(std::size_t i = ndim, rest = ib; i-- > 0;)
+            {
+                idx[i] = rest % lens[i];
+                rest /= lens[i];
+
+                ref_offset += idx[i] * ref.mDesc.GetStrides()[i];
+                result_offset += idx[i] * result.mDesc.GetStrides()[i];
+
+                if constexpr(has_scale)
+                    scale_offset += idx[i] * scale.mDesc.GetStrides()[i];
+            }
+        }
+
+        RefType r_raw[BlockSize];
+        ResultType v_raw[BlockSize];
+        double r[BlockSize];
+        double v[BlockSize];
+        double s[BlockSize];
+        double diff[BlockSize];
+        unsigned char bad[BlockSize];
+
+        for(std::size_t bb = ib; bb < ie; bb += BlockSize)
+        {
+            if(stop.load(std::memory_order_relaxed))
+                return;
+
+            const std::size_t n = std::min(BlockSize, ie - bb);
+
+            if(packed)
+            {
+                std::copy(ref.mpData + bb, ref.mpData + bb + n, r_raw);
+                std::copy(result.mpData + bb, result.mpData + bb + n, v_raw);
+
+                if constexpr(has_scale)
+                    std::copy(scale.mpData + bb, scale.mpData + bb + n, s);
+            }
+            else
+            {
+                for(std::size_t i = 0; i < n; ++i)
+                {
+                    r_raw[i] = ref.mpData[ref_offset];
+                    v_raw[i] = result.mpData[result_offset];
+
+                    if constexpr(has_scale)
+                        s[i] = scale.mpData[scale_offset];
+
+                    for(std::size_t d = ndim; d-- > 0;)
+                    {
+                        ref_offset += ref.mDesc.GetStrides()[d];
+                        result_offset += result.mDesc.GetStrides()[d];
+
+                        if constexpr(has_scale)
+                            scale_offset += scale.mDesc.GetStrides()[d];
+
+                        if(++idx[d] < lens[d] || d == 0)
+                            break;
+
+                        ref_offset -= lens[d] * ref.mDesc.GetStrides()[d];
+                        result_offset -= lens[d] * result.mDesc.GetStrides()[d];
+
+                        if constexpr(has_scale)
+                            scale_offset -= lens[d] * scale.mDesc.GetStrides()[d];
+
+                        idx[d] = 0;
+                    }
+                }
+            }
+
+            if constexpr(!has_scale)
+                std::fill(s, s + n, 0.0);
+
+            std::size_t num_bad = 0;
+
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                r[i]    = RefTraits::ToDouble(r_raw[i]);
+                v[i]    = ResultTraits::ToDouble(v_raw[i]);
+                diff[i] = std::abs(r[i] - v[i]);
+
+                // written so that NaN fails
+                bad[i] = !(diff[i] <= tol.mAbs + tol.mRel * std::abs(r[i]) + tol.mScale * s[i]);
+                num_bad += bad[i];
+            }
+
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                cr.mSumAbsDiff += diff[i];
+            }
+
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                if(diff[i] > cr.mMaxAbsDiff)
+                {
+                    cr.mMaxAbsDiff  = diff[i];
+                    cr.mLinearAtMax = bb + i;
+                    cr.mRefAtMax    = r[i];
+                    cr.mResultAtMax = v[i];
+                }
+
+                ++cr.mHistogram[get_bin(diff[i])];
+            }
+
+            cr.mNumChecked += n;
+
+            if(num_bad == 0)
+                continue;
+
+            // rare path: ULP check and bookkeeping for the elements outside abs/rel tolerance
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                if(!bad[i])
+                    continue;
+
+                if constexpr(use_ulp)
+                {
+                    if(!std::isnan(r[i]) && !std::isnan(v[i]))
+                    {
+                        const std::int64_t dist = RefTraits::ToOrderedBits(r_raw[i]) -
+                                                  ResultTraits::ToOrderedBits(v_raw[i]);
+
+                        if(static_cast<std::uint64_t>(dist < 0 ? -dist : dist) <= tol.mUlp)
+                            continue;
+                    }
+                }
+
+                ++cr.mNumMismatch;
+
+                if(cr.mMismatchLinear.size() < options.mMaxNumReportedMismatch)
+                {
+                    cr.mMismatchLinear.push_back(bb + i);
+                    cr.mMismatchValue.emplace_back(r[i], v[i]);
+                }
+
+                if(options.mStopAtFirstMismatch)
+                {
+                    stop.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        }
+    };
+
+    // one pool chunk per ChunkResult, so partial results never depend on the pool's partition
+    HostThreadPool::GetInstance().ParallelFor(
+        0, chunk_results.size(), chunk_results.size(), [&](std::size_t cb, std::size_t ce) {
+            for(std::size_t c = cb; c < ce; ++c)
+            {
+                f_chunk(chunk_results[c],
+                        c * work_per_chunk,
+                        std::min((c + 1) * work_per_chunk, size));
+            }
+        });
+
+    auto get_index = [&](std::size_t linear) {
+        std::vector<std::size_t> index(ndim);
+
+        for(std::size_t i = ndim; i-- > 0;)
+        {
+            index[i] = linear % lens[i];
+            linear /= lens[i];
+        }
+
+        return index;
+    };
+
+    // merge in chunk order, so the report doesn't depend on scheduling
+    HostTensorCompareResult res;
+
+    res.mNumElement = size;
+
+    double max_abs_diff = -1;
+
+    for(const auto& cr : chunk_results)
+    {
+        res.mNumChecked += cr.mNumChecked;
+        res.mNumMismatch += cr.mNumMismatch;
+        res.mSumAbsDiff += cr.mSumAbsDiff;
+
+        if(cr.mMaxAbsDiff > max_abs_diff)
+        {
+            max_abs_diff     = cr.mMaxAbsDiff;
+            res.mMaxAbsDiff  = cr.mMaxAbsDiff;
+            res.mRefAtMax    = cr.mRefAtMax;
+            res.mResultAtMax = cr.mResultAtMax;
+            res.mIndexAtMax  = get_index(cr.mLinearAtMax);
+        }
+
+        for(std::size_t i = 0; i < cr.mMismatchLinear.size() &&
+                               res.mMismatches.size() < options.mMaxNumReportedMismatch;
+            ++i)
+        {
+            res.mMismatches.push_back({get_index(cr.mMismatchLinear[i]),
+                                       cr.mMismatchValue[i].first,
+                                       cr.mMismatchValue[i].second});
+        }
+
+        for(std::size_t b = 0; b < HostTensorCompareResult::NumBin; ++b)
+        {
+            res.mHistogram[b] += cr.mHistogram[b];
+        }
+    }
+
+    res.mPass = res.mNumMismatch == 0;
+
+    return res;
+}
+
+// without a scale tensor
+template <typename RefTensor, typename ResultTensor>
+HostTensorCompareResult compare_host_tensor(const RefTensor& ref,
+                                            const ResultTensor& result,
+                                            const HostTensorCompareOptions& options)
+{
+    return compare_host_tensor(ref, result, host_tensor_compare_detail::NoScale{}, options);
+}
+
+// default tolerance of the reference data type
+template <typename RefTensor, typename ResultTensor>
+HostTensorCompareResult compare_host_tensor(const RefTensor& ref, const ResultTensor& result)
+{
+    using RefType =
+        std::remove_const_t<std::remove_pointer_t<decltype(make_tensor_view(ref).mpData)>>;
+
+    HostTensorCompareOptions options;
+
+    options.mTolerance = HostTensorCompareTraits<RefType>::GetDefaultTolerance();
+
+    return compare_host_tensor(ref, result, options);
+}
+
+void ostream_HostTensorCompareResult(const HostTensorCompareResult& res,
+                                     std::ostream& os = std::cout);
+
+// ref and result can be Tensor or TensorView, returns true if all elements are within the default
+// tolerance of the data type
+template <typename RefTensor, typename ResultTensor>
+bool check_error(const RefTensor& ref, const ResultTensor& result)
+{
+    const auto res = compare_host_tensor(ref, result);
+
+    ostream_HostTensorCompareResult(res, std::cout);
+
+    return res.mPass;
+}
+
+// |x| of every element of t, the inputs of the reference that gives the abs_product_sum below
+template <typename T>
+Tensor<T> make_abs_host_tensor(const Tensor<T>& t)
+{
+    Tensor<T> t_abs(t.mDesc);
+
+    t_abs.View().Transform(t, [](T x) { return x < T{0} ? T{-x} : x; });
+
+    return t_abs;
+}
+
+// for ref and result that are sums of reduction_length products, abs_product_sum holds the sums of
+// the |a * b|, e.g. the reference computed again from |a| and |b|. Returns true if all elements are
+// within get_reduction_tolerance of the reference data type
+template <typename RefTensor, typename ResultTensor, typename ScaleTensor>
+bool check_error(const RefTensor& ref,
+                 const ResultTensor& result,
+                 const ScaleTensor& abs_product_sum,
+                 std::size_t reduction_length)
+{
+    using RefType =
+        std::remove_const_t<std::remove_pointer_t<decltype(make_tensor_view(ref).mpData)>>;
+
+    HostTensorCompareOptions options;
+
+    options.mTolerance = get_reduction_tolerance<RefType>(reduction_length);
+
+    const auto res = compare_host_tensor(ref, result, abs_product_sum, options);
+
+    ostream_HostTensorCompareResult(res, std::cout);
+
+    return res.mPass;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef HOST_TENSOR_FILE_HPP
+#define HOST_TENSOR_FILE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "data_type_enum.hpp"
+
+// Binary tensor file, native byte order:
+//   HostTensorFileHeader
+//   uint64_t lengths[mNumDim]
+//   uint64_t strides[mNumDim]
+//   zero padding up to mDataOffset (a multiple of HostTensorFileHeader::DataAlignment)
+//   raw element space, mDataBytes bytes
+// The data is stored exactly as laid out in memory, so a file can be mmap'ed and used in place.
+struct HostTensorFileHeader
+{
+    static constexpr char Magic[8]               = {'C', 'K', 'T', 'E', 'N', 'S', 'O', 'R'};
+    static constexpr std::uint32_t Version       = 1;
+    static constexpr std::uint64_t DataAlignment = 64;
+
+    char mMagic[8];
+    std::uint32_t mVersion;
+    std::uint32_t mDataType; // ck::DataTypeEnum_t
+    std::uint32_t mElementBytes;
+    std::uint32_t mNumDim;
+    std::uint64_t mDataOffset;
+    std::uint64_t mDataBytes;
+};
+
+template <typename T>
+struct HostTensorFileDataType;
+
+template <>
+struct HostTensorFileDataType<float>
+{
+    static constexpr ck::DataTypeEnum_t value = ck::DataTypeEnum_t::Float;
+};
+
+template <>
+struct HostTensorFileDataType<double>
+{
+    static constexpr ck::DataTypeEnum_t value = ck::DataTypeEnum_t::Double;
+};
+
+template <>
+struct HostTensorFileDataType<std::int32_t>
+{
+    static constexpr ck::DataTypeEnum_t value = ck::DataTypeEnum_t::Int32;
+};
+
+template <>
+struct HostTensorFileDataType<std::int8_t>
+{
+    static constexpr ck::DataTypeEnum_t value = ck::DataTypeEnum_t::Int8;
+};
+
+// bfloat16 is stored as ushort on the host
+template <>
+struct HostTensorFileDataType<unsigned short>
+{
+    static constexpr ck::DataTypeEnum_t value = ck::DataTypeEnum_t::BFloat16;
+};
+
+#if defined(__FLT16_MAX__)
+template <>
+struct HostTensorFileDataType<_Float16>
+{
+    static constexpr ck::DataTypeEnum_t value = ck::DataTypeEnum_t::Half;
+};
+#endif
+
+// contents of a tensor file; mpData points into a read-only mapping of the file, which stays
+// alive as long as mpStorage does
+struct HostTensorFileMapping
+{
+    ck::DataTypeEnum_t mDataType;
+    std::vector<std::size_t> mLens;
+    std::vector<std::size_t> mStrides;
+    const void* mpData;
+    std::size_t mDataBytes;
+    std::shared_ptr<const void> mpStorage;
+};
+
+void save_host_tensor_file(const std::string& path,
+                           ck::DataTypeEnum_t data_type,
+                           std::size_t element_bytes,
+                           const std::vector<std::size_t>& lens,
+                           const std::vector<std::size_t>& strides,
+                           const void* p_data,
+                           std::size_t data_bytes);
+
+// throws if the file is not a tensor file, or doesn't hold elements of data_type
+HostTensorFileMapping map_host_tensor_file(const std::string& path,
+                                           ck::DataTypeEnum_t data_type,
+                                           std::size_t element_bytes);
+
+#endif
@@ -2,6 +2,10 @@
 #define HOST_TENSOR_GENERATOR_HPP
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
 #include "config.hpp"
 
 struct GeneratorTensor_1
@@ -26,33 +30,107 @@ struct GeneratorTensor_0
     }
 };
 
+// Counter-based random numbers: every value is a pure function of (seed, element indices), so
+// generation needs no shared state, scales with threads and gives bit-identical tensors for any
+// thread count. The mixing function is the SplitMix64 finalizer.
+inline std::uint64_t host_rng_mix(std::uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+template <typename... Is>
+std::uint64_t host_rng_hash(std::uint64_t seed, Is... is)
+{
+    std::uint64_t h = host_rng_mix(seed);
+
+    // fold the indices in one at a time, so (1, 0) and (0, 1) get unrelated values
+    (void)std::initializer_list<int>{(h = host_rng_mix(h ^ static_cast<std::uint64_t>(is)), 0)...};
+
+    return h;
+}
+
+// uniform in [0, 1) with 24 random bits, exactly representable as float
+inline float host_rng_uniform_float(std::uint64_t h)
+{
+    return static_cast<float>(h >> 40) * (1.0f / 16777216.0f);
+}
+
+// uniform integer in [min_value, max_value)
 struct GeneratorTensor_2
 {
-    int min_value = 0;
-    int max_value = 1;
+    int min_value      = 0;
+    int max_value      = 1;
+    std::uint64_t seed = 0;
 
     template <typename... Is>
-    float operator()(Is...)
+    float operator()(Is... is) const
     {
-        return (std::rand() % (max_value - min_value)) + min_value;
+        const std::uint64_t range = max_value - min_value;
+
+        // multiply-shift maps the upper 32 random bits onto [0, range) without a division
+        return static_cast<int>(((host_rng_hash(seed, is...) >> 32) * range) >> 32) + min_value;
     }
 };
 
+// uniform real in [min_value, max_value)
 template <typename T>
 struct GeneratorTensor_3
 {
-    T min_value = 0;
-    T max_value = 1;
+    T min_value        = 0;
+    T max_value        = 1;
+    std::uint64_t seed = 0;
 
     template <typename... Is>
-    float operator()(Is...)
+    float operator()(Is... is) const
     {
-        float tmp = float(std::rand()) / float(RAND_MAX);
+        float tmp = host_rng_uniform_float(host_rng_hash(seed, is...));
 
         return min_value + tmp * (max_value - min_value);
     }
 };
 
+// normal distribution, Box-Muller on the two 32-bit halves of one hash
+struct GeneratorTensor_4
+{
+    float mean         = 0;
+    float stddev       = 1;
+    std::uint64_t seed = 0;
+
+    template <typename... Is>
+    float operator()(Is... is) const
+    {
+        const std::uint64_t h = host_rng_hash(seed, is...);
+
+        // u1 in (0, 1] so that log(u1) is finite
+        const float u1 = (static_cast<float>(h >> 40) + 1.0f) * (1.0f / 16777216.0f);
+        const float u2 = static_cast<float>((h >> 8) & 0xffffff) * (1.0f / 16777216.0f);
+
+        return mean + stddev * std::sqrt(-2.0f * std::log(u1)) *
+                          std::cos(6.28318530717958647692f * u2);
+    }
+};
+
+// zero with probability zero_probability, otherwise the value of generator g
+template <typename G>
+struct GeneratorTensor_Sparse
+{
+    G g;
+    float zero_probability = 0.5;
+    std::uint64_t seed     = 0;
+
+    template <typename... Is>
+    float operator()(Is... is) const
+    {
+        // separate stream from g, so the zero pattern is independent of the values
+        const std::uint64_t h = host_rng_hash(seed ^ 0x5a5a5a5a5a5a5a5aull, is...);
+
+        return host_rng_uniform_float(h) < zero_probability ? 0 : g(is...);
+    }
+};
+
 struct GeneratorTensor_Checkboard
 {
     template <typename... Ts>
@@ -68,4 +146,54 @@ struct GeneratorTensor_Checkboard
     }
 };
 
+// Removes "--seed <value>" from the command line, so the positional arguments are unchanged, and
+// returns the value, or default_seed if the option is not given
+inline std::uint64_t get_seed_from_args(int& argc, char* argv[], std::uint64_t default_seed = 0)
+{
+    std::uint64_t seed = default_seed;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = std::stoull(argv[i + 1]);
+
+            for(int j = i; j + 2 <= argc; ++j)
+            {
+                argv[j] = argv[j + 2];
+            }
+
+            argc -= 2;
+            break;
+        }
+    }
+
+    return seed;
+}
+
+// Removes "--group <G>" from the command line like get_seed_from_args, and returns G, or 1 (an
+// ungrouped convolution) if the option is not given
+inline ck::index_t get_group_from_args(int& argc, char* argv[])
+{
+    ck::index_t group = 1;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--group") == 0 && i + 1 < argc)
+        {
+            group = std::stoi(argv[i + 1]);
+
+            for(int j = i; j + 2 <= argc; ++j)
+            {
+                argv[j] = argv[j + 2];
+            }
+
+            argc -= 2;
+            break;
+        }
+    }
+
+    return group;
+}
+
 #endif
@@ -0,0 +1,484 @@
+#ifndef HOST_TENSOR_LAYOUT_HPP
+#define HOST_TENSOR_LAYOUT_HPP
+
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "host_tensor.hpp"
+#include "conv_common.hpp"
+
+namespace host_tensor_layout_detail {
+
+// square tile transposed in registers: dst row i is src column i
+template <std::size_t ElementBytes>
+struct TransposeTileKernel
+{
+    static constexpr std::size_t Tile = 1;
+
+    static void Run(const char* p_src, std::size_t src_ld, char* p_dst, std::size_t)
+    {
+        (void)src_ld;
+        std::memcpy(p_dst, p_src, ElementBytes);
+    }
+};
+
+#if defined(__SSE2__)
+// float, int32
+template <>
+struct TransposeTileKernel<4>
+{
+    static constexpr std::size_t Tile = 4;
+
+    static void Run(const char* p_src, std::size_t src_ld, char* p_dst, std::size_t dst_ld)
+    {
+        __m128 r0 = _mm_loadu_ps(reinterpret_cast<const float*>(p_src));
+        __m128 r1 = _mm_loadu_ps(reinterpret_cast<const float*>(p_src + src_ld));
+        __m128 r2 = _mm_loadu_ps(reinterpret_cast<const float*>(p_src + 2 * src_ld));
+        __m128 r3 = _mm_loadu_ps(reinterpret_cast<const float*>(p_src + 3 * src_ld));
+
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        _mm_storeu_ps(reinterpret_cast<float*>(p_dst), r0);
+        _mm_storeu_ps(reinterpret_cast<float*>(p_dst + dst_ld), r1);
+        _mm_storeu_ps(reinterpret_cast<float*>(p_dst + 2 * dst_ld), r2);
+        _mm_storeu_ps(reinterpret_cast<float*>(p_dst + 3 * dst_ld), r3);
+    }
+};
+
+// half, bfloat16
+template <>
+struct TransposeTileKernel<2>
+{
+    static constexpr std::size_t Tile = 8;
+
+    static void Run(const char* p_src, std::size_t src_ld, char* p_dst, std::size_t dst_ld)
+    {
+        __m128i a[8];
+
+        for(int i = 0; i < 8; ++i)
+            a[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_src + i * src_ld));
+
+        const __m128i t0 = _mm_unpacklo_epi16(a[0], a[1]);
+        const __m128i t1 = _mm_unpackhi_epi16(a[0], a[1]);
+        const __m128i t2 = _mm_unpacklo_epi16(a[2], a[3]);
+        const __m128i t3 = _mm_unpackhi_epi16(a[2], a[3]);
+        const __m128i t4 = _mm_unpacklo_epi16(a[4], a[5]);
+        const __m128i t5 = _mm_unpackhi_epi16(a[4], a[5]);
+        const __m128i t6 = _mm_unpacklo_epi16(a[6], a[7]);
+        const __m128i t7 = _mm_unpackhi_epi16(a[6], a[7]);
+
+        const __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+        const __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+        const __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+        const __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+        const __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+        const __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+        const __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+        const __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+        const __m128i r[8] = {_mm_unpacklo_epi64(u0, u4),
+                              _mm_unpackhi_epi64(u0, u4),
+                              _mm_unpacklo_epi64(u1, u5),
+                              _mm_unpackhi_epi64(u1, u5),
+                              _mm_unpacklo_epi64(u2, u6),
+                              _mm_unpackhi_epi64(u2, u6),
+                              _mm_unpacklo_epi64(u3, u7),
+                              _mm_unpackhi_epi64(u3, u7)};
+
+        for(int i = 0; i < 8; ++i)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p_dst + i * dst_ld), r[i]);
+    }
+};
+
+// int8
+template <>
+struct TransposeTileKernel<1>
+{
+    static constexpr std::size_t Tile = 8;
+
+    static void Run(const char* p_src, std::size_t src_ld, char* p_dst, std::size_t dst_ld)
+    {
+        __m128i a[8];
+
+        for(int i = 0; i < 8; ++i)
+            a[i] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p_src + i * src_ld));
+
+        const __m128i t0 = _mm_unpacklo_epi8(a[0], a[1]);
+        const __m128i t1 = _mm_unpacklo_epi8(a[2], a[3]);
+        const __m128i t2 = _mm_unpacklo_epi8(a[4], a[5]);
+        const __m128i t3 = _mm_unpacklo_epi8(a[6], a[7]);
+
+        const __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+        const __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+        const __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+        const __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+
+        // each holds two rows of the result
+        const __m128i v[4] = {_mm_unpacklo_epi32(u0, u2),
+                              _mm_unpackhi_epi32(u0, u2),
+                              _mm_unpacklo_epi32(u1, u3),
+                              _mm_unpackhi_epi32(u1, u3)};
+
+        for(int i = 0; i < 4; ++i)
+        {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(p_dst + 2 * i * dst_ld), v[i]);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(p_dst + (2 * i + 1) * dst_ld),
+                             _mm_unpackhi_epi64(v[i], v[i]));
+        }
+    }
+};
+#endif
+
+// the tensors are split into blocks of BlockSize x BlockSize elements, that fit in L1 for both
+// the source and the destination
+constexpr std::size_t BlockSize = 64;
+
+} // namespace host_tensor_layout_detail
+
+// dst(i, j) = src(j, i) for i < nrow, j < ncol, both matrices row-major with leading dimensions
+// src_ld and dst_ld (in elements)
+template <typename T>
+void host_transpose_2d(const T* p_src,
+                       std::size_t src_ld,
+                       T* p_dst,
+                       std::size_t dst_ld,
+                       std::size_t nrow,
+                       std::size_t ncol)
+{
+    using namespace host_tensor_layout_detail;
+
+    static_assert(std::is_trivially_copyable<T>::value, "wrong! T is not trivially copyable");
+
+    using Kernel = TransposeTileKernel<sizeof(T)>;
+
+    constexpr std::size_t Tile = Kernel::Tile;
+
+    for(std::size_t ib = 0; ib < nrow; ib += BlockSize)
+    {
+        const std::size_t ie = std::min(ib + BlockSize, nrow);
+
+        for(std::size_t jb = 0; jb < ncol; jb += BlockSize)
+        {
+            const std::size_t je = std::min(jb + BlockSize, ncol);
+
+            std::size_t i = ib;
+
+            for(; i + Tile <= ie; i += Tile)
+            {
+                std::size_t j = jb;
+
+                for(; j + Tile <= je; j += Tile)
+                {
+                    Kernel::Run(reinterpret_cast<const char*>(p_src + j * src_ld + i),
+                                src_ld * sizeof(T),
+                                reinterpret_cast<char*>(p_dst + i * dst_ld + j),
+                                dst_ld * sizeof(T));
+                }
+
+                for(; j < je; ++j)
+                {
+                    for(std::size_t ii = i; ii < i + Tile; ++ii)
+                        p_dst[ii * dst_ld + j] = p_src[j * src_ld + ii];
+                }
+            }
+
+            for(; i < ie; ++i)
+            {
+                for(std::size_t j = jb; j < je; ++j)
+                    p_dst[i * dst_ld + j] = p_src[j * src_ld + i];
+            }
+        }
+    }
+}
+
+// Copies src into dst element by element, for views of the same lengths and any strides. When
+// the unit-stride dimensions of src and dst differ, the plane they span is transposed in
+// cache-sized blocks; otherwise whole rows are copied.
+template <typename SrcTensor, typename DstTensor>
+void host_tensor_copy(const SrcTensor& src_tensor,
+                      DstTensor&& dst_tensor,
+                      std::size_t num_thread = std::thread::hardware_concurrency())
+{
+    using namespace host_tensor_layout_detail;
+
+    const auto src = make_tensor_view(src_tensor);
+    const auto dst = make_tensor_view(dst_tensor);
+
+    const auto& lens        = dst.mDesc.GetLengths();
+    const auto& src_strides = src.mDesc.GetStrides();
+    const auto& dst_strides = dst.mDesc.GetStrides();
+
+    if(!std::equal(lens.begin(),
+                   lens.end(),
+                   src.mDesc.GetLengths().begin(),
+                   src.mDesc.GetLengths().end()))
+        throw std::runtime_error("wrong! copy lengths mismatch");
+
+    const std::size_t ndim = lens.size();
+    const std::size_t size = dst.mDesc.GetElementSize();
+
+    if(size == 0)
+        return;
+
+    if(src.mDesc.IsPacked() && dst.mDesc.IsPacked())
+    {
+        HostThreadPool::GetInstance().ParallelFor(
+            0, size, num_thread * HostThreadPool::ChunkPerThread, [&](auto ib, auto ie) {
+                std::copy(src.mpData + ib, src.mpData + ie, dst.mpData + ib);
+            });
+
+        return;
+    }
+
+    // innermost dimension of each side, dimensions of length 1 don't matter
+    auto get_inner_dim = [&](const HostTensorDims& strides) {
+        std::size_t inner = ndim;
+
+        for(std::size_t i = 0; i < ndim; ++i)
+        {
+            if(lens[i] > 1 && (inner == ndim || strides[i] < strides[inner]))
+                inner = i;
+        }
+
+        return inner;
+    };
+
+    const std::size_t d = get_inner_dim(dst_strides);
+    const std::size_t s = get_inner_dim(src_strides);
+
+    if(d == ndim)
+    {
+        // single element
+        dst.mpData[0] = src.mpData[0];
+        return;
+    }
+
+    const bool transpose = s != ndim && s != d && src_strides[s] == 1 && dst_strides[d] == 1;
+
+    std::vector<std::size_t> outer_dims;
+
+    for(std::size_t i = 0; i < ndim; ++i)
+    {
+        if(i != d && !(transpose && i == s))
+            outer_dims.push_back(i);
+    }
+
+    const std::size_t num_outer = std::accumulate(
+        outer_dims.begin(), outer_dims.end(), std::size_t{1}, [&](std::size_t a, std::size_t i) {
+            return a * lens[i];
+        });
+
+    const std::size_t num_block = transpose ? (lens[s] + BlockSize - 1) / BlockSize : 1;
+
+    auto f = [&](std::size_t ib, std::size_t ie) {
+        for(std::size_t item = ib; item < ie; ++item)
+        {
+            std::size_t rest       = item / num_block;
+            std::size_t src_offset = 0, dst_offset = 0;
+
+            for(std::size_t k = outer_dims.size(); k-- > 0;)
+            {
+                const std::size_t i   = outer_dims[k];
+                const std::size_t idx = rest % lens[i];
+
+                rest /= lens[i];
+
+                src_offset += idx * src_strides[i];
+                dst_offset += idx * dst_strides[i];
+            }
+
+            if(transpose)
+            {
+                const std::size_t b  = (item % num_block) * BlockSize;
+                const std::size_t nb = std::min(BlockSize, lens[s] - b);
+
+                host_transpose_2d(src.mpData + src_offset + b,
+                                  src_strides[d],
+                                  dst.mpData + dst_offset + b * dst_strides[s],
+                                  dst_strides[s],
+                                  nb,
+                                  lens[d]);
+            }
+            else if(src_strides[d] == 1 && dst_strides[d] == 1)
+            {
+                std::copy(src.mpData + src_offset,
+                          src.mpData + src_offset + lens[d],
+                          dst.mpData + dst_offset);
+            }
+            else
+            {
+                for(std::size_t j = 0; j < lens[d]; ++j)
+                    dst.mpData[dst_offset + j * dst_strides[d]] =
+                        src.mpData[src_offset + j * src_strides[d]];
+            }
+        }
+    };
+
+    HostThreadPool::GetInstance().ParallelFor(
+        0, num_outer * num_block, num_thread * HostThreadPool::ChunkPerThread, f);
+}
+
+// Lengths of the host tensor holding an N x C x H x W activation in layout, as used by the
+// drivers. A K x C x Y x X weight is the same with K for N, so KCYX is NCHW and KYXC is NHWC.
+// The vectorized layouts split C into C / vector_size x vector_size, with C padded up to a
+// multiple of vector_size:
+//   NCHWc: N, C / vector_size, H, W, vector_size
+//   NHWCc: N, H, W, C / vector_size, vector_size
+// e.g. NCHWc with vector_size 4 over int8_t is the layout of Int8x4 kernels, and with
+// vector_size 8 over half_t the layout of fp16x8 kernels.
+inline std::vector<std::size_t> get_conv_tensor_lengths(ConvTensorLayout layout,
+                                                        std::size_t n,
+                                                        std::size_t c,
+                                                        std::size_t h,
+                                                        std::size_t w,
+                                                        std::size_t vector_size = 1)
+{
+    const std::size_t c0 = (c + vector_size - 1) / vector_size;
+
+    switch(layout)
+    {
+    case ConvTensorLayout::NCHW: return {n, c, h, w};
+    case ConvTensorLayout::NHWC: return {n, h, w, c};
+    case ConvTensorLayout::CHWN: return {c, h, w, n};
+    case ConvTensorLayout::NCHWc: return {n, c0, h, w, vector_size};
+    case ConvTensorLayout::NHWCc: return {n, h, w, c0, vector_size};
+    case ConvTensorLayout::NCDHW:
+    case ConvTensorLayout::NDHWC: break;
+    }
+
+    throw std::runtime_error("wrong! unknown layout");
+}
+
+inline bool is_vectorized_conv_tensor_layout(ConvTensorLayout layout)
+{
+    return layout == ConvTensorLayout::NCHWc || layout == ConvTensorLayout::NHWCc;
+}
+
+namespace host_tensor_layout_detail {
+
+// N x C0 x C1 x H x W view of a tensor in layout, with channel c0 * vector_size + c1
+template <typename T>
+TensorView<T> make_conv_tensor_view_n_c0_c1_h_w(const TensorView<T>& t,
+                                                ConvTensorLayout layout,
+                                                std::size_t vector_size,
+                                                std::size_t c_begin,
+                                                const std::array<std::size_t, 5>& lens)
+{
+    const auto& s = t.mDesc.GetStrides();
+
+    std::array<std::size_t, 5> strides{};
+
+    switch(layout)
+    {
+    case ConvTensorLayout::NCHW: strides = {s[0], vector_size * s[1], s[1], s[2], s[3]}; break;
+    case ConvTensorLayout::NHWC: strides = {s[0], vector_size * s[3], s[3], s[1], s[2]}; break;
+    case ConvTensorLayout::CHWN: strides = {s[3], vector_size * s[0], s[0], s[1], s[2]}; break;
+    case ConvTensorLayout::NCHWc: strides = {s[0], s[1], s[4], s[2], s[3]}; break;
+    case ConvTensorLayout::NHWCc: strides = {s[0], s[3], s[4], s[1], s[2]}; break;
+    case ConvTensorLayout::NCDHW:
+    case ConvTensorLayout::NDHWC: throw std::runtime_error("wrong! not a 2-D layout");
+    }
+
+    const std::size_t offset =
+        (c_begin / vector_size) * strides[1] + (c_begin % vector_size) * strides[2];
+
+    return TensorView<T>(t.mpData + offset, HostTensorDescriptor(lens, strides), t.mpStorage);
+}
+
+} // namespace host_tensor_layout_detail
+
+// Converts a tensor (Tensor or TensorView) from src_layout to dst_layout, in parallel. vector_size
+// is the vector length of a vectorized dst_layout; a vectorized src_layout uses its own, which must
+// then be the same. Channels added to pad C to a multiple of vector_size are zero; converting
+// back from a vectorized layout keeps them, Slice() the result to drop them.
+template <typename SrcTensor>
+auto convert_conv_tensor_layout(const SrcTensor& src_tensor,
+                                ConvTensorLayout src_layout,
+                                ConvTensorLayout dst_layout,
+                                std::size_t vector_size = 1,
+                                std::size_t num_thread  = std::thread::hardware_concurrency())
+{
+    using namespace host_tensor_layout_detail;
+
+    const auto src = make_tensor_view(src_tensor);
+
+    using T = std::remove_const_t<typename decltype(src)::value_type>;
+
+    const auto& lens = src.mDesc.GetLengths();
+
+    if(lens.size() != (is_vectorized_conv_tensor_layout(src_layout) ? 5 : 4))
+        throw std::runtime_error("wrong! tensor doesn't match layout");
+
+    std::size_t n = 0, c = 0, h = 0, w = 0;
+
+    switch(src_layout)
+    {
+    case ConvTensorLayout::NCHW: n = lens[0], c = lens[1], h = lens[2], w = lens[3]; break;
+    case ConvTensorLayout::NHWC: n = lens[0], h = lens[1], w = lens[2], c = lens[3]; break;
+    case ConvTensorLayout::CHWN: c = lens[0], h = lens[1], w = lens[2], n = lens[3]; break;
+    case ConvTensorLayout::NCHWc:
+        n = lens[0], c = lens[1] * lens[4], h = lens[2], w = lens[3];
+        break;
+    case ConvTensorLayout::NHWCc:
+        n = lens[0], h = lens[1], w = lens[2], c = lens[3] * lens[4];
+        break;
+    case ConvTensorLayout::NCDHW:
+    case ConvTensorLayout::NDHWC: throw std::runtime_error("wrong! not a 2-D layout");
+    }
+
+    if(is_vectorized_conv_tensor_layout(src_layout))
+    {
+        if(is_vectorized_conv_tensor_layout(dst_layout) && vector_size != lens[4])
+            throw std::runtime_error("wrong! vector sizes of src and dst layouts differ");
+
+        vector_size = lens[4];
+    }
+
+    if(vector_size == 0)
+        throw std::runtime_error("wrong! vector_size is 0");
+
+    const bool pad = is_vectorized_conv_tensor_layout(dst_layout) && c % vector_size != 0;
+
+    const std::size_t dst_vector_size =
+        is_vectorized_conv_tensor_layout(dst_layout) ? vector_size : 1;
+
+    Tensor<T> dst(
+        HostTensorDescriptor(get_conv_tensor_lengths(dst_layout, n, c, h, w, dst_vector_size)),
+        pad ? HostTensorMemoryPolicy::GetDefault() : HostTensorMemoryPolicy::Uninitialized());
+
+    const auto dst_view = dst.View();
+
+    // whole vectors of channels, then the remaining channels of the last one
+    const std::size_t num_vector = c / vector_size;
+
+    if(num_vector > 0)
+    {
+        const std::array<std::size_t, 5> view_lens{n, num_vector, vector_size, h, w};
+
+        host_tensor_copy(
+            make_conv_tensor_view_n_c0_c1_h_w(src, src_layout, vector_size, 0, view_lens),
+            make_conv_tensor_view_n_c0_c1_h_w(dst_view, dst_layout, vector_size, 0, view_lens),
+            num_thread);
+    }
+
+    if(c % vector_size != 0)
+    {
+        const std::size_t c_begin = num_vector * vector_size;
+
+        const std::array<std::size_t, 5> view_lens{n, 1, c % vector_size, h, w};
+
+        host_tensor_copy(
+            make_conv_tensor_view_n_c0_c1_h_w(src, src_layout, vector_size, c_begin, view_lens),
+            make_conv_tensor_view_n_c0_c1_h_w(
+                dst_view, dst_layout, vector_size, c_begin, view_lens),
+            num_thread);
+    }
+
+    return dst;
+}
+
+#endif
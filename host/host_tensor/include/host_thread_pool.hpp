@@ -0,0 +1,118 @@
+#ifndef HOST_THREAD_POOL_HPP
+#define HOST_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+// Tasks submitted together and waited on together. Wait() rethrows the first exception thrown by
+// any task in the group.
+struct HostTaskGroup
+{
+    std::atomic<std::size_t> mNumPending{0};
+
+    std::mutex mMutex;
+    std::exception_ptr mpException;
+};
+
+// Process-wide persistent pool used by all host routines (ParallelTensorFunctor, host references,
+// tensor generation). Every worker owns a deque: it pushes and pops its own tasks at the back and
+// steals from the front of the other deques when idle. Threads outside the pool submit through an
+// extra shared deque, and any thread blocked in Wait() keeps executing queued tasks, so nested
+// parallel calls from inside a task cannot deadlock.
+struct HostThreadPool
+{
+    using Task = std::function<void()>;
+
+    // number of chunks per thread that parallel host routines split their work into, so that idle
+    // threads can steal from slow ones
+    static constexpr std::size_t ChunkPerThread = 4;
+
+    static HostThreadPool& GetInstance();
+
+    HostThreadPool(const HostThreadPool&) = delete;
+    HostThreadPool& operator=(const HostThreadPool&) = delete;
+
+    ~HostThreadPool();
+
+    // number of threads that can execute tasks concurrently, including the waiting caller
+    std::size_t GetNumThread() const { return mWorkers.size() + 1; }
+
+    void Submit(HostTaskGroup& group, Task task);
+
+    void Wait(HostTaskGroup& group);
+
+    // split [begin, end) into at most num_chunk contiguous chunks, call f(chunk_begin, chunk_end)
+    // on each of them, the first chunk on the calling thread
+    template <typename F>
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t num_chunk, F f)
+    {
+        if(end <= begin)
+            return;
+
+        const std::size_t n = end - begin;
+
+        num_chunk = std::max<std::size_t>(std::min(num_chunk, n), 1);
+
+        if(num_chunk == 1)
+        {
+            f(begin, end);
+            return;
+        }
+
+        const std::size_t work_per_chunk = (n + num_chunk - 1) / num_chunk;
+
+        HostTaskGroup group;
+
+        for(std::size_t ib = begin + work_per_chunk; ib < end; ib += work_per_chunk)
+        {
+            const std::size_t ie = std::min(ib + work_per_chunk, end);
+
+            Submit(group, [=, &f] { f(ib, ie); });
+        }
+
+        try
+        {
+            f(begin, std::min(begin + work_per_chunk, end));
+        }
+        catch(...)
+        {
+            Wait(group);
+            throw;
+        }
+
+        Wait(group);
+    }
+
+    private:
+    explicit HostThreadPool(std::size_t num_worker);
+
+    struct WorkQueue
+    {
+        std::mutex mMutex;
+        std::deque<Task> mTasks;
+    };
+
+    bool TryRunOneTask(std::size_t iqueue);
+
+    void WorkerLoop(std::size_t iworker);
+
+    // one queue per worker, plus one shared queue for threads outside the pool
+    std::vector<std::unique_ptr<WorkQueue>> mQueues;
+    std::vector<std::thread> mWorkers;
+
+    std::atomic<std::size_t> mNumQueued{0};
+
+    std::mutex mSleepMutex;
+    std::condition_variable mSleepCondition;
+    bool mStop = false;
+};
+
+#endif
@@ -1,5 +1,41 @@
 #include "device.hpp"
 
+#ifdef CK_CPU_TARGET
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+DeviceMem::DeviceMem(std::size_t mem_size) : mMemSize(mem_size)
+{
+    // aligned for the widest vector access of a kernel
+    mpDeviceBuf = std::aligned_alloc(64, (mMemSize + 63) / 64 * 64);
+
+    if(mpDeviceBuf == nullptr)
+        throw std::bad_alloc();
+}
+
+void* DeviceMem::GetDeviceBuffer() { return mpDeviceBuf; }
+
+void DeviceMem::ToDevice(const void* p) { std::memcpy(mpDeviceBuf, p, mMemSize); }
+
+void DeviceMem::FromDevice(void* p) { std::memcpy(p, mpDeviceBuf, mMemSize); }
+
+DeviceMem::~DeviceMem() { std::free(mpDeviceBuf); }
+
+struct KernelTimerImpl
+{
+    void Start() { mStart = std::chrono::steady_clock::now(); }
+
+    void End() { mEnd = std::chrono::steady_clock::now(); }
+
+    float GetElapsedTime() const
+    {
+        return std::chrono::duration<float, std::milli>(mEnd - mStart).count();
+    }
+
+    std::chrono::steady_clock::time_point mStart, mEnd;
+};
+#else
 DeviceMem::DeviceMem(std::size_t mem_size) : mMemSize(mem_size)
 {
     hipGetErrorString(hipMalloc(static_cast<void**>(&mpDeviceBuf), mMemSize));
@@ -55,6 +91,7 @@ struct KernelTimerImpl
 
     hipEvent_t mStart, mEnd;
 };
+#endif
 
 KernelTimer::KernelTimer() : impl(new KernelTimerImpl()) {}
 
@@ -7,33 +7,50 @@ void HostTensorDescriptor::CalculateStrides()
 {
     mStrides.clear();
     mStrides.resize(mLens.size(), 0);
-    if(mStrides.empty())
-        return;
 
-    mStrides.back() = 1;
-    std::partial_sum(
-        mLens.rbegin(), mLens.rend() - 1, mStrides.rbegin() + 1, std::multiplies<std::size_t>());
-}
+    if(!mStrides.empty())
+    {
+        mStrides.back() = 1;
+        std::partial_sum(mLens.rbegin(),
+                         mLens.rend() - 1,
+                         mStrides.rbegin() + 1,
+                         std::multiplies<std::size_t>());
+    }
 
-std::size_t HostTensorDescriptor::GetNumOfDimension() const { return mLens.size(); }
+    this->UpdateCache();
+}
 
-std::size_t HostTensorDescriptor::GetElementSize() const
+void HostTensorDescriptor::UpdateCache()
 {
-    assert(mLens.size() == mStrides.size());
-    return std::accumulate(
+    if(mLens.size() != mStrides.size())
+        throw std::runtime_error("wrong! lengths and strides mismatch");
+
+    mElementSize = std::accumulate(
         mLens.begin(), mLens.end(), std::size_t{1}, std::multiplies<std::size_t>());
+
+    mIsPacked = true;
+
+    std::size_t stride = 1;
+
+    for(std::size_t i = mLens.size(); i-- > 0;)
+    {
+        // the stride of a dimension of length 1 is never used
+        if(mLens[i] != 1 && mStrides[i] != stride)
+            mIsPacked = false;
+
+        stride *= mLens[i];
+    }
 }
 
 std::size_t HostTensorDescriptor::GetElementSpace() const
 {
+    if(mElementSize == 0)
+        return 0;
+
     auto ls = mLens | boost::adaptors::transformed([](std::size_t v) { return v - 1; });
     return std::inner_product(ls.begin(), ls.end(), mStrides.begin(), std::size_t{0}) + 1;
 }
 
-const std::vector<std::size_t>& HostTensorDescriptor::GetLengths() const { return mLens; }
-
-const std::vector<std::size_t>& HostTensorDescriptor::GetStrides() const { return mStrides; }
-
 void ostream_HostTensorDescriptor(const HostTensorDescriptor& desc, std::ostream& os)
 {
     os << "dim " << desc.GetNumOfDimension() << ", ";
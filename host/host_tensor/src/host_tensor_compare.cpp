@@ -0,0 +1,51 @@
+#include <iostream>
+
+#include "host_tensor_compare.hpp"
+
+void ostream_HostTensorCompareResult(const HostTensorCompareResult& res, std::ostream& os)
+{
+    auto print_index = [&](const std::vector<std::size_t>& index) {
+        os << "{";
+        LogRange(os, index, ", ");
+        os << "}";
+    };
+
+    os << "error: " << res.mSumAbsDiff << std::endl;
+    os << "max_diff: " << res.mMaxAbsDiff << ", " << res.mRefAtMax << ", " << res.mResultAtMax;
+
+    if(!res.mIndexAtMax.empty())
+    {
+        os << " at ";
+        print_index(res.mIndexAtMax);
+    }
+
+    os << std::endl;
+
+    if(res.mNumMismatch > 0)
+    {
+        os << "mismatch: " << res.mNumMismatch << " / " << res.mNumChecked << " checked, "
+           << res.mNumElement << " total" << std::endl;
+
+        for(const auto& m : res.mMismatches)
+        {
+            os << "    ";
+            print_index(m.mIndex);
+            os << ": " << m.mRef << " vs " << m.mResult << std::endl;
+        }
+
+        os << "|diff| histogram: 0: " << res.mHistogram[0];
+
+        for(std::size_t b = 1; b + 1 < HostTensorCompareResult::NumBin; ++b)
+        {
+            if(res.mHistogram[b] > 0)
+                os << ", <=1e" << static_cast<int>(b) - 11 << ": " << res.mHistogram[b];
+        }
+
+        if(res.mHistogram.back() > 0)
+            os << ", >10 or nan: " << res.mHistogram.back();
+
+        os << std::endl;
+    }
+
+    os << (res.mPass ? "PASS" : "FAIL") << std::endl;
+}
@@ -0,0 +1,142 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "host_tensor_file.hpp"
+
+void save_host_tensor_file(const std::string& path,
+                           ck::DataTypeEnum_t data_type,
+                           std::size_t element_bytes,
+                           const std::vector<std::size_t>& lens,
+                           const std::vector<std::size_t>& strides,
+                           const void* p_data,
+                           std::size_t data_bytes)
+{
+    if(lens.size() != strides.size())
+        throw std::runtime_error("wrong! lengths and strides mismatch");
+
+    HostTensorFileHeader header;
+
+    std::memcpy(header.mMagic, HostTensorFileHeader::Magic, sizeof(header.mMagic));
+    header.mVersion      = HostTensorFileHeader::Version;
+    header.mDataType     = static_cast<std::uint32_t>(data_type);
+    header.mElementBytes = element_bytes;
+    header.mNumDim       = lens.size();
+    header.mDataBytes    = data_bytes;
+
+    std::vector<std::uint64_t> dims(lens.begin(), lens.end());
+    dims.insert(dims.end(), strides.begin(), strides.end());
+
+    const std::uint64_t meta_bytes = sizeof(header) + dims.size() * sizeof(std::uint64_t);
+
+    header.mDataOffset = (meta_bytes + HostTensorFileHeader::DataAlignment - 1) /
+                         HostTensorFileHeader::DataAlignment * HostTensorFileHeader::DataAlignment;
+
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+
+    if(!os)
+        throw std::runtime_error("wrong! cannot open " + path + " for writing");
+
+    const std::vector<char> padding(header.mDataOffset - meta_bytes, 0);
+
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(dims.data()), dims.size() * sizeof(std::uint64_t));
+    os.write(padding.data(), padding.size());
+    os.write(static_cast<const char*>(p_data), data_bytes);
+
+    if(!os)
+        throw std::runtime_error("wrong! failed writing " + path);
+}
+
+HostTensorFileMapping map_host_tensor_file(const std::string& path,
+                                           ck::DataTypeEnum_t data_type,
+                                           std::size_t element_bytes)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+
+    if(fd < 0)
+        throw std::runtime_error("wrong! cannot open " + path);
+
+    struct stat st;
+
+    if(fstat(fd, &st) != 0)
+    {
+        close(fd);
+        throw std::runtime_error("wrong! cannot stat " + path);
+    }
+
+    const std::size_t file_bytes = st.st_size;
+
+    if(file_bytes < sizeof(HostTensorFileHeader))
+    {
+        close(fd);
+        throw std::runtime_error("wrong! " + path + " is not a tensor file");
+    }
+
+    // pages are brought in lazily on first access
+    void* p_base = mmap(nullptr, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+
+    if(p_base == MAP_FAILED)
+        throw std::runtime_error("wrong! cannot mmap " + path);
+
+    std::shared_ptr<const void> p_storage(
+        p_base, [file_bytes](const void* p) { munmap(const_cast<void*>(p), file_bytes); });
+
+    const auto* p_bytes = static_cast<const char*>(p_base);
+
+    HostTensorFileHeader header;
+
+    std::memcpy(&header, p_bytes, sizeof(header));
+
+    if(std::memcmp(header.mMagic, HostTensorFileHeader::Magic, sizeof(header.mMagic)) != 0 ||
+       header.mVersion != HostTensorFileHeader::Version)
+        throw std::runtime_error("wrong! " + path + " is not a tensor file");
+
+    if(header.mDataType != static_cast<std::uint32_t>(data_type) ||
+       header.mElementBytes != element_bytes)
+        throw std::runtime_error("wrong! data type of " + path + " doesn't match");
+
+    const std::size_t meta_bytes = sizeof(header) + 2 * header.mNumDim * sizeof(std::uint64_t);
+
+    if(meta_bytes > header.mDataOffset || header.mDataOffset > file_bytes ||
+       header.mDataBytes > file_bytes - header.mDataOffset)
+        throw std::runtime_error("wrong! " + path + " is truncated");
+
+    std::vector<std::uint64_t> dims(2 * header.mNumDim);
+
+    std::memcpy(dims.data(), p_bytes + sizeof(header), dims.size() * sizeof(std::uint64_t));
+
+    HostTensorFileMapping mapping;
+
+    mapping.mDataType = data_type;
+    mapping.mLens.assign(dims.begin(), dims.begin() + header.mNumDim);
+    mapping.mStrides.assign(dims.begin() + header.mNumDim, dims.end());
+    mapping.mpData     = p_bytes + header.mDataOffset;
+    mapping.mDataBytes = header.mDataBytes;
+    mapping.mpStorage  = std::move(p_storage);
+
+    // the element space described by lengths and strides must fit in the stored data
+    std::size_t space = 1;
+
+    for(std::size_t i = 0; i < header.mNumDim; ++i)
+    {
+        if(mapping.mLens[i] == 0)
+        {
+            space = 0;
+            break;
+        }
+
+        space += (mapping.mLens[i] - 1) * mapping.mStrides[i];
+    }
+
+    if(space * element_bytes > header.mDataBytes)
+        throw std::runtime_error("wrong! " + path + " is truncated");
+
+    return mapping;
+}
@@ -0,0 +1,169 @@
+#include <cstdlib>
+#include <string>
+
+#include "host_thread_pool.hpp"
+
+namespace {
+
+// index of the queue owned by the current thread; threads outside the pool use the shared queue
+thread_local std::size_t tls_queue_id = static_cast<std::size_t>(-1);
+
+std::size_t get_default_num_worker()
+{
+    // CK_HOST_NUM_THREAD overrides the total number of host threads, including the caller
+    std::size_t num_thread = std::thread::hardware_concurrency();
+
+    if(const char* env = std::getenv("CK_HOST_NUM_THREAD"))
+    {
+        num_thread = std::stoul(env);
+    }
+
+    return std::max<std::size_t>(num_thread, 1) - 1;
+}
+
+} // namespace
+
+HostThreadPool& HostThreadPool::GetInstance()
+{
+    static HostThreadPool pool(get_default_num_worker());
+
+    return pool;
+}
+
+HostThreadPool::HostThreadPool(std::size_t num_worker)
+{
+    for(std::size_t i = 0; i < num_worker + 1; ++i)
+    {
+        mQueues.emplace_back(std::make_unique<WorkQueue>());
+    }
+
+    for(std::size_t i = 0; i < num_worker; ++i)
+    {
+        mWorkers.emplace_back([this, i] { WorkerLoop(i); });
+    }
+}
+
+HostThreadPool::~HostThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mStop = true;
+    }
+
+    mSleepCondition.notify_all();
+
+    for(auto& worker : mWorkers)
+    {
+        worker.join();
+    }
+}
+
+void HostThreadPool::Submit(HostTaskGroup& group, Task task)
+{
+    group.mNumPending.fetch_add(1, std::memory_order_relaxed);
+
+    auto wrapped = [&group, task = std::move(task)] {
+        try
+        {
+            task();
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(group.mMutex);
+
+            if(!group.mpException)
+                group.mpException = std::current_exception();
+        }
+
+        group.mNumPending.fetch_sub(1, std::memory_order_acq_rel);
+    };
+
+    const std::size_t iqueue = tls_queue_id < mWorkers.size() ? tls_queue_id : mWorkers.size();
+
+    {
+        std::lock_guard<std::mutex> lock(mQueues[iqueue]->mMutex);
+        mQueues[iqueue]->mTasks.emplace_back(std::move(wrapped));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mNumQueued.fetch_add(1, std::memory_order_release);
+    }
+
+    mSleepCondition.notify_one();
+}
+
+void HostThreadPool::Wait(HostTaskGroup& group)
+{
+    const std::size_t iqueue = tls_queue_id < mWorkers.size() ? tls_queue_id : mWorkers.size();
+
+    while(group.mNumPending.load(std::memory_order_acquire) > 0)
+    {
+        // help instead of blocking, this is what makes nested parallel calls safe
+        if(!TryRunOneTask(iqueue))
+            std::this_thread::yield();
+    }
+
+    if(group.mpException)
+        std::rethrow_exception(group.mpException);
+}
+
+bool HostThreadPool::TryRunOneTask(std::size_t iqueue)
+{
+    Task task;
+
+    // own queue: LIFO, keeps the most recently split (cache-hot) work local
+    {
+        auto& queue = *mQueues[iqueue];
+
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+
+        if(!queue.mTasks.empty())
+        {
+            task = std::move(queue.mTasks.back());
+            queue.mTasks.pop_back();
+        }
+    }
+
+    // steal: FIFO from the other queues, takes the oldest (largest remaining) work
+    for(std::size_t i = 1; !task && i < mQueues.size(); ++i)
+    {
+        auto& queue = *mQueues[(iqueue + i) % mQueues.size()];
+
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+
+        if(!queue.mTasks.empty())
+        {
+            task = std::move(queue.mTasks.front());
+            queue.mTasks.pop_front();
+        }
+    }
+
+    if(!task)
+        return false;
+
+    mNumQueued.fetch_sub(1, std::memory_order_relaxed);
+
+    task();
+
+    return true;
+}
+
+void HostThreadPool::WorkerLoop(std::size_t iworker)
+{
+    tls_queue_id = iworker;
+
+    while(true)
+    {
+        if(TryRunOneTask(iworker))
+            continue;
+
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+
+        mSleepCondition.wait(
+            lock, [&] { return mStop || mNumQueued.load(std::memory_order_acquire) > 0; });
+
+        if(mStop && mNumQueued.load(std::memory_order_acquire) == 0)
+            return;
+    }
+}
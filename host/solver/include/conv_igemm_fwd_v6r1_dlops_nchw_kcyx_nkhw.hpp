@@ -243,7 +243,7 @@ struct ConvIgemmFwdV6r1DlopsNchwKcyxNkhw
     CalculateCompileParameterBasedOnTunable(const ConvolutionProblemDescriptor& conv_problem_desc,
                                             const TunableConvIgemmFwdV6r1DlopsNchwKcyxNkhw& tunable)
     {
-        const int C  = conv_problem_desc.C;
+        const int C  = conv_problem_desc.C / conv_problem_desc.G;
         const int Y  = conv_problem_desc.Y;
         const int X  = conv_problem_desc.X;
         const int Ho = conv_problem_desc.Ho;
@@ -385,9 +385,16 @@ struct ConvIgemmFwdV6r1DlopsNchwKcyxNkhw
     IsValidCompileParameter(const ConvolutionProblemDescriptor& conv_problem_desc,
                             const CompileParameterConvIgemmFwdV6r1DlopsNchwKcyxNkhw& compile_param)
     {
+        const int G = conv_problem_desc.G;
+
+        if(!(conv_problem_desc.C % G == 0 && conv_problem_desc.K % G == 0))
+            return false;
+
+        // one contraction per group, see
+        // transform_forward_convolution_into_contraction_v6r1_nchw_kcyx_nkhw_grouped_pad
         const int N  = conv_problem_desc.N;
-        const int K  = conv_problem_desc.K;
-        const int C  = conv_problem_desc.C;
+        const int K  = conv_problem_desc.K / G;
+        const int C  = conv_problem_desc.C / G;
         const int Y  = conv_problem_desc.Y;
         const int X  = conv_problem_desc.X;
         const int Ho = conv_problem_desc.Ho;
@@ -646,11 +653,12 @@ struct ConvIgemmFwdV6r1DlopsNchwKcyxNkhw
         return compile_param.BlockSize;
     }
 
+    // grid of the contraction of one group
     static int GetGridSize(const ConvolutionProblemDescriptor& conv_problem_desc,
                            const CompileParameterConvIgemmFwdV6r1DlopsNchwKcyxNkhw& compile_param)
     {
         const int N  = conv_problem_desc.N;
-        const int K  = conv_problem_desc.K;
+        const int K  = conv_problem_desc.K / conv_problem_desc.G;
         const int Ho = conv_problem_desc.Ho;
         const int Wo = conv_problem_desc.Wo;
 
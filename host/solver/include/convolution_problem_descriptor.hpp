@@ -27,7 +27,8 @@ struct ConvolutionProblemDescriptor
                                  int InRightPadW_,
                                  ck::DataTypeEnum_t InDataTypeEnum_,
                                  ck::DataTypeEnum_t WeiDataTypeEnum_,
-                                 ck::DataTypeEnum_t OutDataTypeEnum_)
+                                 ck::DataTypeEnum_t OutDataTypeEnum_,
+                                 int G_ = 1)
         : N{N_},
           K{K_},
           C{C_},
@@ -47,7 +48,8 @@ struct ConvolutionProblemDescriptor
           InRightPadW{InRightPadW_},
           InDataTypeEnum{InDataTypeEnum_},
           WeiDataTypeEnum{WeiDataTypeEnum_},
-          OutDataTypeEnum{OutDataTypeEnum_}
+          OutDataTypeEnum{OutDataTypeEnum_},
+          G{G_}
     {
     }
 
@@ -73,7 +75,110 @@ struct ConvolutionProblemDescriptor
     ck::DataTypeEnum_t WeiDataTypeEnum;
     ck::DataTypeEnum_t OutDataTypeEnum;
 
-    std::size_t CalculateFlop() const { return 2L * N * K * C * Y * X * Ho * Wo; }
+    // number of groups, C and K count all groups and the weight is K x (C / G) x Y x X
+    int G = 1;
+
+    std::size_t CalculateFlop() const { return 2L * N * K * (C / G) * Y * X * Ho * Wo; }
+};
+
+// 3-D (NCDHW / NDHWC) counterpart of ConvolutionProblemDescriptor, with a depth dimension D
+// for the activations and Z for the filter
+struct Convolution3dProblemDescriptor
+{
+    Convolution3dProblemDescriptor() = default;
+
+    Convolution3dProblemDescriptor(int N_,
+                                   int K_,
+                                   int C_,
+                                   int Z_,
+                                   int Y_,
+                                   int X_,
+                                   int Di_,
+                                   int Hi_,
+                                   int Wi_,
+                                   int Do_,
+                                   int Ho_,
+                                   int Wo_,
+                                   int ConvStrideD_,
+                                   int ConvStrideH_,
+                                   int ConvStrideW_,
+                                   int ConvDilationD_,
+                                   int ConvDilationH_,
+                                   int ConvDilationW_,
+                                   int InLeftPadD_,
+                                   int InLeftPadH_,
+                                   int InLeftPadW_,
+                                   int InRightPadD_,
+                                   int InRightPadH_,
+                                   int InRightPadW_,
+                                   ck::DataTypeEnum_t InDataTypeEnum_,
+                                   ck::DataTypeEnum_t WeiDataTypeEnum_,
+                                   ck::DataTypeEnum_t OutDataTypeEnum_,
+                                   int G_ = 1)
+        : N{N_},
+          K{K_},
+          C{C_},
+          Z{Z_},
+          Y{Y_},
+          X{X_},
+          Di{Di_},
+          Hi{Hi_},
+          Wi{Wi_},
+          Do{Do_},
+          Ho{Ho_},
+          Wo{Wo_},
+          ConvStrideD{ConvStrideD_},
+          ConvStrideH{ConvStrideH_},
+          ConvStrideW{ConvStrideW_},
+          ConvDilationD{ConvDilationD_},
+          ConvDilationH{ConvDilationH_},
+          ConvDilationW{ConvDilationW_},
+          InLeftPadD{InLeftPadD_},
+          InLeftPadH{InLeftPadH_},
+          InLeftPadW{InLeftPadW_},
+          InRightPadD{InRightPadD_},
+          InRightPadH{InRightPadH_},
+          InRightPadW{InRightPadW_},
+          InDataTypeEnum{InDataTypeEnum_},
+          WeiDataTypeEnum{WeiDataTypeEnum_},
+          OutDataTypeEnum{OutDataTypeEnum_},
+          G{G_}
+    {
+    }
+
+    int N;
+    int K;
+    int C;
+    int Z;
+    int Y;
+    int X;
+    int Di;
+    int Hi;
+    int Wi;
+    int Do;
+    int Ho;
+    int Wo;
+    int ConvStrideD;
+    int ConvStrideH;
+    int ConvStrideW;
+    int ConvDilationD;
+    int ConvDilationH;
+    int ConvDilationW;
+    int InLeftPadD;
+    int InLeftPadH;
+    int InLeftPadW;
+    int InRightPadD;
+    int InRightPadH;
+    int InRightPadW;
+
+    ck::DataTypeEnum_t InDataTypeEnum;
+    ck::DataTypeEnum_t WeiDataTypeEnum;
+    ck::DataTypeEnum_t OutDataTypeEnum;
+
+    // number of groups, C and K count all groups and the weight is K x (C / G) x Z x Y x X
+    int G = 1;
+
+    std::size_t CalculateFlop() const { return 2L * N * K * (C / G) * Z * Y * X * Do * Ho * Wo; }
 };
 
 } // namespace driver